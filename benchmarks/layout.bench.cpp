@@ -0,0 +1,116 @@
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include <maze/cell.hpp>
+#include <maze/direction.hpp>
+#include <maze/distance.hpp>
+#include <maze/generate_ellers.hpp>
+#include <maze/layout.hpp>
+#include <maze/maze.hpp>
+#include <maze/point.hpp>
+#include <maze/utility.hpp>
+
+// Compares next_point driven traversal over each Maze Layout. Build with
+// optimizations, ex. -DCMAKE_BUILD_TYPE=Release.
+
+namespace {
+
+constexpr auto width  = maze::Distance{4097};
+constexpr auto height = maze::Distance{4097};
+
+/// Depth first walk over every Passage reachable from {0, 0}.
+/** Mazes are trees, so skipping the entry direction avoids revisits. */
+template <typename Maze_t>
+auto traverse(Maze_t const& m) -> std::size_t
+{
+    struct Step {
+        maze::Point at;
+        maze::Direction entry;
+    };
+    auto stack = std::vector<Step>{};
+    stack.push_back({{0, 0}, maze::Direction::North});
+    auto visited = std::size_t{0};
+    while (!stack.empty()) {
+        auto const [at, entry] = stack.back();
+        stack.pop_back();
+        ++visited;
+        for (auto const direction : maze::utility::directions) {
+            if (direction == entry)
+                continue;
+            auto const next =
+                maze::utility::next_point<width, height>(at, direction);
+            if (next.has_value() && m.get(*next) == maze::Cell::Passage)
+                stack.push_back({*next, maze::utility::opposite(direction)});
+        }
+    }
+    return visited;
+}
+
+template <typename Layout>
+auto copy_as(maze::Maze<width, height> const& source)
+    -> std::unique_ptr<maze::Maze<width, height, Layout>>
+{
+    auto result =
+        std::make_unique<maze::Maze<width, height, Layout>>(maze::Cell::Wall);
+    for (maze::Distance y = 0; y < height; ++y) {
+        for (maze::Distance x = 0; x < width; ++x)
+            result->set({x, y}, source.get({x, y}));
+    }
+    return result;
+}
+
+/// Return the best of several traversal times in nanoseconds per cell.
+template <typename Maze_t>
+auto time_traversal(Maze_t const& m, std::size_t& visited) -> double
+{
+    using Clock = std::chrono::steady_clock;
+    auto best   = std::chrono::nanoseconds::max();
+    for (auto i = 0; i < 5; ++i) {
+        auto const start = Clock::now();
+        visited          = traverse(m);
+        best             = std::min(best, std::chrono::duration_cast<
+                                      std::chrono::nanoseconds>(
+                                      Clock::now() - start));
+    }
+    return static_cast<double>(best.count()) / static_cast<double>(visited);
+}
+
+/// Time a traversal of \p source copied into Layout, print it and return the
+/// nanoseconds per cell. Speedup is relative to \p baseline ns per cell.
+template <typename Layout>
+auto report(std::string_view name,
+            maze::Maze<width, height> const& source,
+            double baseline) -> double
+{
+    auto const m      = copy_as<Layout>(source);
+    auto visited      = std::size_t{0};
+    auto const ns     = time_traversal(*m, visited);
+    auto const kbytes = maze::Maze<width, height, Layout>::word_count *
+                        sizeof(maze::Word) / 1024;
+    std::cout << std::left << std::setw(12) << name << std::right
+              << std::setw(10) << kbytes << " KiB" << std::setw(10)
+              << std::fixed << std::setprecision(2) << ns << " ns/cell"
+              << std::setw(8) << ((baseline == 0 ? ns : baseline) / ns)
+              << "x  (" << visited << " cells)\n";
+    return ns;
+}
+
+}  // namespace
+
+int main()
+{
+    auto const source = std::make_unique<maze::Maze<width, height>>(
+        maze::Cell::Wall);
+    maze::generate_ellers_into(*source);
+
+    std::cout << "Depth first traversal of a " << width << 'x' << height
+              << " maze\n";
+    auto const baseline = report<maze::Row_major>("Row_major", *source, 0);
+    report<maze::Tiled_8x8>("Tiled_8x8", *source, baseline);
+    report<maze::Morton>("Morton", *source, baseline);
+}
@@ -0,0 +1,317 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include <maze/analytics.hpp>
+#include <maze/cell.hpp>
+#include <maze/display.hpp>
+#include <maze/distance.hpp>
+#include <maze/generator_pool.hpp>
+#include <maze/graph/adjacency_list.hpp>
+#include <maze/graph/connected_components.hpp>
+#include <maze/longest_path.hpp>
+#include <maze/maze.hpp>
+#include <maze/point.hpp>
+#include <maze/serialize.hpp>
+#include <maze/utility.hpp>
+#include <maze/verify.hpp>
+
+// Times every generator, solver and renderer over a range of maze sizes with
+// fixed seeds. Prints a table, or JSON with --json, for tracking regressions.
+// Every generated maze is checked with verify_perfect, exits 1 if one fails.
+// Build with optimizations, ex. -DCMAKE_BUILD_TYPE=Release.
+
+namespace {
+
+std::atomic<std::size_t> allocation_count = 0;
+std::atomic<std::size_t> allocated_bytes  = 0;
+
+}  // namespace
+
+auto operator new(std::size_t size) -> void*
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (auto* const p = std::malloc(size == 0 ? 1 : size))
+        return p;
+    throw std::bad_alloc{};
+}
+
+// GCC can't see that these free what the operator new above malloc'ed.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace {
+
+constexpr auto seed = std::uint64_t{1};
+
+// Quadratic operations only run up to these cell counts.
+constexpr auto connected_components_max_cells = std::size_t{101 * 101};
+constexpr auto solution_display_max_cells     = std::size_t{201 * 201};
+constexpr auto aldous_broder_max_cells        = std::size_t{501 * 501};
+
+// Each case repeats until it has run this long, keeping the best time.
+constexpr auto min_case_time  = std::chrono::milliseconds{100};
+constexpr auto max_iterations = 1000;
+
+constexpr auto generators = std::array{
+    std::pair{maze::Generator_id::Recursive_backtracking,
+              "recursive_backtracking"},
+    std::pair{maze::Generator_id::Kruskal, "kruskal"},
+    std::pair{maze::Generator_id::Prims, "prims"},
+    std::pair{maze::Generator_id::Aldous_broder, "aldous_broder"},
+    std::pair{maze::Generator_id::Recursive_division, "recursive_division"},
+    std::pair{maze::Generator_id::Ellers, "ellers"},
+    std::pair{maze::Generator_id::Binary_tree, "binary_tree"},
+    std::pair{maze::Generator_id::Sidewinder, "sidewinder"},
+    std::pair{maze::Generator_id::Hunt_and_kill, "hunt_and_kill"},
+};
+
+struct Result {
+    std::string operation;
+    std::string variant;
+    maze::Distance width;
+    maze::Distance height;
+    int iterations;
+    double ns_per_cell;
+    std::size_t allocations;  // Per call.
+    std::size_t bytes;        // Per call.
+    long peak_rss_kib;
+};
+
+/// Keeps results alive so the optimizer can't drop the timed work.
+volatile std::size_t sink = 0;
+
+/// Set when a generator produced a maze that is not perfect.
+bool verification_failed = false;
+
+/// Reset the kernel's peak RSS counter, where supported (Linux 4.0+).
+void reset_peak_rss()
+{
+    auto clear_refs = std::ofstream{"/proc/self/clear_refs"};
+    clear_refs << "5";
+}
+
+[[nodiscard]] auto peak_rss_kib() -> long
+{
+    auto usage = rusage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+/// Time \p fn, which works on a Width x Height maze.
+template <maze::Distance Width, maze::Distance Height, typename Fn>
+auto measure(std::string_view operation, std::string_view variant, Fn&& fn)
+    -> Result
+{
+    using Clock = std::chrono::steady_clock;
+    reset_peak_rss();
+    fn();  // Warm up, workspaces grow to fit.
+
+    auto best       = Clock::duration::max();
+    auto total      = Clock::duration::zero();
+    auto iterations = 0;
+    auto calls      = std::size_t{0};
+    auto bytes      = std::size_t{0};
+    while (total < min_case_time && iterations < max_iterations) {
+        auto const count_before = allocation_count.load();
+        auto const bytes_before = allocated_bytes.load();
+        auto const start        = Clock::now();
+        fn();
+        auto const elapsed = Clock::now() - start;
+        calls              = allocation_count.load() - count_before;
+        bytes              = allocated_bytes.load() - bytes_before;
+        best               = std::min(best, elapsed);
+        total += elapsed;
+        ++iterations;
+    }
+    auto const ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(best).count();
+    return {std::string{operation},
+            std::string{variant},
+            Width,
+            Height,
+            iterations,
+            static_cast<double>(ns) / (double{Width} * Height),
+            calls,
+            bytes,
+            peak_rss_kib()};
+}
+
+template <maze::Distance Width, maze::Distance Height>
+void bench_size(std::vector<Result>& results)
+{
+    using Maze_t         = maze::Maze<Width, Height>;
+    constexpr auto cells = std::size_t{Width} * Height;
+    auto const m         = std::make_unique<Maze_t>(maze::Cell::Wall);
+    auto workspace       = maze::Generator_workspace{};
+    auto verify_ws       = maze::Verify_workspace{};
+
+    for (auto const& [id, name] : generators) {
+        if (id == maze::Generator_id::Aldous_broder &&
+            cells > aldous_broder_max_cells)
+            continue;
+        results.push_back(measure<Width, Height>("generate", name, [&] {
+            auto gen = std::mt19937_64{seed};
+            maze::generate_into(id, *m, workspace, gen);
+        }));
+        if (auto const v = maze::verify_perfect(*m, verify_ws); !v) {
+            std::cerr << name << ' ' << Width << 'x' << Height << ": "
+                      << maze::to_string(v.defect) << " at {" << v.at.x
+                      << ", " << v.at.y << "}\n";
+            verification_failed = true;
+        }
+    }
+
+    // Solvers and renderers share one recursive backtracking maze.
+    auto gen = std::mt19937_64{seed};
+    maze::generate_into(maze::Generator_id::Recursive_backtracking, *m,
+                        workspace, gen);
+
+    results.push_back(measure<Width, Height>("verify_perfect", "", [&] {
+        sink = maze::verify_perfect(*m, verify_ws).edges;
+    }));
+
+    auto analytics_ws = maze::Analytics_workspace{};
+    results.push_back(measure<Width, Height>("analyze", "", [&] {
+        sink = maze::analyze(*m, analytics_ws).diameter;
+    }));
+
+    results.push_back(measure<Width, Height>("find_all_leaves", "", [&] {
+        sink = maze::find_all_leaves(*m).size();
+    }));
+
+    results.push_back(measure<Width, Height>("longest_path", "", [&] {
+        sink = maze::longest_path(*m).size();
+    }));
+
+    if (cells <= connected_components_max_cells) {
+        auto graph = maze::graph::Adjacency_list<maze::Point>{};
+        for (maze::Distance y = 0; y < Height; ++y) {
+            for (maze::Distance x = 0; x < Width; ++x) {
+                auto const at = maze::Point{x, y};
+                if (m->get(at) != maze::Cell::Passage)
+                    continue;
+                graph.add_vertex(at);
+                for (auto const d : {maze::Direction::West,
+                                     maze::Direction::North}) {
+                    auto const next = maze::utility::next_passage(*m, at, d);
+                    if (next.has_value())
+                        maze::graph::add_undirected_edge(graph, at, *next);
+                }
+            }
+        }
+        results.push_back(
+            measure<Width, Height>("connected_components", "", [&] {
+                auto const components = connected_components(graph);
+                sink = static_cast<std::size_t>(
+                    std::distance(components.begin(), components.end()));
+            }));
+    }
+
+    results.push_back(measure<Width, Height>("display", "maze", [&] {
+        auto os = std::ostringstream{};
+        os << *m;
+        sink = os.view().size();
+    }));
+
+    if (cells <= solution_display_max_cells) {
+        auto const solved = std::pair{*m, maze::longest_path(*m)};
+        results.push_back(measure<Width, Height>("display", "solution", [&] {
+            auto os = std::ostringstream{};
+            os << solved;
+            sink = os.view().size();
+        }));
+    }
+}
+
+void print_table(std::vector<Result> const& results)
+{
+    std::cout << std::left << std::setw(22) << "operation" << std::setw(24)
+              << "variant" << std::setw(12) << "size" << std::right
+              << std::setw(12) << "ns/cell" << std::setw(10) << "allocs"
+              << std::setw(14) << "alloc bytes" << std::setw(14)
+              << "peak RSS KiB" << '\n';
+    for (auto const& r : results) {
+        auto const size =
+            std::to_string(r.width) + 'x' + std::to_string(r.height);
+        std::cout << std::left << std::setw(22) << r.operation
+                  << std::setw(24) << r.variant << std::setw(12) << size
+                  << std::right << std::setw(12) << std::fixed
+                  << std::setprecision(3) << r.ns_per_cell << std::setw(10)
+                  << r.allocations << std::setw(14) << r.bytes
+                  << std::setw(14) << r.peak_rss_kib << '\n';
+    }
+}
+
+void print_json(std::vector<Result> const& results)
+{
+    std::cout << "{\n  \"benchmark\": \"maze-bench\",\n  \"seed\": " << seed
+              << ",\n  \"results\": [";
+    auto first = true;
+    for (auto const& r : results) {
+        std::cout << (first ? "\n" : ",\n") << "    {\"operation\": \""
+                  << r.operation << "\", \"variant\": \"" << r.variant
+                  << "\", \"width\": " << r.width
+                  << ", \"height\": " << r.height
+                  << ", \"iterations\": " << r.iterations
+                  << ", \"ns_per_cell\": " << std::fixed
+                  << std::setprecision(4) << r.ns_per_cell
+                  << ", \"allocations\": " << r.allocations
+                  << ", \"allocated_bytes\": " << r.bytes
+                  << ", \"peak_rss_kib\": " << r.peak_rss_kib << '}';
+        first = false;
+    }
+    std::cout << "\n  ]\n}\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    auto const json = argc > 1 && std::string_view{argv[1]} == "--json";
+    if (argc > 2 || (argc == 2 && !json)) {
+        std::cerr << "usage: maze-bench [--json]\n";
+        return 1;
+    }
+
+    auto results = std::vector<Result>{};
+    bench_size<41, 21>(results);
+    bench_size<101, 101>(results);
+    bench_size<201, 201>(results);
+    bench_size<1001, 1001>(results);
+    bench_size<2001, 2001>(results);
+
+    if (json)
+        print_json(results);
+    else
+        print_table(results);
+    return verification_failed ? 1 : 0;
+}
@@ -0,0 +1,442 @@
+#ifndef MAZE_ANALYTICS_HPP
+#define MAZE_ANALYTICS_HPP
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <memory_resource>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <maze/cell.hpp>
+#include <maze/cell_grid.hpp>
+#include <maze/direction.hpp>
+#include <maze/distance.hpp>
+#include <maze/generator_pool.hpp>
+#include <maze/layout.hpp>
+#include <maze/maze.hpp>
+#include <maze/point.hpp>
+#include <maze/storage.hpp>
+#include <maze/utility.hpp>
+#include <maze/verify.hpp>
+
+namespace maze {
+
+/// Number of corridor length buckets in Maze_metrics.
+inline constexpr auto corridor_buckets = std::size_t{16};
+
+/// Difficulty metrics of a Maze, from analyze().
+/** A corridor is the path between two Passages that do not have exactly two
+ *  Passage neighbors, running only through Passages that do. Its length is
+ *  the steps between its ends. Rooms are the Passages at even x and even
+ *  y. */
+struct Maze_metrics {
+    /// Passage cells.
+    std::uint32_t passages = 0;
+    /// Passages by number of Passage neighbors, 0 to 4.
+    std::array<std::uint32_t, 5> degrees = {};
+    /// Rooms, and those with exactly two Passage neighbors.
+    std::uint32_t rooms          = 0;
+    std::uint32_t corridor_rooms = 0;
+    /// Number of corridors.
+    std::uint32_t corridors = 0;
+    /// Corridors by length, bucket k holds lengths in [2^k, 2^(k+1)), the
+    /// last bucket everything longer.
+    std::array<std::uint32_t, corridor_buckets> corridor_lengths = {};
+    /// Sum and maximum of the corridor lengths.
+    std::uint64_t corridor_steps    = 0;
+    std::uint32_t longest_corridor = 0;
+    /// Cells on the longest path, as longest_path(m).size() for a perfect
+    /// Maze of two or more rooms. Exact only for perfect Mazes, and only the
+    /// component of the first dead end or junction is searched, 0 if none.
+    std::uint32_t diameter = 0;
+
+    /// Return the number of dead ends, Passages with one Passage neighbor.
+    [[nodiscard]] constexpr auto dead_ends() const -> std::uint32_t
+    {
+        return degrees[1];
+    }
+
+    /// Return the number of junctions, Passages with three or more.
+    [[nodiscard]] constexpr auto junctions() const -> std::uint32_t
+    {
+        return degrees[3] + degrees[4];
+    }
+
+    /// Return the share of rooms that only continue a corridor, in [0, 1].
+    /** High for "river" mazes of long winding corridors with few branches,
+     *  low for mazes of many short dead ends. */
+    [[nodiscard]] constexpr auto river() const -> double
+    {
+        return rooms == 0 ? 0.0 : double(corridor_rooms) / rooms;
+    }
+
+    /// Return the mean corridor length, 0 with no corridors.
+    [[nodiscard]] constexpr auto mean_corridor() const -> double
+    {
+        return corridors == 0 ? 0.0 : double(corridor_steps) / corridors;
+    }
+
+    friend auto constexpr operator==(Maze_metrics const&, Maze_metrics const&)
+        -> bool = default;
+};
+
+}  // namespace maze
+
+namespace maze::detail {
+
+/// A corridor between ends \p a and \p b, numbered in row order, of
+/// \p length steps.
+struct Corridor_edge {
+    std::uint32_t a;
+    std::uint32_t b;
+    std::uint32_t length;
+};
+
+}  // namespace maze::detail
+
+namespace maze {
+
+/// Scratch memory for analyze.
+/** Two bits per cell plus a few Words per dead end and junction. Keeps its
+ *  capacity across calls. */
+struct Analytics_workspace {
+    Analytics_workspace() = default;
+
+    /// Allocate all scratch memory from \p resource.
+    explicit Analytics_workspace(std::pmr::memory_resource* resource)
+        : ends(resource),
+          walked(resource),
+          rank(resource),
+          edges(resource),
+          offsets(resource),
+          adjacent(resource),
+          distance(resource),
+          stack(resource)
+    {}
+
+    /// Passages that end corridors, a bit per cell in row order.
+    std::pmr::vector<Word> ends;
+    /// Corridor cells already walked, a bit per cell in row order.
+    std::pmr::vector<Word> walked;
+    /// Ends before each Word of ends.
+    std::pmr::vector<std::uint32_t> rank;
+    /// The corridor tree: its edges, then as adjacency lists.
+    std::pmr::vector<detail::Corridor_edge> edges;
+    std::pmr::vector<std::uint32_t> offsets;
+    std::pmr::vector<detail::Corridor_edge> adjacent;
+    /// Diameter search scratch, per end.
+    std::pmr::vector<std::uint64_t> distance;
+    std::pmr::vector<std::uint32_t> stack;
+};
+
+}  // namespace maze
+
+namespace maze::detail {
+
+/// Count Passages, their degrees and the rooms of \p maze into \p metrics,
+/// and set the bit in \p ends of every Passage that ends a corridor.
+/** Works a Word of 64 cells at a time: the four neighbor masks of a Word are
+ *  the row shifted each way and the rows above and below, summed bit-sliced
+ *  into three bit planes of the degree. \p ends is zeroed, a bit per cell in
+ *  row order. */
+template <Cell_grid G>
+constexpr void count_degrees(G const& maze,
+                             Maze_metrics& metrics,
+                             std::span<Word> ends)
+{
+    constexpr auto width  = std::size_t{G::width};
+    constexpr auto height = std::size_t{G::height};
+    constexpr auto chunks = (width + word_bits - 1) / word_bits;
+    auto const chunk_at   = [&](Distance y, std::size_t i) -> Word {
+        return (y < height && i < chunks) ? row_chunk(maze, y, i) : Word{0};
+    };
+
+    for (auto y = Distance{0}; y < height; ++y) {
+        auto before = Word{0};
+        auto bits   = chunk_at(y, 0);
+        for (auto i = std::size_t{0}; i < chunks; ++i) {
+            auto const after = chunk_at(y, i + 1);
+            auto const west  = (bits << 1) | (before >> (word_bits - 1));
+            auto const east  = (bits >> 1) | (after << (word_bits - 1));
+            auto const north = y == 0 ? Word{0} : chunk_at(y - 1, i);
+            auto const south = chunk_at(y + 1, i);
+
+            // Bit-sliced sum of four one bit inputs.
+            auto const low_sum   = west ^ east;
+            auto const high_sum  = north ^ south;
+            auto const ones      = low_sum ^ high_sum;
+            auto const low_pair  = west & east;
+            auto const high_pair = north & south;
+            auto const twos  = low_pair ^ high_pair ^ (low_sum & high_sum);
+            auto const fours = low_pair & high_pair;
+            auto const two   = bits & ~ones & twos & ~fours;
+
+            metrics.passages += std::popcount(bits);
+            metrics.degrees[0] += std::popcount(bits & ~ones & ~twos & ~fours);
+            metrics.degrees[1] += std::popcount(bits & ones & ~twos & ~fours);
+            metrics.degrees[2] += std::popcount(two);
+            metrics.degrees[3] += std::popcount(bits & ones & twos);
+            metrics.degrees[4] += std::popcount(bits & fours);
+            if (y % 2 == 0) {
+                auto const rooms = bits & even_cells;
+                metrics.rooms += std::popcount(rooms);
+                metrics.corridor_rooms += std::popcount(rooms & two);
+            }
+            auto const first = (std::size_t{y} * width) + (i * word_bits);
+            auto const count = std::min(width - (i * word_bits), word_bits);
+            write_bits(ends, first, count, bits & ~two);
+            before = bits;
+            bits   = after;
+        }
+    }
+}
+
+/// Walk every corridor of \p maze into \p metrics and workspace.edges.
+/** Starts from every end in workspace.ends, in each open Direction, and
+ *  follows the corridor to its other end, marking its cells walked. A
+ *  corridor already walked from its other end is skipped, so each cell is
+ *  stepped through once. */
+template <Cell_grid G>
+void walk_corridors(G const& maze,
+                    Maze_metrics& metrics,
+                    Analytics_workspace& workspace)
+{
+    auto const flat = [](Point p) {
+        return (std::size_t{p.y} * G::width) + p.x;
+    };
+    auto const ends   = std::span<Word const>{workspace.ends};
+    auto const walked = std::span<Word>{workspace.walked};
+    auto& rank        = workspace.rank;
+    rank.resize(ends.size());
+    auto total = std::uint32_t{0};
+    for (auto i = std::size_t{0}; i < ends.size(); ++i) {
+        rank[i] = total;
+        total += static_cast<std::uint32_t>(std::popcount(ends[i]));
+    }
+    auto const number = [&](std::size_t at) {
+        return rank[at / word_bits] +
+               static_cast<std::uint32_t>(std::popcount(
+                   ends[at / word_bits] & low_bits(at % word_bits)));
+    };
+
+    workspace.edges.clear();
+    for (auto i = std::size_t{0}; i < ends.size(); ++i) {
+        for (auto word = ends[i]; word != 0; word &= word - 1) {
+            auto const from  = (i * word_bits) + std::countr_zero(word);
+            auto const start = Point{static_cast<Distance>(from % G::width),
+                                     static_cast<Distance>(from / G::width)};
+            for (auto const first : utility::directions) {
+                auto at = utility::next_passage(maze, start, first);
+                if (!at)
+                    continue;
+                auto to = flat(*at);
+                if (test_bit(ends, to) ? to < from : test_bit(walked, to))
+                    continue;
+                auto heading = first;
+                auto length  = std::uint32_t{1};
+                while (!test_bit(ends, to)) {
+                    assign_bit(walked, to, true);
+                    for (auto const d : utility::directions) {
+                        if (d == utility::opposite(heading))
+                            continue;
+                        if (auto const next =
+                                utility::next_passage(maze, *at, d)) {
+                            at      = next;
+                            heading = d;
+                            break;
+                        }
+                    }
+                    to = flat(*at);
+                    ++length;
+                }
+                workspace.edges.push_back({number(from), number(to), length});
+                ++metrics.corridors;
+                metrics.corridor_steps += length;
+                metrics.longest_corridor =
+                    std::max(metrics.longest_corridor, length);
+                auto const bucket = std::min<std::size_t>(
+                    std::bit_width(length) - 1, corridor_buckets - 1);
+                ++metrics.corridor_lengths[bucket];
+            }
+        }
+    }
+}
+
+/// Return the end farthest from end \p start along the corridor tree, and
+/// its distance in steps.
+/** Depth first over workspace.adjacent, each end is entered once. */
+inline auto farthest_end(Analytics_workspace& workspace, std::uint32_t start)
+    -> std::pair<std::uint32_t, std::uint64_t>
+{
+    constexpr auto unvisited = std::numeric_limits<std::uint64_t>::max();
+    auto& distance           = workspace.distance;
+    auto& stack              = workspace.stack;
+    std::ranges::fill(distance, unvisited);
+    distance[start] = 0;
+    stack.assign(1, start);
+
+    auto best = std::pair{start, std::uint64_t{0}};
+    while (!stack.empty()) {
+        auto const at = stack.back();
+        stack.pop_back();
+        if (distance[at] > best.second)
+            best = {at, distance[at]};
+        for (auto k = workspace.offsets[at]; k < workspace.offsets[at + 1];
+             ++k) {
+            auto const& edge = workspace.adjacent[k];
+            if (distance[edge.b] != unvisited)
+                continue;
+            distance[edge.b] = distance[at] + edge.length;
+            stack.push_back(edge.b);
+        }
+    }
+    return best;
+}
+
+/// Return the cells on the longest path through the corridor tree in
+/// workspace.edges, with \p end_count ends.
+/** Lays the edges out as adjacency lists, then searches twice: the end
+ *  farthest from any end starts a longest path of a tree. */
+inline auto corridor_diameter(Analytics_workspace& workspace,
+                              std::uint32_t end_count) -> std::uint64_t
+{
+    auto& offsets = workspace.offsets;
+    offsets.assign(std::size_t{end_count} + 1, 0);
+    for (auto const& edge : workspace.edges) {
+        ++offsets[edge.a + 1];
+        ++offsets[edge.b + 1];
+    }
+    for (auto i = std::size_t{0}; i < end_count; ++i)
+        offsets[i + 1] += offsets[i];
+
+    auto& adjacent = workspace.adjacent;
+    adjacent.resize(workspace.edges.size() * 2);
+    workspace.stack.assign(offsets.begin(), offsets.end() - 1);
+    for (auto const& edge : workspace.edges) {
+        adjacent[workspace.stack[edge.a]++] = edge;
+        adjacent[workspace.stack[edge.b]++] = {edge.b, edge.a, edge.length};
+    }
+
+    workspace.distance.resize(end_count);
+    auto const far = farthest_end(workspace, 0).first;
+    return farthest_end(workspace, far).second + 1;
+}
+
+}  // namespace maze::detail
+
+namespace maze {
+
+/// Return the metrics of \p m from a single bitset pass: passages, degrees,
+/// rooms and corridor rooms. The corridor fields and diameter are zero.
+/** The cheap first half of analyze(), for rejecting a Maze early. Finish
+ *  with analyze_corridors() and the same \p workspace. */
+template <Cell_grid G>
+[[nodiscard]] auto analyze_degrees(G const& m, Analytics_workspace& workspace)
+    -> Maze_metrics
+{
+    constexpr auto word_count =
+        ((std::size_t{G::width} * G::height) + word_bits - 1) / word_bits;
+    workspace.ends.assign(word_count, Word{0});
+
+    auto metrics = Maze_metrics{};
+    detail::count_degrees(m, metrics, workspace.ends);
+    return metrics;
+}
+
+/// Fill the corridor fields and diameter of \p metrics, the result of
+/// analyze_degrees(\p m, \p workspace).
+template <Cell_grid G>
+void analyze_corridors(G const& m,
+                       Maze_metrics& metrics,
+                       Analytics_workspace& workspace)
+{
+    workspace.walked.assign(workspace.ends.size(), Word{0});
+    detail::walk_corridors(m, metrics, workspace);
+    auto const end_count = metrics.passages - metrics.degrees[2];
+    if (end_count != 0) {
+        metrics.diameter = static_cast<std::uint32_t>(
+            detail::corridor_diameter(workspace, end_count));
+    }
+}
+
+/// Return the difficulty metrics of \p m.
+/** A single bitset pass counts degrees and rooms and marks the dead ends and
+ *  junctions. A walk through every corridor, stepping through each cell once,
+ *  measures them and links the ends into a tree far smaller than \p m,
+ *  whose diameter two searches find. Linear in the size of \p m. Scratch
+ *  memory is taken from \p workspace. */
+template <Cell_grid G>
+[[nodiscard]] auto analyze(G const& m, Analytics_workspace& workspace)
+    -> Maze_metrics
+{
+    auto metrics = analyze_degrees(m, workspace);
+    analyze_corridors(m, metrics, workspace);
+    return metrics;
+}
+
+/// Return the difficulty metrics of \p m.
+/** The scratch memory of a Mapped_storage Maze is file mapped beside it. */
+template <Cell_grid G>
+[[nodiscard]] auto analyze(G const& m) -> Maze_metrics
+{
+    auto scratch   = detail::Scratch_memory{m};
+    auto workspace = Analytics_workspace{scratch.resource()};
+    return analyze(m, workspace);
+}
+
+/// Return the metrics of every Maze in \p mazes, analyzed on
+/// \p thread_count threads.
+/** Each thread owns an Analytics_workspace and takes the next unanalyzed
+ *  Maze until none are left. Rethrows the first exception from a thread.
+ *  Throws std::invalid_argument if \p thread_count is zero. */
+template <Distance Width, Distance Height, typename Layout, typename Storage>
+[[nodiscard]] auto analyze_batch(
+    std::span<Maze<Width, Height, Layout, Storage> const> mazes,
+    std::size_t thread_count = detail::default_thread_count())
+    -> std::vector<Maze_metrics>
+{
+    if (thread_count == 0)
+        throw std::invalid_argument{"analyze_batch: zero threads."};
+    auto results = std::vector<Maze_metrics>(mazes.size());
+    auto next    = std::atomic<std::size_t>{0};
+    auto mutex   = std::mutex{};
+    auto error   = std::exception_ptr{};
+
+    auto const work = [&] {
+        try {
+            auto workspace = Analytics_workspace{};
+            for (auto i = next++; i < mazes.size(); i = next++)
+                results[i] = analyze(mazes[i], workspace);
+        }
+        catch (...) {
+            auto const lock = std::lock_guard{mutex};
+            if (error == nullptr)
+                error = std::current_exception();
+            next.store(mazes.size());
+        }
+    };
+
+    thread_count = std::min(thread_count, mazes.size());
+    auto threads = std::vector<std::thread>{};
+    threads.reserve(thread_count);
+    for (auto t = std::size_t{1}; t < thread_count; ++t)
+        threads.emplace_back(work);
+    work();
+    for (auto& thread : threads)
+        thread.join();
+    if (error != nullptr)
+        std::rethrow_exception(error);
+    return results;
+}
+
+}  // namespace maze
+#endif  // MAZE_ANALYTICS_HPP
@@ -0,0 +1,378 @@
+#ifndef MAZE_ARCHIVE_HPP
+#define MAZE_ARCHIVE_HPP
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <maze/cell.hpp>
+#include <maze/distance.hpp>
+#include <maze/layout.hpp>
+#include <maze/mapped_file.hpp>
+#include <maze/maze.hpp>
+#include <maze/maze_view.hpp>
+#include <maze/serialize.hpp>
+
+namespace maze {
+
+/// Per-block compression applied by Archive_writer.
+enum class Compression : std::uint32_t {
+    None,    // Raw Words, readable in place as a Maze_view.
+    Row_rle  // Alternating Wall/Passage run lengths per row, as varints.
+};
+
+/// Current version of the archive format written by Archive_writer.
+inline constexpr auto archive_version = std::uint16_t{1};
+
+/// Fixed size header at the start of a Maze archive.
+/** Followed by count 8 byte aligned blocks, then count Archive_entry records
+ *  at index_offset. count and index_offset are written by finish(). */
+struct Archive_header {
+    std::array<char, 4> magic  = {'M', 'Z', 'A', 'R'};
+    std::uint16_t version      = archive_version;
+    std::uint16_t byte_order   = 0x0102;
+    std::uint16_t width        = 0;
+    std::uint16_t height       = 0;
+    std::uint32_t compression  = 0;
+    std::uint64_t count        = 0;
+    std::uint64_t index_offset = 0;
+};
+
+static_assert(sizeof(Archive_header) == 32);
+
+/// Index record locating a single Maze block within an archive.
+struct Archive_entry {
+    std::uint64_t offset    = 0;
+    std::uint64_t size      = 0;
+    std::uint64_t seed      = 0;
+    std::uint32_t generator = 0;
+    std::uint32_t encoding  = 0;  // Compression used by this block.
+};
+
+static_assert(sizeof(Archive_entry) == 32);
+
+}  // namespace maze
+
+namespace maze::detail {
+
+inline void append_varint(std::vector<std::byte>& out, std::size_t value)
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::byte>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::byte>(value));
+}
+
+/// Read a varint from \p in at \p at, advancing \p at.
+/** Throws std::runtime_error if \p in ends before the varint does. */
+[[nodiscard]] inline auto read_varint(std::span<std::byte const> in,
+                                      std::size_t& at) -> std::size_t
+{
+    auto value = std::size_t{0};
+    for (auto shift = 0; at < in.size() && shift < 64; shift += 7) {
+        auto const byte = std::to_integer<std::size_t>(in[at++]);
+        value |= (byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+            return value;
+    }
+    throw std::runtime_error{"Maze archive: corrupt run length."};
+}
+
+/// Return the length of the run of \p bit values in \p row starting at \p x.
+[[nodiscard]] inline auto run_length(std::span<Word const> row,
+                                     std::size_t x,
+                                     std::size_t width,
+                                     bool bit) -> std::size_t
+{
+    auto const flip = bit ? ~Word{0} : Word{0};
+    auto at         = x;
+    while (at < width) {
+        auto const differ = (row[at / word_bits] ^ flip) >> (at % word_bits);
+        if (differ != 0) {
+            at += static_cast<std::size_t>(std::countr_zero(differ));
+            break;
+        }
+        at += word_bits - (at % word_bits);
+    }
+    return (at < width ? at : width) - x;
+}
+
+/// Append \p words as Compression::Row_rle to \p out.
+/** Each row is a Wall run, a Passage run, and so on, the first may be 0. */
+template <Distance Width, Distance Height>
+void encode_row_rle(std::span<Word const> words, std::vector<std::byte>& out)
+{
+    constexpr auto per_row = Row_major::words_per_row<Width, Height>;
+    for (auto y = std::size_t{0}; y < Height; ++y) {
+        auto const row = words.subspan(y * per_row, per_row);
+        auto bit       = false;
+        for (auto x = std::size_t{0}; x < Width; bit = !bit) {
+            auto const length = run_length(row, x, Width, bit);
+            append_varint(out, length);
+            x += length;
+        }
+    }
+}
+
+/// Decode Compression::Row_rle from \p in into \p words.
+/** \p words must be zeroed. Throws std::runtime_error if \p in is corrupt. */
+template <Distance Width, Distance Height>
+void decode_row_rle(std::span<std::byte const> in, std::span<Word> words)
+{
+    constexpr auto per_row = Row_major::words_per_row<Width, Height>;
+    auto at                = std::size_t{0};
+    for (auto y = std::size_t{0}; y < Height; ++y) {
+        auto const row = words.subspan(y * per_row, per_row);
+        auto bit       = false;
+        for (auto x = std::size_t{0}; x < Width; bit = !bit) {
+            auto const length = read_varint(in, at);
+            if (length > Width - x)
+                throw std::runtime_error{"Maze archive: run overflows row."};
+            if (bit)
+                assign_bits(row, x, x + length, true);
+            x += length;
+        }
+    }
+}
+
+}  // namespace maze::detail
+
+namespace maze {
+
+/// Streams many Maze<Width, Height> into a single archive file.
+/** Each append writes its block immediately, only the index is held in
+ *  memory until finish(). Row_rle blocks that would not be smaller than the
+ *  raw Words are stored raw, so the reader can still view them in place. */
+template <Distance Width, Distance Height>
+class Archive_writer {
+   public:
+    /// Create or truncate the archive at \p path.
+    /** Throws std::runtime_error if the file can't be opened. */
+    explicit Archive_writer(std::filesystem::path const& path,
+                            Compression compression = Compression::None)
+        : file_{path, std::ios::binary | std::ios::trunc}
+    {
+        if (!file_)
+            throw std::runtime_error{"Archive_writer: can't open file."};
+        header_.width       = Width;
+        header_.height      = Height;
+        header_.compression = static_cast<std::uint32_t>(compression);
+        write_bytes(&header_, sizeof(header_));
+    }
+
+    Archive_writer(Archive_writer const&) = delete;
+    auto operator=(Archive_writer const&) -> Archive_writer& = delete;
+
+    /// Calls finish(), errors are dropped; call finish() to observe them.
+    ~Archive_writer()
+    {
+        try {
+            finish();
+        }
+        catch (...) {
+        }
+    }
+
+   public:
+    /// Append \p maze with \p metadata, returns the id of the new entry.
+    /** Throws std::runtime_error on write failure or after finish(). */
+    auto append(Maze_view<Width, Height> maze, Maze_metadata metadata = {})
+        -> std::size_t
+    {
+        if (finished_)
+            throw std::runtime_error{"Archive_writer: append after finish."};
+
+        auto const raw = std::as_bytes(maze.words());
+        auto block     = std::span<std::byte const>{raw};
+        auto encoding  = Compression::None;
+        if (header_.compression ==
+            static_cast<std::uint32_t>(Compression::Row_rle)) {
+            scratch_.clear();
+            detail::encode_row_rle<Width, Height>(maze.words(), scratch_);
+            if (scratch_.size() < raw.size()) {
+                block    = scratch_;
+                encoding = Compression::Row_rle;
+            }
+        }
+
+        index_.push_back({offset_, block.size(), metadata.seed,
+                          static_cast<std::uint32_t>(metadata.generator),
+                          static_cast<std::uint32_t>(encoding)});
+        write_bytes(block.data(), block.size());
+        pad_to_word();
+        return index_.size() - 1;
+    }
+
+    /// Write the index and patch the header. No-op if already finished.
+    /** Throws std::runtime_error on write failure. */
+    void finish()
+    {
+        if (finished_)
+            return;
+        finished_            = true;
+        header_.count        = index_.size();
+        header_.index_offset = offset_;
+        write_bytes(index_.data(), index_.size() * sizeof(Archive_entry));
+        file_.seekp(0);
+        file_.write(reinterpret_cast<char const*>(&header_), sizeof(header_));
+        file_.flush();
+        if (!file_)
+            throw std::runtime_error{"Archive_writer: write failure."};
+    }
+
+    /// Return the number of Mazes appended so far.
+    [[nodiscard]] auto size() const -> std::size_t { return index_.size(); }
+
+   private:
+    std::ofstream file_;
+    Archive_header header_;
+    std::vector<Archive_entry> index_;
+    std::vector<std::byte> scratch_;
+    std::uint64_t offset_ = 0;
+    bool finished_        = false;
+
+   private:
+    void write_bytes(void const* data, std::size_t size)
+    {
+        file_.write(static_cast<char const*>(data),
+                    static_cast<std::streamsize>(size));
+        if (!file_)
+            throw std::runtime_error{"Archive_writer: write failure."};
+        offset_ += size;
+    }
+
+    /// Keep every block Word aligned so raw blocks can be viewed in place.
+    void pad_to_word()
+    {
+        constexpr auto zeros = std::array<char, sizeof(Word)>{};
+        if (auto const over = offset_ % sizeof(Word); over != 0)
+            write_bytes(zeros.data(), sizeof(Word) - over);
+    }
+};
+
+/// Read-only, memory mapped access to an archive written by Archive_writer.
+/** Lookups by id are O(1), raw blocks are viewed without a copy. */
+template <Distance Width, Distance Height>
+class Archive_reader {
+   public:
+    /// Map the archive at \p path.
+    /** Throws std::system_error if mapping fails and std::runtime_error if the
+     *  file is not a finished archive of Maze<Width, Height>. */
+    explicit Archive_reader(std::filesystem::path const& path) : file_{path}
+    {
+        auto const bytes = file_.bytes();
+        if (bytes.size() < sizeof(Archive_header))
+            throw std::runtime_error{"Archive_reader: truncated header."};
+        std::memcpy(&header_, bytes.data(), sizeof(header_));
+
+        auto const expected = Archive_header{};
+        if (header_.magic != expected.magic ||
+            header_.byte_order != expected.byte_order ||
+            header_.version != archive_version) {
+            throw std::runtime_error{"Archive_reader: not a Maze archive."};
+        }
+        if (header_.width != Width || header_.height != Height)
+            throw std::runtime_error{"Archive_reader: dimension mismatch."};
+        // Divide rather than multiply, a corrupt count must not overflow.
+        if (header_.index_offset % sizeof(Word) != 0 ||
+            header_.index_offset > bytes.size() ||
+            header_.count > (bytes.size() - header_.index_offset) /
+                                sizeof(Archive_entry)) {
+            throw std::runtime_error{"Archive_reader: truncated index."};
+        }
+        index_ = {reinterpret_cast<Archive_entry const*>(
+                      bytes.data() + header_.index_offset),
+                  header_.count};
+    }
+
+   public:
+    /// Return the number of Mazes in the archive.
+    [[nodiscard]] auto size() const -> std::size_t { return index_.size(); }
+
+    /// Return the metadata stored with Maze \p id.
+    /** Throws std::out_of_range if \p id is not in the archive. */
+    [[nodiscard]] auto metadata(std::size_t id) const -> Maze_metadata
+    {
+        auto const& entry = index_entry(id);
+        return {entry.seed, static_cast<Generator_id>(entry.generator)};
+    }
+
+    /// Return true if Maze \p id is stored raw and can be view()ed.
+    /** Throws std::out_of_range if \p id is not in the archive. */
+    [[nodiscard]] auto is_viewable(std::size_t id) const -> bool
+    {
+        return index_entry(id).encoding ==
+               static_cast<std::uint32_t>(Compression::None);
+    }
+
+    /// Return a zero-copy view of Maze \p id, valid for the life of *this.
+    /** Throws std::out_of_range if \p id is not in the archive and
+     *  std::runtime_error if the block is compressed, see is_viewable(), or
+     *  corrupt. */
+    [[nodiscard]] auto view(std::size_t id) const -> Maze_view<Width, Height>
+    {
+        constexpr auto word_count = Maze<Width, Height>::word_count;
+        if (!is_viewable(id))
+            throw std::runtime_error{"Archive_reader: block is compressed."};
+        auto const& entry = index_entry(id);
+        auto const block  = block_of(entry);
+        if (entry.offset % alignof(Word) != 0 ||
+            block.size() != word_count * sizeof(Word))
+            throw std::runtime_error{"Archive_reader: corrupt block."};
+        auto const words = std::span<Word const, word_count>{
+            reinterpret_cast<Word const*>(block.data()), word_count};
+        detail::check_padding<Width, Height>(words);
+        return Maze_view<Width, Height>{words};
+    }
+
+    /// Return a copy of Maze \p id, decompressing if needed.
+    /** Throws std::out_of_range if \p id is not in the archive and
+     *  std::runtime_error if the block is corrupt or in an unknown encoding. */
+    [[nodiscard]] auto load(std::size_t id) const -> Maze<Width, Height>
+    {
+        if (is_viewable(id))
+            return view(id).to_maze();
+        if (index_entry(id).encoding !=
+            static_cast<std::uint32_t>(Compression::Row_rle))
+            throw std::runtime_error{"Archive_reader: unknown encoding."};
+        auto result = Maze<Width, Height>{Cell::Wall};
+        detail::decode_row_rle<Width, Height>(block_of(index_entry(id)),
+                                              result.words());
+        return result;
+    }
+
+   private:
+    Mapped_file file_;
+    Archive_header header_;
+    std::span<Archive_entry const> index_;
+
+   private:
+    [[nodiscard]] auto index_entry(std::size_t id) const
+        -> Archive_entry const&
+    {
+        if (id >= index_.size())
+            throw std::out_of_range{"Archive_reader: invalid id."};
+        return index_[id];
+    }
+
+    [[nodiscard]] auto block_of(Archive_entry const& entry) const
+        -> std::span<std::byte const>
+    {
+        auto const bytes = file_.bytes();
+        if (entry.offset > bytes.size() ||
+            bytes.size() - entry.offset < entry.size) {
+            throw std::runtime_error{"Archive_reader: corrupt index."};
+        }
+        return bytes.subspan(entry.offset, entry.size);
+    }
+};
+
+}  // namespace maze
+#endif  // MAZE_ARCHIVE_HPP
@@ -0,0 +1,248 @@
+#ifndef MAZE_ASYNC_HPP
+#define MAZE_ASYNC_HPP
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <maze/cell.hpp>
+#include <maze/distance.hpp>
+#include <maze/generate_aldous_broder.hpp>
+#include <maze/generate_binary_tree.hpp>
+#include <maze/generate_ellers.hpp>
+#include <maze/generate_hunt_and_kill.hpp>
+#include <maze/generate_kruskal.hpp>
+#include <maze/generate_prims.hpp>
+#include <maze/generate_recursive_backtracking.hpp>
+#include <maze/generate_recursive_division.hpp>
+#include <maze/generate_sidewinder.hpp>
+#include <maze/generator_pool.hpp>
+#include <maze/layout.hpp>
+#include <maze/longest_path.hpp>
+#include <maze/path.hpp>
+#include <maze/maze.hpp>
+#include <maze/point.hpp>
+#include <maze/serialize.hpp>
+#include <maze/stepper.hpp>
+
+namespace maze {
+
+/// Stored in a future when its operation was stopped through a stop token.
+class Operation_cancelled : public std::runtime_error {
+   public:
+    Operation_cancelled() : std::runtime_error{"maze: operation cancelled."} {}
+};
+
+/// Runs submitted tasks, at some point, on some thread.
+template <typename T>
+concept Executor = requires(T& executor, std::function<void()> task) {
+    executor.execute(std::move(task));
+};
+
+/// Executor that runs each task on its own thread.
+/** The destructor joins every thread, so tasks can't outlive the objects
+ *  they reference when those outlive the executor. Threads of finished tasks
+ *  are joined on the next execute(). Safe to call from several threads. */
+class Thread_executor {
+   public:
+    Thread_executor() = default;
+
+    Thread_executor(Thread_executor const&) = delete;
+    auto operator=(Thread_executor const&) -> Thread_executor& = delete;
+
+   public:
+    void execute(std::function<void()> task)
+    {
+        auto const lock = std::lock_guard{mutex_};
+        std::erase_if(threads_, [](Task_thread const& t) {
+            return t.done->load(std::memory_order_acquire);
+        });
+        auto done = std::make_shared<std::atomic<bool>>(false);
+        threads_.push_back(
+            {done, std::jthread{[done, task = std::move(task)] {
+                 task();
+                 done->store(true, std::memory_order_release);
+             }}});
+    }
+
+   private:
+    struct Task_thread {
+        std::shared_ptr<std::atomic<bool>> done;
+        std::jthread thread;  // Joined when erased or destroyed.
+    };
+
+    std::mutex mutex_;  // Guards threads_.
+    std::vector<Task_thread> threads_;
+};
+
+/// Executor that runs each task immediately on the calling thread.
+struct Inline_executor {
+    void execute(std::function<void()> task) { task(); }
+};
+
+}  // namespace maze
+
+namespace maze::detail {
+
+/// Take steps from \p stepper until the maze is complete or \p stop is
+/// requested, then move its workspace back into \p workspace.
+/** Returns true if the maze is complete. */
+template <Stepper S, typename Workspace>
+auto run_reusing(S&& stepper, Workspace& workspace, std::stop_token stop)
+    -> bool
+{
+    auto const done = run_until_done(stepper, stop);
+    workspace       = stepper.take_workspace();
+    return done;
+}
+
+/// Take steps from \p stepper until the maze is complete or \p stop is
+/// requested. Returns true if the maze is complete.
+template <Stepper S>
+auto run_to_end(S&& stepper, std::stop_token stop) -> bool
+{
+    return run_until_done(stepper, stop);
+}
+
+/// Overwrite \p m using generator \p id, checking \p stop between steps.
+/** Eller's, Binary Tree, Sidewinder and Hunt-and-Kill have no Stepper, they
+ *  check \p stop once per row of rooms, Hunt-and-Kill once per hunt. Gives
+ *  the Maze generate_into() does from the same \p gen, with scratch memory
+ *  from \p workspace. Returns false, leaving \p m part carved, if \p stop
+ *  was requested first. Throws std::invalid_argument on an Unknown id. */
+template <Distance Width,
+          Distance Height,
+          typename Layout,
+          typename Storage,
+          std::uniform_random_bit_generator Gen>
+auto generate_stoppable(Generator_id id,
+                        Maze<Width, Height, Layout, Storage>& m,
+                        Generator_workspace& workspace,
+                        Gen gen,
+                        std::stop_token stop) -> bool
+{
+    switch (id) {
+        case Generator_id::Recursive_backtracking:
+            return run_reusing(
+                Recursive_backtracking_stepper{
+                    m, gen, std::move(workspace.backtracking)},
+                workspace.backtracking, stop);
+        case Generator_id::Kruskal:
+            return run_reusing(
+                Kruskal_stepper{m, gen, std::move(workspace.kruskal)},
+                workspace.kruskal, stop);
+        case Generator_id::Prims:
+            return run_reusing(
+                Prims_stepper{m, gen, std::move(workspace.prims)},
+                workspace.prims, stop);
+        case Generator_id::Aldous_broder:
+            return run_to_end(Aldous_broder_stepper{m, gen}, stop);
+        case Generator_id::Recursive_division:
+            return run_to_end(Recursive_division_stepper{m, gen}, stop);
+        case Generator_id::Ellers:
+            return generate_ellers_into(m, workspace.ellers, gen, stop);
+        case Generator_id::Binary_tree:
+            return generate_binary_tree_into(m, gen, stop);
+        case Generator_id::Sidewinder:
+            return generate_sidewinder_into(m, gen, stop);
+        case Generator_id::Hunt_and_kill:
+            return generate_hunt_and_kill_into(m, workspace.hunt_and_kill, gen,
+                                               stop);
+        case Generator_id::Unknown: break;
+    }
+    throw std::invalid_argument{"generate_async: Unknown Generator_id."};
+}
+
+/// Overwrite \p m using generator \p id, checking \p stop between steps.
+/** Throws Operation_cancelled if \p stop is requested first. */
+template <Distance Width,
+          Distance Height,
+          typename Layout,
+          typename Storage,
+          std::uniform_random_bit_generator Gen>
+void generate_stoppable(Generator_id id,
+                        Maze<Width, Height, Layout, Storage>& m,
+                        Gen gen,
+                        std::stop_token stop)
+{
+    auto workspace = Generator_workspace{m};
+    if (!generate_stoppable(id, m, workspace, std::move(gen), stop))
+        throw Operation_cancelled{};
+}
+
+/// Submit \p work to \p executor, its result or exception fulfills the
+/// returned future.
+template <typename T, Executor E, typename Work>
+[[nodiscard]] auto submit(E& executor, Work work) -> std::future<T>
+{
+    auto promise = std::make_shared<std::promise<T>>();
+    auto result  = promise->get_future();
+    executor.execute([promise, work = std::move(work)]() mutable {
+        try {
+            promise->set_value(work());
+        }
+        catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+    });
+    return result;
+}
+
+}  // namespace maze::detail
+
+namespace maze {
+
+/// Generate a maze with generator \p id on \p executor.
+/** The future holds Operation_cancelled if \p stop is requested before the
+ *  maze is complete. The maze is reproducible from \p seed, drawn with
+ *  std::mt19937_64. Throws std::invalid_argument on an Unknown id. */
+template <Distance Width,
+          Distance Height,
+          typename Layout = Row_major,
+          Executor E>
+[[nodiscard]] auto generate_async(E& executor,
+                                  Generator_id id,
+                                  std::stop_token stop = {},
+                                  std::uint64_t seed = std::random_device{}())
+    -> std::future<Maze<Width, Height, Layout>>
+{
+    using Maze_type = Maze<Width, Height, Layout>;
+    if (id == Generator_id::Unknown)
+        throw std::invalid_argument{"generate_async: Unknown Generator_id."};
+    return detail::submit<Maze_type>(executor, [id, stop, seed] {
+        auto m = Maze_type{Cell::Wall};
+        detail::generate_stoppable(id, m, std::mt19937_64{seed}, stop);
+        return m;
+    });
+}
+
+/// Find the longest path in \p maze on \p executor.
+/** The future holds Operation_cancelled if \p stop is requested before the
+ *  search is complete. */
+template <Distance Width, Distance Height, typename... Policies, Executor E>
+[[nodiscard]] auto longest_path_async(E& executor,
+                                      Maze<Width, Height, Policies...> maze,
+                                      std::stop_token stop = {})
+    -> std::future<Path>
+{
+    using Maze_type = Maze<Width, Height, Policies...>;
+    auto shared     = std::make_shared<Maze_type>(std::move(maze));
+    return detail::submit<Path>(executor, [shared, stop] {
+        auto path = longest_path(*shared, stop);
+        if (!path.has_value())
+            throw Operation_cancelled{};
+        return std::move(*path);
+    });
+}
+
+}  // namespace maze
+#endif  // MAZE_ASYNC_HPP
@@ -0,0 +1,226 @@
+#ifndef MAZE_BIAS_HPP
+#define MAZE_BIAS_HPP
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <maze/direction.hpp>
+#include <maze/point.hpp>
+#include <maze/random.hpp>
+#include <maze/utility.hpp>
+
+namespace maze {
+
+/// Samples an index with probability proportional to its weight in O(1).
+/** Vose's alias method: a uniform column, then a biased coin between the
+ *  column and its alias. Built once in O(n). */
+class Alias_table {
+   public:
+    /// Create an empty table, sample() must not be called on it.
+    Alias_table() = default;
+
+    /// Create a table sampling index i with probability proportional to \p
+    /// weights[i].
+    /** Throws std::invalid_argument if \p weights is empty, has a negative or
+     *  non-finite weight, or sums to zero. */
+    explicit Alias_table(std::span<double const> weights)
+        : probability_(weights.size()), alias_(weights.size())
+    {
+        auto const n = weights.size();
+        if (n == 0)
+            throw std::invalid_argument{"Alias_table: no weights."};
+        for (auto const w : weights) {
+            if (!std::isfinite(w) || w < 0.0)
+                throw std::invalid_argument{"Alias_table: invalid weight."};
+        }
+        auto const sum = std::accumulate(weights.begin(), weights.end(), 0.0);
+        if (sum <= 0.0)
+            throw std::invalid_argument{"Alias_table: weights sum to zero."};
+
+        auto small = std::vector<std::size_t>{};
+        auto large = std::vector<std::size_t>{};
+        for (auto i = std::size_t{0}; i < n; ++i) {
+            probability_[i] = weights[i] * static_cast<double>(n) / sum;
+            alias_[i]       = i;
+            (probability_[i] < 1.0 ? small : large).push_back(i);
+        }
+        while (!small.empty() && !large.empty()) {
+            auto const s = small.back();
+            auto const l = large.back();
+            small.pop_back();
+            alias_[s] = l;
+            probability_[l] -= 1.0 - probability_[s];
+            if (probability_[l] < 1.0) {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+        // What is left is 1 up to rounding.
+        for (auto const i : small)
+            probability_[i] = 1.0;
+        for (auto const i : large)
+            probability_[i] = 1.0;
+    }
+
+   public:
+    /// Return an index drawn from \p gen, by weight.
+    template <std::uniform_random_bit_generator Gen>
+    [[nodiscard]] auto sample(Gen& gen) const -> std::size_t
+    {
+        auto const column = utility::random_index(probability_.size() - 1, gen);
+        auto const coin =
+            static_cast<double>(detail::random_word(gen) >> 11) * 0x1p-53;
+        return coin < probability_[column] ? column : alias_[column];
+    }
+
+    /// Return the number of weights.
+    [[nodiscard]] auto size() const -> std::size_t
+    {
+        return probability_.size();
+    }
+
+   private:
+    std::vector<double> probability_;
+    std::vector<std::size_t> alias_;
+};
+
+/// Relative weights of the four Directions, indexed by Direction.
+using Direction_weights = std::array<double, 4>;
+
+/// Return weights favoring East and West by \p strength, long corridors
+/// running across the maze.
+[[nodiscard]] constexpr auto horizontal_bias(double strength)
+    -> Direction_weights
+{
+    return {1.0, 1.0, strength, strength};
+}
+
+/// Return weights favoring North and South by \p strength, long corridors
+/// running down the maze.
+[[nodiscard]] constexpr auto vertical_bias(double strength)
+    -> Direction_weights
+{
+    return {strength, strength, 1.0, 1.0};
+}
+
+/// Direction weights for every Point of a maze, from a set of regions.
+/** Each region has its own Direction_weights, a function maps Points to
+ *  regions: a texture map, a grid of tiles, or a cost field quantized into
+ *  levels. Weights must be positive, so every Direction stays possible and
+ *  biased mazes are still perfect. */
+class Direction_bias {
+   public:
+    /// Maps a Maze Point to the index of its region.
+    using Region_map = std::function<std::size_t(Point)>;
+
+   public:
+    /// Bias every Point by \p weights.
+    /** Throws std::invalid_argument unless every weight is positive. */
+    explicit Direction_bias(Direction_weights weights)
+        : Direction_bias{{weights}, [](Point) { return std::size_t{0}; }}
+    {}
+
+    /// Bias Point p by \p regions[\p region_of(p)].
+    /** \p region_of must return an index into \p regions. Throws
+     *  std::invalid_argument if \p regions is empty or has a weight that
+     *  isn't positive. */
+    Direction_bias(std::vector<Direction_weights> regions,
+                   Region_map region_of)
+        : weights_{std::move(regions)}, region_of_{std::move(region_of)}
+    {
+        if (weights_.empty())
+            throw std::invalid_argument{"Direction_bias: no regions."};
+        orders_.reserve(weights_.size());
+        for (auto const& weights : weights_) {
+            for (auto const w : weights) {
+                if (!std::isfinite(w) || w <= 0.0)
+                    throw std::invalid_argument{
+                        "Direction_bias: weights must be positive."};
+            }
+            orders_.emplace_back(order_weights(weights));
+        }
+    }
+
+   public:
+    /// Return the region of \p p.
+    [[nodiscard]] auto region(Point p) const -> std::size_t
+    {
+        return region_of_(p);
+    }
+
+    /// Return the number of regions.
+    [[nodiscard]] auto region_count() const -> std::size_t
+    {
+        return weights_.size();
+    }
+
+    /// Return the Direction_weights of region \p r.
+    [[nodiscard]] auto weights(std::size_t r) const
+        -> Direction_weights const&
+    {
+        return weights_[r];
+    }
+
+    /// Return the Directions in a random order for \p p, drawn from \p gen.
+    /** Each next Direction is drawn by weight from those left, a single O(1)
+     *  draw from an alias table over all 24 orders of the region. */
+    template <std::uniform_random_bit_generator Gen>
+    [[nodiscard]] auto shuffled_directions(Point p, Gen& gen) const
+        -> std::array<Direction, 4>
+    {
+        return orders()[orders_[region(p)].sample(gen)];
+    }
+
+   private:
+    std::vector<Direction_weights> weights_;
+    std::vector<Alias_table> orders_;  // Per region, over orders().
+    Region_map region_of_;
+
+   private:
+    /// Return all 24 orders of the four Directions.
+    [[nodiscard]] static auto orders()
+        -> std::array<std::array<Direction, 4>, 24> const&
+    {
+        static auto const all = [] {
+            auto result = std::array<std::array<Direction, 4>, 24>{};
+            auto order  = utility::directions;
+            for (auto& o : result) {
+                o = order;
+                std::ranges::next_permutation(order);
+            }
+            return result;
+        }();
+        return all;
+    }
+
+    /// Return the probability of each of orders() when Directions are drawn
+    /// by \p weights without replacement.
+    [[nodiscard]] static auto order_weights(Direction_weights const& weights)
+        -> std::array<double, 24>
+    {
+        auto result = std::array<double, 24>{};
+        for (auto i = std::size_t{0}; i < result.size(); ++i) {
+            auto left = std::accumulate(weights.begin(), weights.end(), 0.0);
+            auto p    = 1.0;
+            for (auto const d : orders()[i]) {
+                auto const w = weights[static_cast<std::size_t>(d)];
+                p *= w / left;
+                left -= w;
+            }
+            result[i] = p;
+        }
+        return result;
+    }
+};
+
+}  // namespace maze
+#endif  // MAZE_BIAS_HPP
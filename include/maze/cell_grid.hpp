@@ -0,0 +1,34 @@
+#ifndef MAZE_CELL_GRID_HPP
+#define MAZE_CELL_GRID_HPP
+#include <concepts>
+
+#include <maze/cell.hpp>
+#include <maze/distance.hpp>
+#include <maze/point.hpp>
+
+namespace maze {
+
+/// Read-only Cells of a width x height maze: a Maze, Maze_view or Wall_maze.
+/** The solvers, analytics, hashes, verify_perfect and display take any
+ *  Cell_grid, so a Maze_view or a Wall_maze is read in place with no Maze
+ *  copy. The Word at a time passes also use a member row_chunk(y, i), Cells
+ *  [64 i, 64 i + 64) of row y as Passage bits, when a grid has one. */
+template <typename G>
+concept Cell_grid = requires(G const& grid, Point p) {
+    { G::width } -> std::convertible_to<Distance>;
+    { G::height } -> std::convertible_to<Distance>;
+    { grid.get(p) } -> std::same_as<Cell>;
+};
+
+}  // namespace maze
+
+namespace maze::detail {
+
+/// Satisfied by Cell_grids kept inside a Wall border, Mazes of a
+/// Sentinel_bordered Layout, where a neighbor is a single index add.
+template <typename G>
+concept Sentinel_grid =
+    Cell_grid<G> && requires { requires G::has_sentinel_border; };
+
+}  // namespace maze::detail
+#endif  // MAZE_CELL_GRID_HPP
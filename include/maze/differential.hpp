@@ -0,0 +1,138 @@
+#ifndef MAZE_DIFFERENTIAL_HPP
+#define MAZE_DIFFERENTIAL_HPP
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <maze/cell.hpp>
+#include <maze/distance.hpp>
+#include <maze/generator_pool.hpp>
+#include <maze/layout.hpp>
+#include <maze/maze.hpp>
+#include <maze/serialize.hpp>
+#include <maze/verify.hpp>
+
+namespace maze {
+
+/// A seed whose Maze failed verify_perfect() during a differential run.
+struct Invalid_maze {
+    std::uint64_t seed;
+    Verification verification;
+
+    friend auto constexpr operator==(Invalid_maze const&, Invalid_maze const&)
+        -> bool = default;
+};
+
+/// Outcome of run_differential().
+/** Every seed listed regenerates its Maze: generate_into() with a
+ *  std::mt19937_64 seeded from it, the same seeding as Generator_pool. */
+struct Differential_report {
+    /// Mazes generated and compared.
+    std::size_t cases = 0;
+    /// Seeds where the reference and candidate results differ.
+    std::vector<std::uint64_t> mismatches;
+    /// Seeds whose Maze was not perfect, those are not compared.
+    std::vector<Invalid_maze> invalid;
+    /// Total time spent in the reference.
+    std::chrono::nanoseconds reference_time{0};
+    /// Total time spent in the candidate.
+    std::chrono::nanoseconds candidate_time{0};
+
+    /// Return true if every Maze was perfect and every result matched.
+    [[nodiscard]] auto passed() const -> bool
+    {
+        return mismatches.empty() && invalid.empty();
+    }
+};
+
+/// Write a one line summary of \p report, then a line per failing seed.
+inline auto operator<<(std::ostream& os, Differential_report const& report)
+    -> std::ostream&
+{
+    using Ms           = std::chrono::duration<double, std::milli>;
+    auto const ref_ms  = Ms{report.reference_time}.count();
+    auto const cand_ms = Ms{report.candidate_time}.count();
+    os << report.cases << " cases, " << report.mismatches.size()
+       << " mismatches, " << report.invalid.size()
+       << " invalid mazes, reference " << ref_ms << " ms, candidate "
+       << cand_ms << " ms\n";
+    for (auto const seed : report.mismatches)
+        os << "  mismatch: seed " << seed << '\n';
+    for (auto const& bad : report.invalid) {
+        os << "  invalid: seed " << bad.seed << ", "
+           << to_string(bad.verification.defect) << " at {"
+           << bad.verification.at.x << ", " << bad.verification.at.y << "}\n";
+    }
+    return os;
+}
+
+/// Compare two implementations of one operation on \p count seeded mazes.
+/** Maze i is generated by \p id from detail::mix_seed(\p seed, i), checked
+ *  with verify_perfect(), then passed to \p reference and \p candidate, whose
+ *  results must satisfy \p equal. Use it to check a faster engine against the
+ *  one it replaces: thousands of small mazes in CI, a few large ones in a
+ *  benchmark, where the report's timings compare the two. Throws
+ *  std::invalid_argument on an Unknown id. */
+template <Distance Width,
+          Distance Height,
+          typename Layout = Row_major,
+          typename Reference,
+          typename Candidate,
+          typename Equal = std::ranges::equal_to>
+    requires std::invocable<Reference&, Maze<Width, Height, Layout> const&> &&
+             std::invocable<Candidate&, Maze<Width, Height, Layout> const&>
+[[nodiscard]] auto run_differential(Generator_id id,
+                                    std::uint64_t seed,
+                                    std::size_t count,
+                                    Reference reference,
+                                    Candidate candidate,
+                                    Equal equal = {}) -> Differential_report
+{
+    if (id == Generator_id::Unknown)
+        throw std::invalid_argument{
+            "run_differential: Unknown Generator_id."};
+
+    using Clock     = std::chrono::steady_clock;
+    auto report     = Differential_report{};
+    auto const maze = std::make_unique<Maze<Width, Height, Layout>>(Cell::Wall);
+    auto workspace  = Generator_workspace{};
+    auto verify_ws  = Verify_workspace{};
+    auto gen        = std::mt19937_64{};
+
+    for (auto i = std::size_t{0}; i < count; ++i) {
+        auto const maze_seed = detail::mix_seed(seed, i);
+        gen.seed(maze_seed);
+        generate_into(id, *maze, workspace, gen);
+        ++report.cases;
+
+        auto const verification = verify_perfect(*maze, verify_ws);
+        if (!verification) {
+            report.invalid.push_back({maze_seed, verification});
+            continue;
+        }
+
+        auto const start    = Clock::now();
+        auto const expected = std::invoke(reference, std::as_const(*maze));
+        auto const middle   = Clock::now();
+        auto const actual   = std::invoke(candidate, std::as_const(*maze));
+        auto const end      = Clock::now();
+        report.reference_time += middle - start;
+        report.candidate_time += end - middle;
+
+        if (!std::invoke(equal, expected, actual))
+            report.mismatches.push_back(maze_seed);
+    }
+    return report;
+}
+
+}  // namespace maze
+#endif  // MAZE_DIFFERENTIAL_HPP
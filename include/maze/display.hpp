@@ -8,8 +8,11 @@
 #include <vector>
 
 #include <maze/cell.hpp>
+#include <maze/cell_grid.hpp>
 #include <maze/distance.hpp>
+#include <maze/layout.hpp>
 #include <maze/maze.hpp>
+#include <maze/path.hpp>
 #include <maze/point.hpp>
 
 namespace maze::detail {
@@ -25,7 +28,8 @@ namespace maze::detail {
 }
 
 /// Returns true if \p container contains \p p. O(n) complexity.
-[[nodiscard]] auto contains(std::vector<Point> container, Point p) -> bool
+[[nodiscard]] inline auto contains(std::vector<Point> const& container,
+                                   Point p) -> bool
 {
     return std::find(std::cbegin(container), std::cend(container), p) !=
            std::cend(container);
@@ -35,14 +39,14 @@ namespace maze::detail {
 
 namespace maze {
 
-/// Prints representation of \p maze to \p os.
+/// Prints representation of \p maze, a Maze, Maze_view or Wall_maze, to
+/// \p os.
 /** Walls are 'X', Passages are ' '. */
-template <Distance Width, Distance Height>
-auto operator<<(std::ostream& os, Maze<Width, Height> const& maze)
-    -> std::ostream&
+template <Cell_grid G>
+auto operator<<(std::ostream& os, G const& maze) -> std::ostream&
 {
-    for (Distance y = 0; y < Height; ++y) {
-        for (Distance x = 0; x < Width; ++x) {
+    for (Distance y = 0; y < G::height; ++y) {
+        for (Distance x = 0; x < G::width; ++x) {
             os << detail::to_char(maze.get({x, y}));
         }
         os << '\n';
@@ -54,10 +58,11 @@ auto operator<<(std::ostream& os, Maze<Width, Height> const& maze)
 /** Walls are 'X', Passages are ' ', start is 'S', end is 'E', and solution is
  *  '.'. This is a relatively expensive function! Start is the front of the
  *  solution and end is the back of the solution. */
-template <Distance Width, Distance Height>
+template <Distance Width, Distance Height, typename... Policies>
 auto operator<<(
     std::ostream& os,
-    std::pair<Maze<Width, Height>, std::vector<Point>> const& maze_and_solution)
+    std::pair<Maze<Width, Height, Policies...>, std::vector<Point>> const&
+        maze_and_solution)
     -> std::ostream&
 {
     auto const& [maze, solution] = maze_and_solution;
@@ -78,5 +83,32 @@ auto operator<<(
     return os;
 }
 
+/// Prints representation of \p maze_and_solution to \p os.
+/** As the std::vector<Point> overload, but the Path is expanded to a cell
+ *  bitmask once, so this is linear in the size of the Maze. */
+template <Distance Width, Distance Height, typename... Policies>
+auto operator<<(std::ostream& os,
+                std::pair<Maze<Width, Height, Policies...>, Path> const&
+                    maze_and_solution) -> std::ostream&
+{
+    auto const& [maze, solution] = maze_and_solution;
+    assert(!solution.empty());
+    auto const mask = solution.template to_mask<Width, Height>();
+    for (Distance y = 0; y < Height; ++y) {
+        for (Distance x = 0; x < Width; ++x) {
+            if (solution.front() == Point{x, y})
+                os << 'S';
+            else if (solution.back() == Point{x, y})
+                os << 'E';
+            else if (detail::test_bit(mask, (std::size_t{y} * Width) + x))
+                os << '.';
+            else
+                os << detail::to_char(maze.get({x, y}));
+        }
+        os << '\n';
+    }
+    return os;
+}
+
 }  // namespace maze
 #endif  // MAZE_DISPLAY_HPP
@@ -5,6 +5,8 @@
 namespace maze {
 
 /// Type to represent a distance along any dimension of a Maze.
+/** Sides are at most 65535 cells, about 4.3 billion cells in all. The binary
+ *  and archive formats store sides in 16 bits too. */
 using Distance = std::uint16_t;
 
 }  // namespace maze
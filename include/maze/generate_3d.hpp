@@ -0,0 +1,180 @@
+#ifndef MAZE_GENERATE_3D_HPP
+#define MAZE_GENERATE_3D_HPP
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory_resource>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <maze/cell.hpp>
+#include <maze/distance.hpp>
+#include <maze/generate_kruskal.hpp>
+#include <maze/generate_prims.hpp>
+#include <maze/generate_recursive_backtracking.hpp>
+#include <maze/generator_pool.hpp>
+#include <maze/lattice.hpp>
+#include <maze/maze_3d.hpp>
+#include <maze/observer.hpp>
+#include <maze/random.hpp>
+#include <maze/utility.hpp>
+
+namespace maze {
+
+/// Scratch memory for the Maze_3d generators, keeps its capacity across
+/// calls.
+struct Generator_3d_workspace {
+    /// A visited room and the Directions it has left to try.
+    struct Frame {
+        Point_3d at;
+        std::array<Direction_3d, 6> directions;
+        std::size_t next = 0;
+    };
+
+    Generator_3d_workspace() = default;
+
+    /// Allocate all scratch memory from \p resource.
+    explicit Generator_3d_workspace(std::pmr::memory_resource* resource)
+        : stack(resource), edges(resource), parent(resource)
+    {}
+
+    /// Backtracking's stack.
+    std::pmr::vector<Frame> stack;
+    /// Prim's frontier, or Kruskal's shuffled Edges.
+    std::pmr::vector<Edge_3d> edges;
+    /// Kruskal's disjoint set forest, one entry per room.
+    std::pmr::vector<std::size_t> parent;
+};
+
+/// Overwrite \p m with a maze from the recursive backtracking technique.
+/** Passages run in all six Directions. All randomness is drawn from \p gen,
+ *  scratch memory from \p workspace. */
+template <Distance Width,
+          Distance Height,
+          Distance Depth,
+          typename Layout,
+          std::uniform_random_bit_generator Gen>
+void generate_recursive_backtracking_into(
+    Maze_3d<Width, Height, Depth, Layout>& m,
+    Generator_3d_workspace& workspace,
+    Gen& gen)
+{
+    detail::do_recursive_backtrack(m, workspace.stack, gen);
+}
+
+/// Overwrite \p m with a maze from a randomized Prim's MST algorithm.
+/** Passages run in all six Directions. All randomness is drawn from \p gen,
+ *  scratch memory from \p workspace. \p observer sees the "prims" phase and
+ *  the frontier size. */
+template <Distance Width,
+          Distance Height,
+          Distance Depth,
+          typename Layout,
+          std::uniform_random_bit_generator Gen,
+          Observer O = Null_observer>
+void generate_prims_into(Maze_3d<Width, Height, Depth, Layout>& m,
+                         Generator_3d_workspace& workspace,
+                         Gen& gen,
+                         O observer = {})
+{
+    auto const phase = detail::Phase_scope{observer, "prims"};
+    detail::do_prims(m, workspace.edges, gen, observer);
+}
+
+/// Overwrite \p m with a maze from a randomized Kruskal's MST algorithm.
+/** Passages run in all six Directions. All randomness is drawn from \p gen,
+ *  scratch memory from \p workspace. \p observer sees the "kruskal" phase,
+ *  Edges checked and merges. */
+template <Distance Width,
+          Distance Height,
+          Distance Depth,
+          typename Layout,
+          std::uniform_random_bit_generator Gen,
+          Observer O = Null_observer>
+void generate_kruskal_into(Maze_3d<Width, Height, Depth, Layout>& m,
+                           Generator_3d_workspace& workspace,
+                           Gen& gen,
+                           O observer = {})
+{
+    auto const phase = detail::Phase_scope{observer, "kruskal"};
+    detail::do_kruskal(m, workspace.edges, workspace.parent, gen, observer);
+}
+
+/// Overwrite \p m with a floor per even layer, each a 2D maze from generator
+/// \p id, joined by one stair between each pair of floors.
+/** Floors are generated in parallel on \p thread_count threads, floor f by
+ *  generate_into() with a std::mt19937_64 seeded from mix_seed(\p seed, f),
+ *  so the result depends only on \p seed. Stairs are placed at random rooms
+ *  from mix_seed(\p seed, floor count). A stair joins two perfect floors
+ *  without a loop, so the maze is perfect when every floor is: odd Width
+ *  and Height. Throws std::invalid_argument on an Unknown id or zero
+ *  threads, and rethrows the first exception from a thread. */
+template <Distance Width,
+          Distance Height,
+          Distance Depth,
+          typename Layout>
+void generate_layered_into(
+    Generator_id id,
+    Maze_3d<Width, Height, Depth, Layout>& m,
+    std::uint64_t seed,
+    std::size_t thread_count = detail::default_thread_count())
+{
+    if (id == Generator_id::Unknown)
+        throw std::invalid_argument{
+            "generate_layered_into: Unknown Generator_id."};
+    if (thread_count == 0)
+        throw std::invalid_argument{"generate_layered_into: zero threads."};
+
+    constexpr auto floors = (std::size_t{Depth} + 1) / 2;
+    auto next  = std::atomic<std::size_t>{0};
+    auto mutex = std::mutex{};  // Guards error.
+    auto error = std::exception_ptr{};
+
+    auto const work = [&] {
+        try {
+            auto workspace = Generator_workspace{};
+            auto gen       = std::mt19937_64{};
+            for (auto f = next++; f < floors; f = next++) {
+                gen.seed(detail::mix_seed(seed, f));
+                generate_into(id, m.layer(static_cast<Distance>(2 * f)),
+                              workspace, gen);
+            }
+        }
+        catch (...) {
+            auto const lock = std::lock_guard{mutex};
+            if (error == nullptr)
+                error = std::current_exception();
+            next.store(floors);
+        }
+    };
+
+    auto threads = std::vector<std::thread>{};
+    thread_count = std::min(thread_count, floors);
+    threads.reserve(thread_count - 1);
+    for (auto t = std::size_t{1}; t < thread_count; ++t)
+        threads.emplace_back(work);
+    work();
+    for (auto& thread : threads)
+        thread.join();
+    if (error != nullptr)
+        std::rethrow_exception(error);
+
+    auto gen = std::mt19937_64{detail::mix_seed(seed, floors)};
+    for (auto z = Distance{1}; z < Depth; z += 2) {
+        auto& stairs = m.layer(z);
+        stairs.fill(Cell::Wall);
+        if (z + 1 < Depth) {
+            auto const room = Lattice_3d<Width, Height, 1>::random_room(gen);
+            stairs.set({room.x, room.y}, Cell::Passage);
+        }
+    }
+}
+
+}  // namespace maze
+#endif  // MAZE_GENERATE_3D_HPP
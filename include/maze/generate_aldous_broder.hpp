@@ -1,20 +1,28 @@
 #ifndef MAZE_ALDOUS_BRODER_HPP
 #define MAZE_ALDOUS_BRODER_HPP
+#include <cstddef>
+#include <optional>
+#include <random>
 #include <stdexcept>
+#include <utility>
 
 #include <maze/cell.hpp>
 #include <maze/distance.hpp>
 #include <maze/maze.hpp>
+#include <maze/observer.hpp>
 #include <maze/point.hpp>
+#include <maze/stepper.hpp>
 #include <maze/utility.hpp>
 
 namespace maze::detail {
 
 /// Finds a random neighbor two spaces from \p point in a single direction.
-template <Distance Width, Distance Height>
-[[nodiscard]] auto random_neighbor(Point const p) -> Point
+template <Distance Width,
+          Distance Height,
+          std::uniform_random_bit_generator Gen>
+[[nodiscard]] auto random_neighbor(Point const p, Gen& gen) -> Point
 {
-    auto const directions = utility::shuffled_directions();
+    auto const directions = utility::shuffled_directions(gen);
     for (auto direction : directions) {
         auto const one = utility::next_point<Width, Height>(p, direction);
         if (one.has_value()) {
@@ -33,34 +41,140 @@ template <Distance Width, Distance Height>
     return utility::add(a, utility::half(utility::subtract(b, a)));
 }
 
+/// Position of an Aldous Broder random walk and the cells left to visit.
+struct Walk {
+    Point current;
+    std::size_t remaining;
+};
+
+/// Fill \p m with Walls and open a random start cell for a Walk.
+template <Distance Width,
+          Distance Height,
+          typename... Policies,
+          std::uniform_random_bit_generator Gen>
+auto aldous_broder_start(Maze<Width, Height, Policies...>& m, Gen& gen) -> Walk
+{
+    auto const start = utility::make_even<Width, Height>(
+        utility::random_point<Width, Height>(gen));
+    m.fill(Cell::Wall);
+    m.set(start, Cell::Passage);
+    auto const cells = std::size_t{utility::ceil(Width / 2.)} *
+                       std::size_t{utility::ceil(Height / 2.)};
+    return {start, cells - 1};
+}
+
+/// Walk randomly until an unvisited cell is found and carve to it.
+/** Returns std::nullopt once every cell has been visited. */
+template <Distance Width,
+          Distance Height,
+          typename... Policies,
+          std::uniform_random_bit_generator Gen,
+          Observer O = Null_observer>
+auto aldous_broder_step(Maze<Width, Height, Policies...>& m,
+                        Walk& walk,
+                        Gen& gen,
+                        O observer = {}) -> std::optional<Step>
+{
+    while (walk.remaining != 0) {
+        auto const from     = walk.current;
+        auto const neighbor = random_neighbor<Width, Height>(from, gen);
+        walk.current        = neighbor;
+        observer.count(Counter::Walk_steps, 1);
+        if (m.get(neighbor) == Cell::Wall) {
+            auto const between = middle(from, neighbor);
+            m.set(neighbor, Cell::Passage);
+            m.set(between, Cell::Passage);
+            --walk.remaining;
+            return make_step(between, neighbor, Cell::Passage);
+        }
+    }
+    return std::nullopt;
+}
+
 }  // namespace maze::detail
 
 namespace maze {
 
+/// Overwrite \p m with a maze from Aldous Broder Uniform Spanning Tree
+/// algorithm.
+/** All randomness is drawn from \p gen. \p observer sees the
+ *  "aldous_broder" phase and the random walk's steps. */
+template <Distance Width,
+          Distance Height,
+          typename... Policies,
+          std::uniform_random_bit_generator Gen,
+          Observer O = Null_observer>
+void generate_aldous_broder_into(Maze<Width, Height, Policies...>& m,
+                                 Gen& gen,
+                                 O observer = {})
+{
+    auto const phase = detail::Phase_scope{observer, "aldous_broder"};
+    auto walk        = detail::aldous_broder_start(m, gen);
+    while (detail::aldous_broder_step(m, walk, gen, observer).has_value()) {}
+}
+
+/// Overwrite \p m with a maze from Aldous Broder Uniform Spanning Tree
+/// algorithm. Needs no scratch memory.
+template <Distance Width, Distance Height, typename... Policies>
+void generate_aldous_broder_into(Maze<Width, Height, Policies...>& m)
+{
+    generate_aldous_broder_into(m, utility::random_gen);
+}
+
 /// Generate a maze with Aldous Broder Uniform Spanning Tree algorithm.
 /** This is a very inefficient maze generation algorithm. But it creates nice
  *  mazes. */
-template <Distance Width, Distance Height>
-[[nodiscard]] auto generate_aldous_broder() -> Maze<Width, Height>
+template <Distance Width, Distance Height, typename Layout = Row_major>
+[[nodiscard]] auto generate_aldous_broder() -> Maze<Width, Height, Layout>
 {
-    auto current = utility::make_even<Width, Height>(
-        utility::random_point<Width, Height>());
-    auto m = Maze<Width, Height>{Cell::Wall};
-    m.set(current, Cell::Passage);
-    auto count = (utility::ceil(Width / 2.) * utility::ceil(Height / 2.)) - 1;
-
-    while (count != 0) {
-        auto const neighbor = detail::random_neighbor<Width, Height>(current);
-        if (m.get(neighbor) == Cell::Wall) {
-            m.set(neighbor, Cell::Passage);
-            m.set(detail::middle(current, neighbor), Cell::Passage);
-            --count;
+    auto m = Maze<Width, Height, Layout>{Cell::Wall};
+    generate_aldous_broder_into(m, utility::random_gen);
+    return m;
+}
+
+/// Aldous Broder Uniform Spanning Tree algorithm as a Stepper, one carved
+/// passage per step.
+/** The first step is the start cell. Steps late in the walk can take long to
+ *  find an unvisited cell. */
+template <Distance Width,
+          Distance Height,
+          typename Layout,
+          typename Storage,
+          std::uniform_random_bit_generator Gen = std::mt19937>
+class Aldous_broder_stepper {
+   public:
+    /// Overwrite \p m with Walls and prepare to carve it.
+    explicit Aldous_broder_stepper(Maze<Width, Height, Layout, Storage>& m,
+                                   Gen gen = Gen{std::random_device{}()})
+        : maze_{m},
+          gen_{std::move(gen)},
+          walk_{detail::aldous_broder_start(maze_, gen_)},
+          start_{walk_.current}
+    {}
+
+   public:
+    /// Carve the next passage, returns std::nullopt once the maze is complete.
+    auto step() -> std::optional<Step>
+    {
+        if (start_.has_value()) {
+            auto const start = *std::exchange(start_, std::nullopt);
+            return detail::make_step(start, start, Cell::Passage);
         }
-        current = neighbor;
+        auto const result = detail::aldous_broder_step(maze_, walk_, gen_);
+        done_             = !result.has_value();
+        return result;
     }
 
-    return m;
-}
+    /// Return true once step() has returned std::nullopt.
+    [[nodiscard]] auto done() const -> bool { return done_; }
+
+   private:
+    Maze<Width, Height, Layout, Storage>& maze_;
+    Gen gen_;
+    detail::Walk walk_;
+    std::optional<Point> start_;
+    bool done_ = false;
+};
 
 }  // namespace maze
 #endif  // MAZE_ALDOUS_BRODER_HPP
@@ -0,0 +1,347 @@
+#ifndef MAZE_GENERATE_BIASED_HPP
+#define MAZE_GENERATE_BIASED_HPP
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <numeric>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <maze/bias.hpp>
+#include <maze/cell.hpp>
+#include <maze/distance.hpp>
+#include <maze/edge.hpp>
+#include <maze/generate_kruskal.hpp>
+#include <maze/generate_prims.hpp>
+#include <maze/generate_recursive_backtracking.hpp>
+#include <maze/lattice.hpp>
+#include <maze/maze.hpp>
+#include <maze/observer.hpp>
+#include <maze/point.hpp>
+#include <maze/random.hpp>
+#include <maze/utility.hpp>
+
+namespace maze::detail {
+
+/// Picks a class of Edges with probability proportional to its Edge count
+/// times its weight.
+/** A Fenwick tree of the per class totals, so changing a count and drawing a
+ *  class are both O(log classes), however many Edges there are. Weights are
+ *  scaled to integers, keeping the totals exact as Edges come and go. */
+class Class_sampler {
+   public:
+    Class_sampler() = default;
+
+    /// Allocate all storage from \p resource.
+    explicit Class_sampler(std::pmr::memory_resource* resource)
+        : weights_(resource), tree_(resource)
+    {}
+
+   public:
+    /// Start over with a class per weight in \p weights, each of no Edges.
+    /** Weights must be positive. */
+    void reset(std::span<double const> weights)
+    {
+        // Leaves room for 2^40 Edges of the heaviest class.
+        constexpr auto scale = double{1 << 24};
+        auto const heaviest  = std::ranges::max(weights);
+        weights_.resize(weights.size());
+        for (auto k = std::size_t{0}; k < weights.size(); ++k) {
+            auto const w = std::llround(weights[k] / heaviest * scale);
+            weights_[k]  = std::max<std::uint64_t>(1, w);
+        }
+        tree_.assign(weights.size() + 1, 0);
+    }
+
+    /// Add \p count Edges to class \p k.
+    void add(std::size_t k, std::size_t count)
+    {
+        update(k, count * weights_[k], true);
+    }
+
+    /// Remove one Edge from class \p k.
+    void remove(std::size_t k) { update(k, weights_[k], false); }
+
+    /// Return a class drawn from \p gen by count times weight.
+    /** There must be an Edge in some class. */
+    template <std::uniform_random_bit_generator Gen>
+    [[nodiscard]] auto sample(Gen& gen) const -> std::size_t
+    {
+        auto target = utility::random_index(total() - 1, gen);
+        auto at     = std::size_t{0};
+        for (auto step = std::bit_floor(tree_.size() - 1); step != 0;
+             step >>= 1) {
+            if (at + step < tree_.size() && tree_[at + step] <= target) {
+                at += step;
+                target -= tree_[at];
+            }
+        }
+        return at;
+    }
+
+   private:
+    std::pmr::vector<std::uint64_t> weights_;
+    std::pmr::vector<std::uint64_t> tree_;  // 1-based Fenwick tree.
+
+   private:
+    void update(std::size_t k, std::uint64_t amount, bool add)
+    {
+        for (auto i = k + 1; i < tree_.size(); i += i & (~i + 1))
+            tree_[i] = add ? tree_[i] + amount : tree_[i] - amount;
+    }
+
+    [[nodiscard]] auto total() const -> std::uint64_t
+    {
+        auto sum = std::uint64_t{0};
+        for (auto i = tree_.size() - 1; i != 0; i &= i - 1)
+            sum += tree_[i];
+        return sum;
+    }
+};
+
+}  // namespace maze::detail
+
+namespace maze {
+
+/// Scratch memory for the biased generators, keeps its capacity across calls.
+struct Biased_workspace {
+    Biased_workspace() = default;
+
+    /// Allocate all scratch memory from \p resource.
+    explicit Biased_workspace(std::pmr::memory_resource* resource)
+        : stack(resource), classes(resource), weights(resource),
+          sampler(resource), parent(resource)
+    {}
+
+    /// Backtracking's stack.
+    Backtracking_workspace::Stack stack;
+    /// Prim's frontier or Kruskal's Edges, a list per weight class.
+    std::pmr::vector<std::pmr::vector<Edge>> classes;
+    /// Weight of an Edge of each class.
+    std::pmr::vector<double> weights;
+    /// Draws the class of the next Edge.
+    detail::Class_sampler sampler;
+    /// Kruskal's disjoint set forest.
+    std::pmr::vector<std::size_t> parent;
+};
+
+}  // namespace maze
+
+namespace maze::detail {
+
+/// Orders the Directions tried from each cell by a Direction_bias.
+struct Biased_order {
+    Direction_bias const& bias;
+
+    template <std::uniform_random_bit_generator Gen>
+    auto operator()(Point at, Gen& gen) const -> std::array<Direction, 4>
+    {
+        return bias.shuffled_directions(at, gen);
+    }
+};
+
+/// Remove and return an Edge of \p workspace's classes drawn by weight from
+/// \p gen.
+/** Each Edge is drawn with probability proportional to the weight of its
+ *  class: the sampler picks a class by its total weight in O(log classes),
+ *  then a uniform Edge of it. The classes must not all be empty. */
+template <std::uniform_random_bit_generator Gen>
+[[nodiscard]] auto pop_weighted(Biased_workspace& workspace, Gen& gen) -> Edge
+{
+    auto const k = workspace.sampler.sample(gen);
+    auto& list   = workspace.classes[k];
+    workspace.sampler.remove(k);
+    return pop(list, utility::random_index(list.size() - 1, gen));
+}
+
+/// Reset \p workspace to as many empty classes as it has weights.
+inline void reset_classes(Biased_workspace& workspace)
+{
+    workspace.classes.resize(workspace.weights.size());
+    for (auto& list : workspace.classes)
+        list.clear();
+    workspace.sampler.reset(workspace.weights);
+}
+
+/// Randomized Prim's Algorithm over \p m, frontier Edges drawn by \p bias.
+/** An Edge's class is the region and Direction it leaves its room by. */
+template <Distance Width,
+          Distance Height,
+          typename... Policies,
+          std::uniform_random_bit_generator Gen,
+          Observer O = Null_observer>
+void do_biased_prims(Maze<Width, Height, Policies...>& m,
+                     Direction_bias const& bias,
+                     Biased_workspace& workspace,
+                     Gen& gen,
+                     O observer = {})
+{
+    auto& classes = workspace.classes;
+    auto& weights = workspace.weights;
+    weights.resize(bias.region_count() * 4);
+    for (auto r = std::size_t{0}; r < bias.region_count(); ++r) {
+        for (auto d = std::size_t{0}; d < 4; ++d)
+            weights[(r * 4) + d] = bias.weights(r)[d];
+    }
+    reset_classes(workspace);
+
+    using Lattice        = Lattice_2d<Width, Height>;
+    auto size           = std::size_t{0};
+    auto const add_from = [&](Point at) {
+        auto const region = bias.region(at) * 4;
+        for (auto const d : Lattice::directions) {
+            auto const next = room_neighbor<Lattice>(at, d);
+            if (!next.has_value())
+                continue;
+            auto const k = region + static_cast<std::size_t>(d);
+            classes[k].push_back({at, *next});
+            workspace.sampler.add(k, 1);
+            ++size;
+        }
+    };
+
+    auto const start = Lattice::random_room(gen);
+    m.fill(Cell::Wall);
+    m.set(start, Cell::Passage);
+    add_from(start);
+    while (size != 0) {
+        auto const edge = pop_weighted(workspace, gen);
+        --size;
+        if (m.get(edge.b) == Cell::Wall) {
+            open_edge(m, edge);
+            add_from(edge.b);
+            observer.gauge(Counter::Frontier_size, size);
+        }
+    }
+}
+
+/// Randomized Kruskal's MST over \p m, Edges taken in an order drawn by \p
+/// bias.
+/** An Edge's class is the region of its first room and its axis, weighted
+ *  by the mean weight of the two Directions along it. */
+template <Distance Width,
+          Distance Height,
+          typename... Policies,
+          std::uniform_random_bit_generator Gen,
+          Observer O = Null_observer>
+void do_biased_kruskal(Maze<Width, Height, Policies...>& m,
+                       Direction_bias const& bias,
+                       Biased_workspace& workspace,
+                       Gen& gen,
+                       O observer = {})
+{
+    using Lattice = Lattice_2d<Width, Height>;
+
+    auto& classes = workspace.classes;
+    auto& weights = workspace.weights;
+    auto& parent  = workspace.parent;
+    weights.resize(bias.region_count() * 2);
+    for (auto r = std::size_t{0}; r < bias.region_count(); ++r) {
+        auto const& w      = bias.weights(r);
+        weights[r * 2]       = (w[2] + w[3]) / 2;  // East and West.
+        weights[(r * 2) + 1] = (w[0] + w[1]) / 2;  // North and South.
+    }
+    reset_classes(workspace);
+
+    auto size = std::size_t{0};
+    Lattice::for_each_room([&](Point at) {
+        // Class region * 2 is East-West, region * 2 + 1 North-South.
+        auto k = bias.region(at) * 2;
+        for (auto const d : Lattice::forward_directions) {
+            if (auto const next = room_neighbor<Lattice>(at, d))
+                classes[k].push_back({at, *next});
+            ++k;
+        }
+    });
+    for (auto k = std::size_t{0}; k < classes.size(); ++k) {
+        workspace.sampler.add(k, classes[k].size());
+        size += classes[k].size();
+    }
+
+    parent.resize(Lattice::room_count);
+    std::iota(std::begin(parent), std::end(parent), std::size_t{0});
+
+    m.fill(Cell::Wall);
+    for (; size != 0; --size) {
+        auto const edge   = pop_weighted(workspace, gen);
+        auto const root_a = find_root(parent, Lattice::room_index(edge.a));
+        auto const root_b = find_root(parent, Lattice::room_index(edge.b));
+        observer.count(Counter::Edges_checked, 1);
+        if (root_a != root_b) {
+            parent[root_b] = root_a;
+            observer.count(Counter::Merges, 1);
+            m.set(edge.a, Cell::Passage);
+            open_edge(m, edge);
+        }
+    }
+}
+
+}  // namespace maze::detail
+
+namespace maze {
+
+/// Overwrite \p m with a maze from recursive backtracking, trying the
+/// Directions from each cell in an order drawn by \p bias.
+/** A Direction with a high weight tends to be tried first, so corridors run
+ *  along it. Each order is a single O(1) draw. All randomness is drawn from
+ *  \p gen, scratch memory from \p workspace. */
+template <Distance Width,
+          Distance Height,
+          typename... Policies,
+          std::uniform_random_bit_generator Gen>
+void generate_biased_backtracking_into(Maze<Width, Height, Policies...>& m,
+                                       Direction_bias const& bias,
+                                       Biased_workspace& workspace,
+                                       Gen& gen)
+{
+    detail::do_recursive_backtrack(m, workspace.stack, gen,
+                                   detail::Biased_order{bias});
+}
+
+/// Overwrite \p m with a maze from a randomized Prim's MST algorithm, each
+/// frontier Edge drawn with probability proportional to its weight in \p
+/// bias.
+/** All randomness is drawn from \p gen, scratch memory from \p workspace.
+ *  \p observer sees the "prims" phase and the frontier size. */
+template <Distance Width,
+          Distance Height,
+          typename... Policies,
+          std::uniform_random_bit_generator Gen,
+          Observer O = Null_observer>
+void generate_biased_prims_into(Maze<Width, Height, Policies...>& m,
+                                Direction_bias const& bias,
+                                Biased_workspace& workspace,
+                                Gen& gen,
+                                O observer = {})
+{
+    auto const phase = detail::Phase_scope{observer, "prims"};
+    detail::do_biased_prims(m, bias, workspace, gen, observer);
+}
+
+/// Overwrite \p m with a maze from a randomized Kruskal's MST algorithm,
+/// taking Edges in an order drawn by their weights in \p bias.
+/** Horizontal Edges weighted above vertical ones join first, so long
+ *  horizontal corridors form. All randomness is drawn from \p gen, scratch
+ *  memory from \p workspace. \p observer sees the "kruskal" phase, Edges
+ *  checked and merges. */
+template <Distance Width,
+          Distance Height,
+          typename... Policies,
+          std::uniform_random_bit_generator Gen,
+          Observer O = Null_observer>
+void generate_biased_kruskal_into(Maze<Width, Height, Policies...>& m,
+                                  Direction_bias const& bias,
+                                  Biased_workspace& workspace,
+                                  Gen& gen,
+                                  O observer = {})
+{
+    auto const phase = detail::Phase_scope{observer, "kruskal"};
+    detail::do_biased_kruskal(m, bias, workspace, gen, observer);
+}
+
+}  // namespace maze
+#endif  // MAZE_GENERATE_BIASED_HPP
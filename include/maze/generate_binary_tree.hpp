@@ -0,0 +1,124 @@
+#ifndef MAZE_GENERATE_BINARY_TREE_HPP
+#define MAZE_GENERATE_BINARY_TREE_HPP
+#include <array>
+#include <cstddef>
+#include <random>
+#include <stop_token>
+
+#include <maze/cell.hpp>
+#include <maze/distance.hpp>
+#include <maze/layout.hpp>
+#include <maze/maze.hpp>
+#include <maze/random.hpp>
+#include <maze/utility.hpp>
+
+namespace maze::detail {
+
+/// Bit x is set for every even x, the room columns of a Maze row.
+inline constexpr auto even_bits = Word{0x5555'5555'5555'5555};
+
+/// One row of Cell bits, bit x is Cell x.
+template <Distance Width>
+using Row_bits = std::array<Word, (Width + word_bits - 1) / word_bits>;
+
+/// Return the room columns of a row: every even x below Width.
+template <Distance Width>
+[[nodiscard]] constexpr auto room_bits() -> Row_bits<Width>
+{
+    auto result = Row_bits<Width>{};
+    for (auto i = std::size_t{0}; i < result.size(); ++i) {
+        auto const remaining = std::size_t{Width} - (i * word_bits);
+        result[i] = even_bits & (remaining < word_bits ? low_bits(remaining)
+                                                       : ~Word{0});
+    }
+    return result;
+}
+
+/// Return the rooms of a row that have a room two cells to their East.
+template <Distance Width>
+[[nodiscard]] constexpr auto east_bits() -> Row_bits<Width>
+{
+    auto result = Row_bits<Width>{};
+    if constexpr (Width > 2) {
+        constexpr auto rooms = room_bits<Width - 2>();
+        for (auto i = std::size_t{0}; i < rooms.size(); ++i)
+            result[i] = rooms[i];
+    }
+    return result;
+}
+
+}  // namespace maze::detail
+
+namespace maze {
+
+/// Overwrite \p m with a maze from the Binary Tree algorithm, checking
+/// \p stop before each row of rooms.
+/** Every room carves North or East, decided by one random bit per room, so a
+ *  whole row is carved with a few Word operations per 64 cells. The top row
+ *  and right column become long straight corridors. Maze size should be odd
+ *  to completely fill Maze. Returns false, leaving \p m part carved, if a
+ *  stop was requested first. */
+template <Distance Width,
+          Distance Height,
+          typename... Policies,
+          std::uniform_random_bit_generator Gen>
+auto generate_binary_tree_into(Maze<Width, Height, Policies...>& m,
+                               Gen& gen,
+                               std::stop_token stop) -> bool
+{
+    constexpr auto rooms   = detail::room_bits<Width>();
+    constexpr auto can_go_east = detail::east_bits<Width>();
+
+    auto room_row  = detail::Row_bits<Width>{};
+    auto north_row = detail::Row_bits<Width>{};
+    m.fill(Cell::Wall);
+    for (auto y = std::size_t{0}; y < Height; y += 2) {
+        if (stop.stop_requested())
+            return false;
+        for (auto i = std::size_t{0}; i < rooms.size(); ++i) {
+            // The top row can't go North, so it always goes East.
+            auto const east = (y == 0)
+                                  ? can_go_east[i]
+                                  : detail::random_word(gen) & can_go_east[i];
+            room_row[i]  = rooms[i] | (east << 1);
+            north_row[i] = rooms[i] & ~east;
+        }
+        m.write_row(static_cast<Distance>(y), room_row);
+        if (y != 0)
+            m.write_row(static_cast<Distance>(y - 1), north_row);
+    }
+    return true;
+}
+
+/// Overwrite \p m with a maze from the Binary Tree algorithm.
+/** Maze size should be odd to completely fill Maze. All randomness is drawn
+ *  from \p gen. */
+template <Distance Width,
+          Distance Height,
+          typename... Policies,
+          std::uniform_random_bit_generator Gen>
+void generate_binary_tree_into(Maze<Width, Height, Policies...>& m, Gen& gen)
+{
+    generate_binary_tree_into(m, gen, std::stop_token{});
+}
+
+/// Overwrite \p m with a maze from the Binary Tree algorithm.
+/** Maze size should be odd to completely fill Maze. */
+template <Distance Width, Distance Height, typename... Policies>
+void generate_binary_tree_into(Maze<Width, Height, Policies...>& m)
+{
+    generate_binary_tree_into(m, utility::random_gen);
+}
+
+/// Generate a maze with the Binary Tree algorithm.
+/** Maze size should be odd to completely fill Maze. */
+template <Distance Width, Distance Height, typename Layout = Row_major>
+[[nodiscard]] auto generate_binary_tree() -> Maze<Width, Height, Layout>
+{
+    auto m = Maze<Width, Height, Layout>{Cell::Wall};
+    generate_binary_tree_into(m);
+    return m;
+}
+
+}  // namespace maze
+#endif  // MAZE_GENERATE_BINARY_TREE_HPP
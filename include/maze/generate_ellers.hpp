@@ -0,0 +1,244 @@
+#ifndef MAZE_GENERATE_ELLERS_HPP
+#define MAZE_GENERATE_ELLERS_HPP
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <memory_resource>
+#include <numeric>
+#include <random>
+#include <stop_token>
+#include <vector>
+
+#include <maze/cell.hpp>
+#include <maze/distance.hpp>
+#include <maze/maze.hpp>
+#include <maze/point.hpp>
+#include <maze/storage.hpp>
+#include <maze/utility.hpp>
+
+namespace maze::detail {
+
+/// Set bookkeeping for a single row of cells in Eller's algorithm.
+/** Set ids are renumbered every row so all storage stays O(columns). */
+class Ellers_row {
+   public:
+    static constexpr auto none = std::numeric_limits<std::size_t>::max();
+
+   public:
+    Ellers_row() = default;
+
+    /// Allocate all storage from \p resource.
+    explicit Ellers_row(std::pmr::memory_resource* resource)
+        : set_of_(resource),
+          next_set_of_(resource),
+          parent_(resource),
+          relabel_(resource),
+          has_down_(resource),
+          down_candidate_(resource),
+          member_count_(resource)
+    {}
+
+   public:
+    /// Start a new maze of \p columns, reusing existing capacity.
+    void reset(std::size_t columns)
+    {
+        set_of_.assign(columns, none);
+        next_set_of_.assign(columns, none);
+        parent_.resize(columns);
+        relabel_.assign(columns, none);
+        has_down_.assign(columns, false);
+        down_candidate_.assign(columns, none);
+        member_count_.assign(columns, 0);
+    }
+
+    /// Give every cell without a set its own set, compacting set ids.
+    void begin_row()
+    {
+        auto next_id = std::size_t{0};
+        for (auto& set : set_of_) {
+            if (set != none) {
+                if (relabel_[set] == none)
+                    relabel_[set] = next_id++;
+                set = relabel_[set];
+            }
+        }
+        for (auto& set : set_of_) {
+            if (set == none)
+                set = next_id++;
+        }
+        std::ranges::fill(relabel_, none);
+        std::iota(std::begin(parent_), std::end(parent_), std::size_t{0});
+    }
+
+    /// Return the root set id of \p column.
+    [[nodiscard]] auto root(std::size_t column) -> std::size_t
+    {
+        auto id = set_of_[column];
+        while (parent_[id] != id) {
+            parent_[id] = parent_[parent_[id]];
+            id          = parent_[id];
+        }
+        return id;
+    }
+
+    /// Merge the sets of \p a and \p b, returns false if already the same.
+    auto join(std::size_t a, std::size_t b) -> bool
+    {
+        auto const root_a = root(a);
+        auto const root_b = root(b);
+        if (root_a == root_b)
+            return false;
+        parent_[root_b] = root_a;
+        return true;
+    }
+
+    /// Pick downward passages, each set gets at least one. Calls \p carve
+    /// with each chosen column.
+    template <std::uniform_random_bit_generator Gen, typename Carve>
+    void choose_down(Gen& gen, Carve&& carve)
+    {
+        auto const columns = set_of_.size();
+        for (auto c = std::size_t{0}; c < columns; ++c) {
+            auto const set = root(c);
+            // Reservoir sample a fallback column for every set.
+            if (utility::random_index(member_count_[set]++, gen) == 0)
+                down_candidate_[set] = c;
+            if (utility::random_index(1, gen) == 0) {
+                has_down_[set]  = true;
+                next_set_of_[c] = set;
+                carve(c);
+            }
+        }
+        for (auto c = std::size_t{0}; c < columns; ++c) {
+            auto const set = root(c);
+            if (!has_down_[set]) {
+                has_down_[set]                     = true;
+                next_set_of_[down_candidate_[set]] = set;
+                carve(down_candidate_[set]);
+            }
+        }
+        set_of_.swap(next_set_of_);
+        std::ranges::fill(next_set_of_, none);
+        std::fill(std::begin(has_down_), std::end(has_down_), false);
+        std::ranges::fill(member_count_, std::size_t{0});
+    }
+
+   private:
+    std::pmr::vector<std::size_t> set_of_;
+    std::pmr::vector<std::size_t> next_set_of_;
+    std::pmr::vector<std::size_t> parent_;
+    std::pmr::vector<std::size_t> relabel_;
+    std::pmr::vector<bool> has_down_;
+    std::pmr::vector<std::size_t> down_candidate_;
+    std::pmr::vector<std::size_t> member_count_;
+};
+
+}  // namespace maze::detail
+
+namespace maze {
+
+/// Scratch memory for generate_ellers_into, keeps its capacity across calls.
+struct Ellers_workspace {
+    Ellers_workspace() = default;
+
+    /// Allocate all scratch memory from \p resource.
+    explicit Ellers_workspace(std::pmr::memory_resource* resource)
+        : row(resource)
+    {}
+
+    detail::Ellers_row row;
+};
+
+/// Overwrite \p m with a maze from Eller's algorithm, checking \p stop
+/// before each row of rooms.
+/** Builds the maze a row at a time with O(Width) extra memory, touching only
+ *  the current and next row of \p m. Suited to Mapped_storage Mazes that are
+ *  larger than memory. Maze size should be odd to completely fill Maze.
+ *  Returns false, leaving \p m part carved, if a stop was requested first. */
+template <Distance Width,
+          Distance Height,
+          typename... Policies,
+          std::uniform_random_bit_generator Gen>
+auto generate_ellers_into(Maze<Width, Height, Policies...>& m,
+                          Ellers_workspace& workspace,
+                          Gen& gen,
+                          std::stop_token stop) -> bool
+{
+    constexpr auto columns = (std::size_t{Width} + 1) / 2;
+    constexpr auto rows    = (std::size_t{Height} + 1) / 2;
+
+    m.fill(Cell::Wall);
+    auto& state = workspace.row;
+    state.reset(columns);
+    for (auto r = std::size_t{0}; r < rows; ++r) {
+        if (stop.stop_requested())
+            return false;
+        auto const y        = static_cast<Distance>(r * 2);
+        auto const last_row = (r + 1 == rows);
+        state.begin_row();
+        for (auto c = std::size_t{0}; c < columns; ++c)
+            m.set({static_cast<Distance>(c * 2), y}, Cell::Passage);
+
+        for (auto c = std::size_t{0}; c + 1 < columns; ++c) {
+            if ((last_row || utility::random_index(1, gen) == 0) &&
+                state.join(c, c + 1)) {
+                m.set({static_cast<Distance>((c * 2) + 1), y}, Cell::Passage);
+            }
+        }
+
+        if (!last_row) {
+            state.choose_down(gen, [&](std::size_t c) {
+                m.set({static_cast<Distance>(c * 2), (Distance)(y + 1)},
+                      Cell::Passage);
+            });
+        }
+    }
+    return true;
+}
+
+/// Overwrite \p m with a maze from Eller's algorithm.
+/** Maze size should be odd to completely fill Maze. All randomness is drawn
+ *  from \p gen, scratch memory from \p workspace. */
+template <Distance Width,
+          Distance Height,
+          typename... Policies,
+          std::uniform_random_bit_generator Gen>
+void generate_ellers_into(Maze<Width, Height, Policies...>& m,
+                          Ellers_workspace& workspace,
+                          Gen& gen)
+{
+    generate_ellers_into(m, workspace, gen, std::stop_token{});
+}
+
+/// Overwrite \p m with a maze from Eller's algorithm.
+/** Scratch memory is taken from \p workspace. */
+template <Distance Width, Distance Height, typename... Policies>
+void generate_ellers_into(Maze<Width, Height, Policies...>& m,
+                          Ellers_workspace& workspace)
+{
+    generate_ellers_into(m, workspace, utility::random_gen);
+}
+
+/// Overwrite \p m with a maze from Eller's algorithm.
+/** Maze size should be odd to completely fill Maze. The scratch memory of a
+ *  Mapped_storage Maze is file mapped beside it. */
+template <Distance Width, Distance Height, typename... Policies>
+void generate_ellers_into(Maze<Width, Height, Policies...>& m)
+{
+    auto scratch   = detail::Scratch_memory{m};
+    auto workspace = Ellers_workspace{scratch.resource()};
+    generate_ellers_into(m, workspace, utility::random_gen);
+}
+
+/// Generate a maze with Eller's algorithm.
+/** Maze size should be odd to completely fill Maze. */
+template <Distance Width, Distance Height, typename Layout = Row_major>
+[[nodiscard]] auto generate_ellers() -> Maze<Width, Height, Layout>
+{
+    auto m = Maze<Width, Height, Layout>{Cell::Wall};
+    generate_ellers_into(m);
+    return m;
+}
+
+}  // namespace maze
+#endif  // MAZE_GENERATE_ELLERS_HPP
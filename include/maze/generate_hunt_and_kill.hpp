@@ -0,0 +1,320 @@
+#ifndef MAZE_GENERATE_HUNT_AND_KILL_HPP
+#define MAZE_GENERATE_HUNT_AND_KILL_HPP
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+#include <random>
+#include <span>
+#include <stop_token>
+#include <utility>
+#include <vector>
+
+#include <maze/cell.hpp>
+#include <maze/direction.hpp>
+#include <maze/distance.hpp>
+#include <maze/layout.hpp>
+#include <maze/maze.hpp>
+#include <maze/observer.hpp>
+#include <maze/point.hpp>
+#include <maze/random.hpp>
+#include <maze/utility.hpp>
+
+namespace maze {
+
+/// Scratch memory for generate_hunt_and_kill_into.
+/** One bit per room, a quarter of the Maze's own bits. Keeps its capacity
+ *  across calls. */
+struct Hunt_and_kill_workspace {
+    Hunt_and_kill_workspace() = default;
+
+    /// Allocate all scratch memory from \p resource.
+    explicit Hunt_and_kill_workspace(std::pmr::memory_resource* resource)
+        : visited(resource)
+    {}
+
+    std::pmr::vector<Word> visited;
+};
+
+}  // namespace maze
+
+namespace maze::detail {
+
+/// Rooms of a Width x Height Maze, at every even coordinate.
+/** A room mask stores one bit per room, row by row, each row padded to whole
+ *  Words. */
+template <Distance Width, Distance Height>
+struct Room_grid {
+    static constexpr auto columns = static_cast<Distance>((Width + 1) / 2);
+    static constexpr auto rows    = static_cast<Distance>((Height + 1) / 2);
+
+    /// Words per row of a room mask.
+    static constexpr auto stride = (columns + word_bits - 1) / word_bits;
+
+    /// Words in a room mask.
+    static constexpr auto word_count = stride * rows;
+
+    /// Return the room bits of Word \p i of a mask row, the rest is padding.
+    [[nodiscard]] static constexpr auto valid(std::size_t i) -> Word
+    {
+        return i + 1 == stride ? low_bits(columns - (i * word_bits))
+                               : ~Word{0};
+    }
+
+    /// Return the bit index of \p room in a room mask.
+    [[nodiscard]] static constexpr auto index(Point room) -> std::size_t
+    {
+        return (room.y * stride * word_bits) + room.x;
+    }
+};
+
+/// Position of a hunt through a room mask, it only moves forward.
+struct Hunt_cursor {
+    std::size_t row  = 0;
+    std::size_t word = 0;
+    /// Topmost row holding a visited room, no hunt looks above the next row.
+    std::size_t top = 0;
+};
+
+/// Open \p room and the wall between it and its neighbor in Direction \p d.
+template <Distance Width, Distance Height, typename... Policies>
+constexpr void carve_room(Maze<Width, Height, Policies...>& maze,
+                          std::span<Word> visited,
+                          Point room,
+                          Direction d)
+{
+    using Grid      = Room_grid<Width, Height>;
+    auto const cell = utility::times_two(room);
+    maze.set(cell, Cell::Passage);
+    maze.set(utility::step(cell, d), Cell::Passage);
+    assign_bit(visited, Grid::index(room), true);
+}
+
+/// Return the neighbors of \p room whose visited bit equals \p visited_bit.
+template <Distance Width, Distance Height>
+[[nodiscard]] constexpr auto room_neighbors(std::span<Word const> visited,
+                                            Point room,
+                                            bool visited_bit)
+    -> std::pair<std::array<Direction, 4>, std::size_t>
+{
+    using Grid   = Room_grid<Width, Height>;
+    auto result  = std::array<Direction, 4>{};
+    auto count   = std::size_t{0};
+    for (auto const d : utility::directions) {
+        auto const next =
+            utility::next_point<Grid::columns, Grid::rows>(room, d);
+        if (next && test_bit(visited, Grid::index(*next)) == visited_bit)
+            result[count++] = d;
+    }
+    return {result, count};
+}
+
+/// Carve from \p room to a random unvisited neighbor, which is returned.
+/** Returns std::nullopt if every neighbor is visited, the walk is over. */
+template <Distance Width,
+          Distance Height,
+          typename... Policies,
+          std::uniform_random_bit_generator Gen>
+constexpr auto kill_step(Maze<Width, Height, Policies...>& maze,
+                         std::span<Word> visited,
+                         Point room,
+                         Gen& gen) -> std::optional<Point>
+{
+    auto const [options, count] =
+        room_neighbors<Width, Height>(visited, room, false);
+    if (count == 0)
+        return std::nullopt;
+    auto const d    = options[uniform_to(gen, count - 1)];
+    auto const next = utility::step(room, d);
+    carve_room(maze, visited, next, utility::opposite(d));
+    return next;
+}
+
+/// Return the first unvisited room next to a visited room, in row order.
+/** Scans whole Words: the candidates of a Word are its unvisited rooms masked
+ *  by the visited rows above and below and the row shifted by one room each
+ *  way. \p cursor skips past fully visited Words and is never moved back.
+ *  The scan starts at the cursor or the row above cursor.top, whichever is
+ *  further down. That row always holds a candidate, so a hunt scans at most
+ *  one row past the skipped Words. \p observer counts the Words scanned. */
+template <Distance Width, Distance Height, Observer O = Null_observer>
+[[nodiscard]] constexpr auto hunt(std::span<Word const> visited,
+                                  Hunt_cursor& cursor,
+                                  O observer = {}) -> std::optional<Point>
+{
+    using Grid        = Room_grid<Width, Height>;
+    auto const row_at = [&](std::size_t y) {
+        return visited.subspan(y * Grid::stride, Grid::stride);
+    };
+
+    auto scanned = std::size_t{0};
+    for (; cursor.row < Grid::rows; ++cursor.row, cursor.word = 0) {
+        auto const row = row_at(cursor.row);
+        while (cursor.word < Grid::stride &&
+               row[cursor.word] == Grid::valid(cursor.word)) {
+            ++cursor.word;
+            ++scanned;
+        }
+        if (cursor.word != Grid::stride)
+            break;
+    }
+
+    auto const above = (cursor.top == 0) ? std::size_t{0} : cursor.top - 1;
+    auto const start = std::max(cursor.row, above);
+    auto found       = std::optional<Point>{};
+    for (auto y = start; y < Grid::rows && !found; ++y) {
+        auto const row   = row_at(y);
+        auto const first = (y == cursor.row) ? cursor.word : std::size_t{0};
+        for (auto i = first; i < Grid::stride; ++i) {
+            ++scanned;
+            auto const unvisited = ~row[i] & Grid::valid(i);
+            if (unvisited == 0)
+                continue;
+            auto near = (row[i] << 1) | (row[i] >> 1);
+            if (i != 0)
+                near |= row[i - 1] >> (word_bits - 1);
+            if (i + 1 != Grid::stride)
+                near |= row[i + 1] << (word_bits - 1);
+            if (y != 0)
+                near |= row_at(y - 1)[i];
+            if (y + 1 != Grid::rows)
+                near |= row_at(y + 1)[i];
+            if (auto const bits = unvisited & near; bits != 0) {
+                auto const x = (i * word_bits) + std::countr_zero(bits);
+                found        = Point{static_cast<Distance>(x),
+                                     static_cast<Distance>(y)};
+                break;
+            }
+        }
+    }
+    observer.count(Counter::Words_scanned, scanned);
+    return found;
+}
+
+/// Overwrite \p maze with Passages, alternating random walks and hunts.
+/** \p visited is any vector of Words, a std::vector at compile time. Before
+ *  each hunt calls \p stopped, returns false if it returns true. */
+template <Distance Width,
+          Distance Height,
+          typename... Policies,
+          typename Mask,
+          std::uniform_random_bit_generator Gen,
+          std::predicate Stopped,
+          Observer O = Null_observer>
+constexpr auto do_hunt_and_kill(Maze<Width, Height, Policies...>& maze,
+                                Mask& visited,
+                                Gen& gen,
+                                Stopped&& stopped,
+                                O observer = {}) -> bool
+{
+    using Grid = Room_grid<Width, Height>;
+    visited.assign(Grid::word_count, Word{0});
+    maze.fill(Cell::Wall);
+
+    auto room = utility::random_point<Grid::columns, Grid::rows>(gen);
+    maze.set(utility::times_two(room), Cell::Passage);
+    assign_bit(visited, Grid::index(room), true);
+
+    auto cursor = Hunt_cursor{.top = room.y};
+    while (true) {
+        while (auto const next = kill_step(maze, visited, room, gen)) {
+            room       = *next;
+            cursor.top = std::min<std::size_t>(cursor.top, room.y);
+        }
+
+        if (stopped())
+            return false;
+        auto const found = hunt<Width, Height>(visited, cursor, observer);
+        if (!found)
+            return true;
+        // Connect the new room to a random visited neighbor.
+        auto const [options, count] =
+            room_neighbors<Width, Height>(visited, *found, true);
+        carve_room(maze, visited, *found, options[uniform_to(gen, count - 1)]);
+        room       = *found;
+        cursor.top = std::min<std::size_t>(cursor.top, room.y);
+    }
+}
+
+}  // namespace maze::detail
+
+namespace maze {
+
+/// Overwrite \p m with a maze from the Hunt-and-Kill algorithm, checking
+/// \p stop before each hunt.
+/** Random walks carve long corridors like recursive backtracking, but with no
+ *  stack: when a walk is stuck the next one starts from the first unvisited
+ *  room next to the maze, found by scanning Words of a visited room mask. All
+ *  randomness is drawn from \p gen, scratch memory from \p workspace.
+ *  Returns false, leaving \p m part carved, if a stop was requested first. */
+template <Distance Width,
+          Distance Height,
+          typename... Policies,
+          std::uniform_random_bit_generator Gen>
+auto generate_hunt_and_kill_into(Maze<Width, Height, Policies...>& m,
+                                 Hunt_and_kill_workspace& workspace,
+                                 Gen& gen,
+                                 std::stop_token stop) -> bool
+{
+    return detail::do_hunt_and_kill(m, workspace.visited, gen, [&] {
+        return stop.stop_requested();
+    });
+}
+
+/// Overwrite \p m with a maze from the Hunt-and-Kill algorithm.
+/** All randomness is drawn from \p gen, scratch memory from \p workspace.
+ *  \p observer sees the "hunt_and_kill" phase and the Words scanned. */
+template <Distance Width,
+          Distance Height,
+          typename... Policies,
+          std::uniform_random_bit_generator Gen,
+          Observer O = Null_observer>
+void generate_hunt_and_kill_into(Maze<Width, Height, Policies...>& m,
+                                 Hunt_and_kill_workspace& workspace,
+                                 Gen& gen,
+                                 O observer = {})
+{
+    auto const phase = detail::Phase_scope{observer, "hunt_and_kill"};
+    detail::do_hunt_and_kill(
+        m, workspace.visited, gen, [] { return false; }, observer);
+}
+
+/// Overwrite \p m with a maze from the Hunt-and-Kill algorithm.
+/** Scratch memory is taken from \p workspace. */
+template <Distance Width, Distance Height, typename... Policies>
+void generate_hunt_and_kill_into(Maze<Width, Height, Policies...>& m,
+                                 Hunt_and_kill_workspace& workspace)
+{
+    generate_hunt_and_kill_into(m, workspace, utility::random_gen);
+}
+
+/// Generate a random maze with the Hunt-and-Kill algorithm.
+template <Distance Width, Distance Height, typename Layout = Row_major>
+[[nodiscard]] auto generate_hunt_and_kill() -> Maze<Width, Height, Layout>
+{
+    auto maze      = Maze<Width, Height, Layout>{Cell::Wall};
+    auto workspace = Hunt_and_kill_workspace{};
+    generate_hunt_and_kill_into(maze, workspace, utility::random_gen);
+    return maze;
+}
+
+/// Generate a random maze with the Hunt-and-Kill algorithm from \p gen.
+/** Usable in constant expressions when \p gen is, ex. Splitmix64. */
+template <Distance Width,
+          Distance Height,
+          typename Layout = Row_major,
+          std::uniform_random_bit_generator Gen>
+[[nodiscard]] constexpr auto generate_hunt_and_kill(Gen& gen)
+    -> Maze<Width, Height, Layout>
+{
+    auto maze    = Maze<Width, Height, Layout>{Cell::Wall};
+    auto visited = std::vector<Word>{};
+    detail::do_hunt_and_kill(maze, visited, gen, [] { return false; });
+    return maze;
+}
+
+}  // namespace maze
+#endif  // MAZE_GENERATE_HUNT_AND_KILL_HPP
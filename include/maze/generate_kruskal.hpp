@@ -1,106 +1,270 @@
 #ifndef MAZE_GENERATE_KRUSKAL_HPP
 #define MAZE_GENERATE_KRUSKAL_HPP
-#include <algorithm>
-#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <numeric>
+#include <optional>
 #include <random>
-#include <set>
+#include <utility>
 #include <vector>
 
 #include <maze/cell.hpp>
 #include <maze/distance.hpp>
 #include <maze/edge.hpp>
-#include <maze/graph/disjoint_set.hpp>
+#include <maze/lattice.hpp>
 #include <maze/maze.hpp>
+#include <maze/observer.hpp>
 #include <maze/point.hpp>
+#include <maze/random.hpp>
+#include <maze/stepper.hpp>
+#include <maze/storage.hpp>
 #include <maze/utility.hpp>
 
+namespace maze {
+
+/// Scratch memory for generate_kruskal_into, keeps its capacity across calls.
+struct Kruskal_workspace {
+    Kruskal_workspace() = default;
+
+    /// Allocate all scratch memory from \p resource.
+    explicit Kruskal_workspace(std::pmr::memory_resource* resource)
+        : edges(resource), parent(resource)
+    {}
+
+    std::pmr::vector<Edge> edges;
+    std::pmr::vector<std::size_t> parent;
+};
+
+}  // namespace maze
+
 namespace maze::detail {
 
-/// Returns a list of all possible connected edges in a maze.
-template <Distance Width, Distance Height>
-[[nodiscard]] auto generate_all_maze_edges() -> std::vector<Edge>
+/// Fill \p edges with every East and South Edge of a Width x Height grid.
+template <Distance Width, Distance Height, typename Edges>
+constexpr void generate_all_maze_edges(Edges& edges)
 {
-    auto result = std::vector<Edge>{};
-    for (Distance x = 0; x < Width; ++x) {
-        for (Distance y = 0; y < Height; ++y) {
-            for (auto direction : utility::directions) {
-                auto const next =
-                    utility::next_point<Width, Height>({x, y}, direction);
-                if (next.has_value())
-                    result.push_back({{x, y}, *next});
-            }
+    edges.clear();
+    for (Distance y = 0; y < Height; ++y) {
+        for (Distance x = 0; x < Width; ++x) {
+            if (x + 1 < Width)
+                edges.push_back({{x, y}, {(Distance)(x + 1), y}});
+            if (y + 1 < Height)
+                edges.push_back({{x, y}, {x, (Distance)(y + 1)}});
         }
     }
-    return result;
 }
 
-/// shuffles the given vector
-inline void randomize(std::vector<Edge>& edges)
+/// Return the root of \p i in the disjoint set forest \p parent.
+template <typename Parents>
+[[nodiscard]] constexpr auto find_root(Parents& parent, std::size_t i)
+    -> std::size_t
 {
-    static auto gen = std::mt19937{std::random_device{}()};
-    std::ranges::shuffle(edges, gen);
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i         = parent[i];
+    }
+    return i;
 }
 
-template <Distance Width, Distance Height>
-[[nodiscard]] auto do_kruskal(std::vector<Edge> const& edges) -> std::set<Edge>
+/// Fill \p m with Walls and reset \p edges to a shuffled list of every Edge
+/// and \p parent to one set per room.
+/** \p m is a Maze or a Maze_3d. \p edges and \p parent are any vectors of
+ *  its lattice's Edges and std::size_t, a std::vector at compile time. */
+template <typename M,
+          typename Edges,
+          typename Parents,
+          std::uniform_random_bit_generator Gen>
+constexpr void kruskal_start(M& m, Edges& edges, Parents& parent, Gen& gen)
 {
-    auto ds = graph::Disjoint_set<maze::Point>{};
-    // make a set for each point.
-    for (Distance x = 0; x < Width; ++x) {
-        for (Distance y = 0; y < Height; ++y) {
-            ds.make_set({x, y});
+    using Lattice = Lattice_of<M>;
+    edges.clear();
+    Lattice::for_each_room([&](typename Lattice::Point at) {
+        for (auto const d : Lattice::forward_directions) {
+            if (auto const next = room_neighbor<Lattice>(at, d))
+                edges.push_back({at, *next});
         }
-    }
+    });
+    detail::shuffle(edges, gen);
 
-    auto result = std::set<Edge>{};
-    for (auto const& edge : edges) {
-        if (std::addressof(ds.find_set(edge.a)) !=
-            std::addressof(ds.find_set(edge.b))) {
-            result.insert(edge);
-            ds.merge(edge.a, edge.b);
+    parent.resize(Lattice::room_count);
+    std::iota(std::begin(parent), std::end(parent), std::size_t{0});
+
+    m.fill(Cell::Wall);
+}
+
+/// Carve the next Edge of \p edges, from index \p next, that joins two sets.
+/** Advances \p next past it. Returns the Edge carved, std::nullopt once
+ *  \p edges runs out. */
+template <typename M,
+          typename Edges,
+          typename Parents,
+          Observer O = Null_observer>
+constexpr auto kruskal_step(M& m,
+                            Edges const& edges,
+                            Parents& parent,
+                            std::size_t& next,
+                            O observer = {})
+    -> std::optional<typename Lattice_of<M>::Edge>
+{
+    using Lattice = Lattice_of<M>;
+    while (next < edges.size()) {
+        auto const edge   = edges[next++];
+        auto const root_a = find_root(parent, Lattice::room_index(edge.a));
+        auto const root_b = find_root(parent, Lattice::room_index(edge.b));
+        observer.count(Counter::Edges_checked, 1);
+        if (root_a != root_b) {
+            parent[root_b] = root_a;
+            observer.count(Counter::Merges, 1);
+            m.set(edge.a, Cell::Passage);
+            open_edge(m, edge);
+            return edge;
         }
     }
-    return result;
+    return std::nullopt;
 }
 
-// Width and Height are the 2d Sureface values.
-template <Distance Width, Distance Height>
-[[nodiscard]] auto translate_to_maze(std::set<Edge> const& edges)
-    -> maze::Maze<Width, Height>
+/// Overwrite \p m with a randomized Kruskal's MST over a flat union-find.
+template <typename M,
+          typename Edges,
+          typename Parents,
+          std::uniform_random_bit_generator Gen,
+          Observer O = Null_observer>
+constexpr void do_kruskal(M& m,
+                          Edges& edges,
+                          Parents& parent,
+                          Gen& gen,
+                          O observer = {})
 {
-    auto result = maze::Maze<Width, Height>{Cell::Wall};
-    for (auto edge : edges) {
-        using utility::add;
-        using utility::subtract;
-        using utility::times_two;
-        result.set(times_two(edge.a), Cell::Passage);
-        result.set(times_two(edge.b), Cell::Passage);
-        auto const between = add(times_two(edge.a), subtract(edge.b, edge.a));
-        result.set(between, Cell::Passage);
-    }
-    return result;
+    kruskal_start(m, edges, parent, gen);
+    auto next = std::size_t{0};
+    while (kruskal_step(m, edges, parent, next, observer).has_value()) {}
 }
 
 }  // namespace maze::detail
 
 namespace maze {
 
+/// Overwrite \p m with a maze from a randomized Kruskal's MST algorithm.
+/** Works on any Maze Storage. Maze size should be odd to completely fill.
+ *  All randomness is drawn from \p gen, scratch memory from \p workspace.
+ *  \p observer sees the "kruskal" phase, Edges checked and merges. */
+template <Distance Width,
+          Distance Height,
+          typename... Policies,
+          std::uniform_random_bit_generator Gen,
+          Observer O = Null_observer>
+void generate_kruskal_into(Maze<Width, Height, Policies...>& m,
+                           Kruskal_workspace& workspace,
+                           Gen& gen,
+                           O observer = {})
+{
+    auto const phase = detail::Phase_scope{observer, "kruskal"};
+    detail::do_kruskal(m, workspace.edges, workspace.parent, gen, observer);
+}
+
+/// Overwrite \p m with a maze from a randomized Kruskal's MST algorithm.
+/** Scratch memory is taken from \p workspace. */
+template <Distance Width, Distance Height, typename... Policies>
+void generate_kruskal_into(Maze<Width, Height, Policies...>& m,
+                           Kruskal_workspace& workspace)
+{
+    generate_kruskal_into(m, workspace, utility::random_gen);
+}
+
+/// Overwrite \p m with a maze from a randomized Kruskal's MST algorithm.
+/** Works on any Maze Storage. Maze size should be odd to completely fill.
+ *  The scratch memory of a Mapped_storage Maze is file mapped beside it. */
+template <Distance Width, Distance Height, typename... Policies>
+void generate_kruskal_into(Maze<Width, Height, Policies...>& m)
+{
+    auto scratch   = detail::Scratch_memory{m};
+    auto workspace = Kruskal_workspace{scratch.resource()};
+    generate_kruskal_into(m, workspace, utility::random_gen);
+}
+
 /// Generate a maze with a randomized Kruskal's MST algorithm.
 /** Maze size should be odd to completely fill Maze. */
-template <Distance Width, Distance Height>
-[[nodiscard]] auto generate_kruskal() -> Maze<Width, Height>
+template <Distance Width, Distance Height, typename Layout = Row_major>
+[[nodiscard]] auto generate_kruskal() -> Maze<Width, Height, Layout>
 {
-    constexpr Distance half_width  = utility::ceil(Width / 2.);
-    constexpr Distance half_height = utility::ceil(Height / 2.);
-    auto all_edges = detail::generate_all_maze_edges<half_width, half_height>();
+    auto m = Maze<Width, Height, Layout>{Cell::Wall};
+    generate_kruskal_into(m);
+    return m;
+}
 
-    detail::randomize(all_edges);
+/// Generate a maze with a randomized Kruskal's MST algorithm from \p gen.
+/** Usable in constant expressions when \p gen is, ex. Splitmix64. Maze size
+ *  should be odd to completely fill Maze. */
+template <Distance Width,
+          Distance Height,
+          typename Layout = Row_major,
+          std::uniform_random_bit_generator Gen>
+[[nodiscard]] constexpr auto generate_kruskal(Gen& gen)
+    -> Maze<Width, Height, Layout>
+{
+    auto m      = Maze<Width, Height, Layout>{Cell::Wall};
+    auto edges  = std::vector<Edge>{};
+    auto parent = std::vector<std::size_t>{};
+    detail::do_kruskal(m, edges, parent, gen);
+    return m;
+}
 
-    auto const maze_edges =
-        detail::do_kruskal<half_width, half_height>(all_edges);
+/// Randomized Kruskal's MST algorithm as a Stepper, one carved Edge per step.
+template <Distance Width,
+          Distance Height,
+          typename Layout,
+          typename Storage,
+          std::uniform_random_bit_generator Gen = std::mt19937>
+class Kruskal_stepper {
+   public:
+    /// Overwrite \p m with Walls and prepare to carve it.
+    explicit Kruskal_stepper(Maze<Width, Height, Layout, Storage>& m,
+                             Gen gen = Gen{std::random_device{}()},
+                             Kruskal_workspace workspace = {})
+        : maze_{m}, workspace_{std::move(workspace)}
+    {
+        // All randomness is spent up front, shuffling the Edges.
+        detail::kruskal_start(maze_, workspace_.edges, workspace_.parent, gen);
+    }
 
-    return detail::translate_to_maze<Width, Height>(maze_edges);
-}
+   public:
+    /// Carve the next Edge, returns std::nullopt once the maze is complete.
+    auto step() -> std::optional<Step>
+    {
+        auto const edge = detail::kruskal_step(maze_, workspace_.edges,
+                                               workspace_.parent, next_);
+        done_ = !edge.has_value();
+        if (done_)
+            return std::nullopt;
+        return detail::make_step(edge->a, edge->b, Cell::Passage);
+    }
+
+    /// Return true once step() has returned std::nullopt.
+    [[nodiscard]] auto done() const -> bool { return done_; }
+
+    /// Move out the workspace, to reuse its capacity. Take no more steps.
+    [[nodiscard]] auto take_workspace() -> Kruskal_workspace
+    {
+        return std::move(workspace_);
+    }
+
+   private:
+    Maze<Width, Height, Layout, Storage>& maze_;
+    Kruskal_workspace workspace_;
+    std::size_t next_ = 0;
+    bool done_        = false;
+};
+
+/// Kruskal's Maze generated at compile time from \p Seed.
+template <Distance Width,
+          Distance Height,
+          std::uint64_t Seed,
+          typename Layout = Row_major>
+inline constexpr auto baked_kruskal = [] {
+    auto gen = Splitmix64{Seed};
+    return generate_kruskal<Width, Height, Layout>(gen);
+}();
 
 }  // namespace maze
 #endif  // MAZE_GENERATE_KRUSKAL_HPP
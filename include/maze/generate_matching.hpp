@@ -0,0 +1,212 @@
+#ifndef MAZE_GENERATE_MATCHING_HPP
+#define MAZE_GENERATE_MATCHING_HPP
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <maze/analytics.hpp>
+#include <maze/async.hpp>
+#include <maze/cell.hpp>
+#include <maze/distance.hpp>
+#include <maze/generator_pool.hpp>
+#include <maze/layout.hpp>
+#include <maze/maze.hpp>
+#include <maze/serialize.hpp>
+
+namespace maze::detail {
+
+/// An attempt of generate_matching() in progress and the source that stops
+/// it.
+struct Running_attempt {
+    std::size_t attempt = std::numeric_limits<std::size_t>::max();
+    std::stop_source source;
+};
+
+}  // namespace maze::detail
+
+namespace maze {
+
+/// How generate_matching() searches.
+struct Matching_options {
+    /// Seed of the search, attempt i generates from mix_seed(seed, i).
+    std::uint64_t seed = std::random_device{}();
+    /// Attempts made before giving up.
+    std::size_t max_attempts = 10'000;
+    /// Threads generating attempts, the calling thread is one of them.
+    std::size_t thread_count = detail::default_thread_count();
+};
+
+/// Prefilter that lets every Maze through to the full analysis.
+struct Accept_any {
+    constexpr auto operator()(Maze_metrics const&) const -> bool
+    {
+        return true;
+    }
+};
+
+/// A Maze found by generate_matching().
+template <Distance Width, Distance Height, typename Layout = Row_major>
+struct Matching_maze {
+    /// The Maze, on the heap as it may be large.
+    std::unique_ptr<Maze<Width, Height, Layout>> maze;
+    /// Its seed and generator, generate_into() with a std::mt19937_64
+    /// seeded from it regenerates the Maze.
+    Maze_metadata metadata;
+    /// Its full metrics, as analyze() returns.
+    Maze_metrics metrics;
+    /// Index of the attempt, the lowest that matched.
+    std::size_t attempt = 0;
+    /// Mazes fully generated by every thread, including the ones not needed.
+    std::size_t generated = 0;
+};
+
+/// Generate Mazes with generator \p id until one has metrics that satisfy
+/// \p accept.
+/** Attempts run speculatively on options.thread_count threads, each with its
+ *  own workspaces. Each Maze first gets the single pass analyze_degrees(),
+ *  and only those \p prefilter accepts are fully analyzed, so a prefilter on
+ *  dead ends, junctions or river() rejects most Mazes cheaply. Once an
+ *  attempt matches, every attempt with a higher index is cancelled, part way
+ *  through its generation if need be, by the stop token it is generated
+ *  with, and its thread stops. Attempts with lower indices still finish, so
+ *  the match returned is the lowest matching attempt whatever the thread
+ *  count. Both predicates are called concurrently.
+ *
+ *  Returns std::nullopt if no attempt of options.max_attempts matched or
+ *  \p stop was requested. Throws std::invalid_argument on an Unknown id or
+ *  zero threads, and rethrows the first exception from a thread. */
+template <Distance Width,
+          Distance Height,
+          typename Layout = Row_major,
+          typename Accept,
+          typename Prefilter = Accept_any>
+    requires std::predicate<Accept const&, Maze_metrics const&> &&
+             std::predicate<Prefilter const&, Maze_metrics const&>
+[[nodiscard]] auto generate_matching(Generator_id id,
+                                     Accept const& accept,
+                                     Matching_options const& options = {},
+                                     std::stop_token stop            = {},
+                                     Prefilter const& prefilter      = {})
+    -> std::optional<Matching_maze<Width, Height, Layout>>
+{
+    using Maze_type = Maze<Width, Height, Layout>;
+    if (id == Generator_id::Unknown)
+        throw std::invalid_argument{"generate_matching: Unknown Generator_id."};
+    if (options.thread_count == 0)
+        throw std::invalid_argument{"generate_matching: zero threads."};
+
+    constexpr auto none = std::numeric_limits<std::size_t>::max();
+    auto const thread_count =
+        std::min(options.thread_count, std::max<std::size_t>(
+                                           options.max_attempts, 1));
+    auto next      = std::atomic<std::size_t>{0};
+    auto best      = std::atomic<std::size_t>{none};
+    auto generated = std::atomic<std::size_t>{0};
+    auto mutex     = std::mutex{};  // Guards winner, error and running.
+    auto winner    = Matching_maze<Width, Height, Layout>{};
+    auto error     = std::exception_ptr{};
+    // The attempt each thread is generating, stopped once it is dropped.
+    auto running = std::vector<detail::Running_attempt>(thread_count);
+
+    // Stop the running attempts from index first on, with mutex held.
+    auto const cancel_from = [&](std::size_t first) {
+        for (auto& r : running) {
+            if (r.attempt >= first)
+                r.source.request_stop();
+        }
+    };
+    auto const on_stop = std::stop_callback{stop, [&] {
+        auto const lock = std::lock_guard{mutex};
+        cancel_from(0);
+    }};
+
+    auto const work = [&](std::size_t thread) {
+        try {
+            auto maze      = std::make_unique<Maze_type>(Cell::Wall);
+            auto workspace = Generator_workspace{};
+            auto analytics = Analytics_workspace{};
+            // Attempts only grow, one past the best ends this thread.
+            auto const dropped = [&](std::size_t attempt) {
+                return attempt > best.load() || stop.stop_requested();
+            };
+            while (true) {
+                auto const attempt = next++;
+                if (attempt >= options.max_attempts)
+                    return;
+                auto attempt_stop = std::stop_token{};
+                {
+                    auto const lock = std::lock_guard{mutex};
+                    if (dropped(attempt))
+                        return;
+                    running[thread] = {attempt, std::stop_source{}};
+                    attempt_stop    = running[thread].source.get_token();
+                }
+                auto const seed = detail::mix_seed(options.seed, attempt);
+                if (!detail::generate_stoppable(id, *maze, workspace,
+                                                std::mt19937_64{seed},
+                                                attempt_stop))
+                    return;
+                ++generated;
+
+                auto metrics = analyze_degrees(*maze, analytics);
+                if (!std::invoke(prefilter, std::as_const(metrics)))
+                    continue;
+                if (dropped(attempt))
+                    return;
+                analyze_corridors(*maze, metrics, analytics);
+                if (!std::invoke(accept, std::as_const(metrics)))
+                    continue;
+
+                auto const lock = std::lock_guard{mutex};
+                if (attempt < best.load()) {
+                    best.store(attempt);
+                    cancel_from(attempt + 1);
+                    winner.maze     = std::move(maze);
+                    winner.metadata = {seed, id};
+                    winner.metrics  = metrics;
+                    winner.attempt  = attempt;
+                }
+                return;
+            }
+        }
+        catch (...) {
+            auto const lock = std::lock_guard{mutex};
+            if (error == nullptr)
+                error = std::current_exception();
+            next.store(options.max_attempts);
+            cancel_from(0);
+        }
+    };
+
+    auto threads = std::vector<std::thread>{};
+    threads.reserve(thread_count - 1);
+    for (auto t = std::size_t{1}; t < thread_count; ++t)
+        threads.emplace_back(work, t);
+    work(0);
+    for (auto& thread : threads)
+        thread.join();
+
+    if (error != nullptr)
+        std::rethrow_exception(error);
+    if (best.load() == none || stop.stop_requested())
+        return std::nullopt;
+    winner.generated = generated.load();
+    return winner;
+}
+
+}  // namespace maze
+#endif  // MAZE_GENERATE_MATCHING_HPP
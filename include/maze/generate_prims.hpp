@@ -1,9 +1,10 @@
 #ifndef MAZE_GENERATE_PRIMS_HPP
 #define MAZE_GENERATE_PRIMS_HPP
-#include <array>
 #include <cassert>
 #include <cstddef>
+#include <memory_resource>
 #include <optional>
+#include <random>
 #include <utility>
 #include <vector>
 
@@ -11,104 +12,175 @@
 #include <maze/direction.hpp>
 #include <maze/distance.hpp>
 #include <maze/edge.hpp>
+#include <maze/lattice.hpp>
 #include <maze/maze.hpp>
+#include <maze/observer.hpp>
+#include <maze/stepper.hpp>
 #include <maze/utility.hpp>
 
 namespace maze::detail {
 
-/// Returns Edge in \p direction from \p at, two cells away.
-/** Returns nullopt if outside of given limits from template parameters. */
-template <Distance Width, Distance Height>
-[[nodiscard]] auto make_edge(Point const at, Direction const direction)
-    -> std::optional<Edge>
-{
-    auto const one = utility::next_point<Width, Height>(at, direction);
-    if (one.has_value()) {
-        auto const two = utility::next_point<Width, Height>(*one, direction);
-        if (two.has_value())
-            return Edge{at, *two};
-    }
-    return std::nullopt;
-}
-
-template <Distance Width, Distance Height, Direction... Ds>
-[[nodiscard]] auto do_all_edges(Point at, utility::Directions_pack<Ds...>)
-    -> std::array<std::optional<Edge>, 4>
-{
-    return {make_edge<Width, Height>(at, Ds)...};
-}
-
-/// An edge is two spaces from \p at in all coordinate combinations.
-template <Distance Width, Distance Height>
-[[nodiscard]] auto all_edges(Point at) -> std::array<std::optional<Edge>, 4>
-{
-    return do_all_edges<Width, Height>(at, utility::make_directions_pack());
-}
-
-void append(std::vector<Edge>& list,
-            std::array<std::optional<Edge>, 4> const& edges)
-{
-    for (auto const& e : edges) {
-        if (e.has_value())
-            list.push_back(*e);
-    }
-}
-
 /// Remove and return the Edge in \p list at \p index.
-[[nodiscard]] auto pop(std::vector<Edge>& list, std::size_t index) -> Edge
+/** Order of \p list is not kept, the back Edge takes the place of index. */
+template <typename Edges>
+[[nodiscard]] constexpr auto pop(Edges& list, std::size_t index)
 {
     assert(index < list.size());
-    auto const at   = std::next(std::cbegin(list), index);
-    auto const edge = *at;
-    list.erase(at);
+    auto const edge = list[index];
+    list[index]     = list.back();
+    list.pop_back();
     return edge;
 }
 
-/// Make a passage in \p m from edge.a to edge.b
-/** edge.a is assumed to already be a passage, true for this use case. */
-template <Distance Width, Distance Height>
-void make_passage(Maze<Width, Height>& m, Edge const edge)
+/// Fill \p m with Walls and open a random start room, which is returned.
+/** \p m is a Maze or a Maze_3d. \p list is the frontier, any vector of its
+ *  lattice's Edges, it is reset to the start room's Edges. */
+template <typename M, typename Edges, std::uniform_random_bit_generator Gen>
+constexpr auto prims_start(M& m, Edges& list, Gen& gen)
 {
-    m.set(edge.b, Cell::Passage);
-    auto const middle =
-        utility::add(edge.a, utility::half(utility::subtract(edge.b, edge.a)));
-    m.set(middle, Cell::Passage);
+    auto const start = Lattice_of<M>::random_room(gen);
+    m.fill(Cell::Wall);
+    m.set(start, Cell::Passage);
+    list.clear();
+    append_edges<Lattice_of<M>>(list, start);
+    return start;
 }
 
-/// Perform Randomized Prim's Algorithms over \p m, starting at \p start.
-template <Distance Width, Distance Height>
-void do_prims(Maze<Width, Height>& m, Point start)
+/// Carve the next random frontier Edge of \p list that reaches a Wall.
+/** Returns the Edge carved, std::nullopt once the frontier is empty. */
+template <typename M,
+          typename Edges,
+          std::uniform_random_bit_generator Gen,
+          Observer O = Null_observer>
+constexpr auto prims_step(M& m, Edges& list, Gen& gen, O observer = {})
+    -> std::optional<typename Lattice_of<M>::Edge>
 {
-    auto list = std::vector<Edge>{};
-    append(list, all_edges<Width, Height>(start));
-
     while (!list.empty()) {
-        auto const index = utility::random_index(list.size() - 1);
+        auto const index = utility::random_index(list.size() - 1, gen);
         auto const edge  = pop(list, index);
         if (m.get(edge.b) == Cell::Wall) {
-            make_passage(m, edge);
-            append(list, all_edges<Width, Height>(edge.b));
+            open_edge(m, edge);
+            append_edges<Lattice_of<M>>(list, edge.b);
+            observer.gauge(Counter::Frontier_size, list.size());
+            return edge;
         }
     }
+    return std::nullopt;
+}
+
+/// Perform Randomized Prim's Algorithms over \p m, from a random start room.
+/** \p list is the frontier, it is cleared first. */
+template <typename M,
+          typename Edges,
+          std::uniform_random_bit_generator Gen,
+          Observer O = Null_observer>
+constexpr void do_prims(M& m, Edges& list, Gen& gen, O observer = {})
+{
+    prims_start(m, list, gen);
+    while (prims_step(m, list, gen, observer).has_value()) {}
 }
 
 }  // namespace maze::detail
 
 namespace maze {
 
-/// Generate a maze with a randomized Prim's MST algorithm.
-template <Distance Width, Distance Height>
-[[nodiscard]] auto generate_prims() -> Maze<Width, Height>
+/// Scratch memory for generate_prims_into, keeps its capacity across calls.
+struct Prims_workspace {
+    Prims_workspace() = default;
+
+    /// Allocate all scratch memory from \p resource.
+    explicit Prims_workspace(std::pmr::memory_resource* resource)
+        : frontier(resource)
+    {}
+
+    std::pmr::vector<Edge> frontier;
+};
+
+/// Overwrite \p m with a maze from a randomized Prim's MST algorithm.
+/** All randomness is drawn from \p gen, scratch memory from \p workspace.
+ *  \p observer sees the "prims" phase and the frontier size. */
+template <Distance Width,
+          Distance Height,
+          typename... Policies,
+          std::uniform_random_bit_generator Gen,
+          Observer O = Null_observer>
+void generate_prims_into(Maze<Width, Height, Policies...>& m,
+                         Prims_workspace& workspace,
+                         Gen& gen,
+                         O observer = {})
+{
+    auto const phase = detail::Phase_scope{observer, "prims"};
+    detail::do_prims(m, workspace.frontier, gen, observer);
+}
+
+/// Overwrite \p m with a maze from a randomized Prim's MST algorithm.
+/** Scratch memory is taken from \p workspace. */
+template <Distance Width, Distance Height, typename... Policies>
+void generate_prims_into(Maze<Width, Height, Policies...>& m,
+                         Prims_workspace& workspace)
 {
-    // Less unused space if coordinates are even.
-    auto const start = utility::make_even<Width, Height>(
-        utility::random_point<Width, Height>());
+    generate_prims_into(m, workspace, utility::random_gen);
+}
 
-    auto maze = Maze<Width, Height>{Cell::Wall};
-    maze.set(start, Cell::Passage);
-    detail::do_prims(maze, start);
+/// Generate a maze with a randomized Prim's MST algorithm.
+template <Distance Width, Distance Height, typename Layout = Row_major>
+[[nodiscard]] auto generate_prims() -> Maze<Width, Height, Layout>
+{
+    auto maze      = Maze<Width, Height, Layout>{Cell::Wall};
+    auto workspace = Prims_workspace{};
+    generate_prims_into(maze, workspace, utility::random_gen);
     return maze;
 }
 
+/// Randomized Prim's MST algorithm as a Stepper, one carved Edge per step.
+/** The first step is the start cell. */
+template <Distance Width,
+          Distance Height,
+          typename Layout,
+          typename Storage,
+          std::uniform_random_bit_generator Gen = std::mt19937>
+class Prims_stepper {
+   public:
+    /// Overwrite \p m with Walls and prepare to carve it.
+    explicit Prims_stepper(Maze<Width, Height, Layout, Storage>& m,
+                           Gen gen = Gen{std::random_device{}()},
+                           Prims_workspace workspace = {})
+        : maze_{m}, gen_{std::move(gen)}, workspace_{std::move(workspace)}
+    {
+        start_ = detail::prims_start(maze_, workspace_.frontier, gen_);
+    }
+
+   public:
+    /// Carve the next Edge, returns std::nullopt once the maze is complete.
+    auto step() -> std::optional<Step>
+    {
+        if (start_.has_value()) {
+            auto const start = *std::exchange(start_, std::nullopt);
+            return detail::make_step(start, start, Cell::Passage);
+        }
+        auto const edge = detail::prims_step(maze_, workspace_.frontier, gen_);
+        done_ = !edge.has_value();
+        if (done_)
+            return std::nullopt;
+        return detail::open_step<Width, Height>(*edge);
+    }
+
+    /// Return true once step() has returned std::nullopt.
+    [[nodiscard]] auto done() const -> bool { return done_; }
+
+    /// Move out the workspace, to reuse its capacity. Take no more steps.
+    [[nodiscard]] auto take_workspace() -> Prims_workspace
+    {
+        return std::move(workspace_);
+    }
+
+   private:
+    Maze<Width, Height, Layout, Storage>& maze_;
+    Gen gen_;
+    Prims_workspace workspace_;
+    std::optional<Point> start_;
+    bool done_ = false;
+};
+
 }  // namespace maze
 #endif  // MAZE_GENERATE_PRIMS_HPP
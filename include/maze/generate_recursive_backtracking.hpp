@@ -1,52 +1,245 @@
 #ifndef MAZE_GENERATE_RECURSIVE_BACKTRACKING_HPP
 #define MAZE_GENERATE_RECURSIVE_BACKTRACKING_HPP
+#include <array>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
 
 #include <maze/cell.hpp>
 #include <maze/direction.hpp>
 #include <maze/distance.hpp>
+#include <maze/lattice.hpp>
 #include <maze/maze.hpp>
+#include <maze/random.hpp>
+#include <maze/stepper.hpp>
 #include <maze/utility.hpp>
 
+namespace maze {
+
+/// Scratch memory for generate_recursive_backtracking_into.
+/** The explicit stack replaces recursion, so large mazes can't overflow the
+ *  call stack. Keeps its capacity across calls. */
+struct Backtracking_workspace {
+    /// A visited Point and the Directions it has left to try.
+    struct Frame {
+        Point at;
+        std::array<Direction, 4> directions;
+        std::size_t next = 0;
+    };
+
+    using Stack = std::pmr::vector<Frame>;
+
+    Backtracking_workspace() = default;
+
+    /// Allocate all scratch memory from \p resource.
+    explicit Backtracking_workspace(std::pmr::memory_resource* resource)
+        : stack(resource)
+    {}
+
+    Stack stack;
+};
+
+}  // namespace maze
+
 namespace maze::detail {
 
-/// Recursive function that fills in \p maze with Passages.
-template <Distance Width, Distance Height>
-void do_recursive_backtrack(Maze<Width, Height>& maze, Point const at)
+/// Orders the Directions tried from each room uniformly, the default Order.
+template <typename Lattice>
+struct Uniform_order {
+    template <std::uniform_random_bit_generator Gen>
+    constexpr auto operator()(typename Lattice::Point, Gen& gen) const
+    {
+        auto directions = Lattice::directions;
+        detail::shuffle(directions, gen);
+        return directions;
+    }
+};
+
+/// Fill \p maze with Walls and open a random start room, which is returned.
+/** \p maze is a Maze or a Maze_3d. \p stack is any vector of Frames of its
+ *  lattice's Points and Directions, a std::vector at compile time. It is
+ *  reset to hold the start room. \p order returns the Directions to try from
+ *  a room, in order. */
+template <typename M,
+          typename Stack,
+          std::uniform_random_bit_generator Gen,
+          typename Order = Uniform_order<Lattice_of<M>>>
+constexpr auto backtrack_start(M& maze,
+                               Stack& stack,
+                               Gen& gen,
+                               Order const& order = {})
+{
+    auto const start = Lattice_of<M>::random_room(gen);
+    maze.fill(Cell::Wall);
+    maze.set(start, Cell::Passage);
+    stack.clear();
+    stack.push_back({start, order(start, gen)});
+    return start;
+}
+
+/// Carve the next passage depth first, backtracking through \p stack.
+/** Visits Directions in the same order as a recursive implementation.
+ *  Returns the Edge carved, std::nullopt once \p stack is empty. */
+template <typename M,
+          typename Stack,
+          std::uniform_random_bit_generator Gen,
+          typename Order = Uniform_order<Lattice_of<M>>>
+constexpr auto backtrack_step(M& maze,
+                              Stack& stack,
+                              Gen& gen,
+                              Order const& order = {})
+    -> std::optional<typename Lattice_of<M>::Edge>
 {
-    auto const directions = utility::shuffled_directions();
-    for (auto const direction : directions) {
-        auto const in_between =
-            utility::next_point<Width, Height>(at, direction);
-        if (!in_between)
+    while (!stack.empty()) {
+        auto& top = stack.back();
+        if (top.next == top.directions.size()) {
+            stack.pop_back();
             continue;
+        }
+        auto const at = top.at;
         auto const next =
-            utility::next_point<Width, Height>(*in_between, direction);
-        if (!next || utility::is_passage(maze, *next))
+            room_neighbor<Lattice_of<M>>(at, top.directions[top.next++]);
+        if (!next || maze.get(*next) == Cell::Passage)
             continue;
-        maze.set(*in_between, Cell::Passage);
-        maze.set(*next, Cell::Passage);
-        do_recursive_backtrack(maze, *next);
+        auto const edge = typename Lattice_of<M>::Edge{at, *next};
+        open_edge(maze, edge);
+        stack.push_back({*next, order(*next, gen)});
+        return edge;
     }
+    return std::nullopt;
+}
+
+/// Overwrite \p maze with Passages, depth first from a random start room.
+template <typename M,
+          typename Stack,
+          std::uniform_random_bit_generator Gen,
+          typename Order = Uniform_order<Lattice_of<M>>>
+constexpr void do_recursive_backtrack(M& maze,
+                                      Stack& stack,
+                                      Gen& gen,
+                                      Order const& order = {})
+{
+    backtrack_start(maze, stack, gen, order);
+    while (backtrack_step(maze, stack, gen, order).has_value()) {}
 }
 
 }  // namespace maze::detail
 
 namespace maze {
 
+/// Overwrite \p m with a maze from the recursive backtracking technique.
+/** All randomness is drawn from \p gen, scratch memory from \p workspace. */
+template <Distance Width,
+          Distance Height,
+          typename... Policies,
+          std::uniform_random_bit_generator Gen>
+void generate_recursive_backtracking_into(Maze<Width, Height, Policies...>& m,
+                                          Backtracking_workspace& workspace,
+                                          Gen& gen)
+{
+    detail::do_recursive_backtrack(m, workspace.stack, gen);
+}
+
+/// Overwrite \p m with a maze from the recursive backtracking technique.
+/** Scratch memory is taken from \p workspace. */
+template <Distance Width, Distance Height, typename... Policies>
+void generate_recursive_backtracking_into(Maze<Width, Height, Policies...>& m,
+                                          Backtracking_workspace& workspace)
+{
+    generate_recursive_backtracking_into(m, workspace, utility::random_gen);
+}
+
 /// Generate a random maze with recursive backtracking technique.
-template <Distance Width, Distance Height>
-[[nodiscard]] auto generate_recursive_backtracking() -> Maze<Width, Height>
+template <Distance Width, Distance Height, typename Layout = Row_major>
+[[nodiscard]] auto generate_recursive_backtracking()
+    -> Maze<Width, Height, Layout>
 {
-    // Less unused space if coordinates are even.
-    auto const start = utility::make_even<Width, Height>(
-        utility::random_point<Width, Height>());
+    auto maze      = Maze<Width, Height, Layout>{Cell::Wall};
+    auto workspace = Backtracking_workspace{};
+    generate_recursive_backtracking_into(maze, workspace, utility::random_gen);
+    return maze;
+}
 
-    auto maze = Maze<Width, Height>{Cell::Wall};
-    maze.set(start, Cell::Passage);
-    detail::do_recursive_backtrack(maze, start);
+/// Generate a random maze with recursive backtracking technique from \p gen.
+/** Usable in constant expressions when \p gen is, ex. Splitmix64. */
+template <Distance Width,
+          Distance Height,
+          typename Layout = Row_major,
+          std::uniform_random_bit_generator Gen>
+[[nodiscard]] constexpr auto generate_recursive_backtracking(Gen& gen)
+    -> Maze<Width, Height, Layout>
+{
+    auto maze  = Maze<Width, Height, Layout>{Cell::Wall};
+    auto stack = std::vector<Backtracking_workspace::Frame>{};
+    detail::do_recursive_backtrack(maze, stack, gen);
     return maze;
 }
 
+/// Recursive backtracking as a Stepper, one carved passage per step.
+/** The first step is the start cell. */
+template <Distance Width,
+          Distance Height,
+          typename Layout,
+          typename Storage,
+          std::uniform_random_bit_generator Gen = std::mt19937>
+class Recursive_backtracking_stepper {
+   public:
+    /// Overwrite \p m with Walls and prepare to carve it.
+    explicit Recursive_backtracking_stepper(
+        Maze<Width, Height, Layout, Storage>& m,
+        Gen gen                          = Gen{std::random_device{}()},
+        Backtracking_workspace workspace = {})
+        : maze_{m}, gen_{std::move(gen)}, workspace_{std::move(workspace)}
+    {
+        start_ = detail::backtrack_start(maze_, workspace_.stack, gen_);
+    }
+
+   public:
+    /// Carve the next passage, returns std::nullopt once the maze is complete.
+    auto step() -> std::optional<Step>
+    {
+        if (start_.has_value()) {
+            auto const start = *std::exchange(start_, std::nullopt);
+            return detail::make_step(start, start, Cell::Passage);
+        }
+        auto const edge = detail::backtrack_step(maze_, workspace_.stack, gen_);
+        done_ = !edge.has_value();
+        if (done_)
+            return std::nullopt;
+        return detail::open_step<Width, Height>(*edge);
+    }
+
+    /// Return true once step() has returned std::nullopt.
+    [[nodiscard]] auto done() const -> bool { return done_; }
+
+    /// Move out the workspace, to reuse its capacity. Take no more steps.
+    [[nodiscard]] auto take_workspace() -> Backtracking_workspace
+    {
+        return std::move(workspace_);
+    }
+
+   private:
+    Maze<Width, Height, Layout, Storage>& maze_;
+    Gen gen_;
+    Backtracking_workspace workspace_;
+    std::optional<Point> start_;
+    bool done_ = false;
+};
+
+/// Recursive backtracking Maze generated at compile time from \p Seed.
+template <Distance Width,
+          Distance Height,
+          std::uint64_t Seed,
+          typename Layout = Row_major>
+inline constexpr auto baked_recursive_backtracking = [] {
+    auto gen = Splitmix64{Seed};
+    return generate_recursive_backtracking<Width, Height, Layout>(gen);
+}();
+
 }  // namespace maze
 #endif  // MAZE_GENERATE_RECURSIVE_BACKTRACKING_HPP
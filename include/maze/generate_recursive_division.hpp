@@ -1,12 +1,18 @@
 #ifndef MAZE_GENERATE_RECURSIVE_DIVISION_HPP
 #define MAZE_GENERATE_RECURSIVE_DIVISION_HPP
 #include <array>
+#include <cstdint>
 #include <random>
+#include <optional>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 #include <maze/cell.hpp>
 #include <maze/maze.hpp>
 #include <maze/point.hpp>
+#include <maze/random.hpp>
+#include <maze/stepper.hpp>
 #include <maze/utility.hpp>
 
 namespace maze::detail {
@@ -20,7 +26,20 @@ struct Chamber {
 /// Which way the chamber will be divided.
 enum class Wall_direction { Horizontal, Vertical };
 
-[[nodiscard]] inline auto opposite(Wall_direction x) -> Wall_direction
+/// A Chamber split by a wall with a single opening.
+struct Division {
+    Step wall;
+    Point opening;
+    std::array<Chamber, 2> chambers;
+};
+
+/// A Chamber waiting to be divided.
+struct Division_task {
+    Chamber chamber;
+    Wall_direction direction;
+};
+
+[[nodiscard]] constexpr auto opposite(Wall_direction x) -> Wall_direction
 {
     switch (x) {
         case Wall_direction::Horizontal: return Wall_direction::Vertical;
@@ -29,29 +48,34 @@ enum class Wall_direction { Horizontal, Vertical };
     }
 }
 
-/// Return a random value in the range [lo, hi].
-[[nodiscard]] auto random_value(Distance const lo, Distance const hi)
-    -> Distance
+/// Return a random value in the range [lo, hi], drawn from \p gen.
+template <std::uniform_random_bit_generator Gen>
+[[nodiscard]] constexpr auto random_value(Distance const lo,
+                                          Distance const hi,
+                                          Gen& gen) -> Distance
 {
-    return std::uniform_int_distribution{lo, hi}(utility::random_gen);
+    return lo + static_cast<Distance>(utility::random_index(hi - lo, gen));
 }
 
-template <Distance Width, Distance Height>
-void insert_horizontal_wall(Maze<Width, Height>& m, Distance y, Chamber chamber)
+template <Distance Width, Distance Height, typename... Policies>
+constexpr void insert_horizontal_wall(Maze<Width, Height, Policies...>& m,
+                                      Distance y,
+                                      Chamber chamber)
 {
-    for (Distance x = chamber.top_left.x; x <= chamber.bottom_right.x; ++x)
-        m.set({x, y}, Cell::Wall);
+    m.fill_row_range(y, chamber.top_left.x, chamber.bottom_right.x, Cell::Wall);
 }
 
-template <Distance Width, Distance Height>
-void insert_vertical_wall(Maze<Width, Height>& m, Distance x, Chamber chamber)
+template <Distance Width, Distance Height, typename... Policies>
+constexpr void insert_vertical_wall(Maze<Width, Height, Policies...>& m,
+                                    Distance x,
+                                    Chamber chamber)
 {
     for (Distance y = chamber.top_left.y; y <= chamber.bottom_right.y; ++y)
         m.set({x, y}, Cell::Wall);
 }
 
 /// Returns the closest odd value to \p x, without going over \p limit.
-inline auto make_odd(Distance const x, Distance limit) -> Distance
+constexpr auto make_odd(Distance const x, Distance limit) -> Distance
 {
     if ((x % 2) == 0)
         return (x == limit) ? (x - 1) : (x + 1);
@@ -60,7 +84,7 @@ inline auto make_odd(Distance const x, Distance limit) -> Distance
 }
 
 /// Returns the closest even value to \p x, without going over \p limit.
-inline auto make_even(Distance const x, Distance limit) -> Distance
+constexpr auto make_even(Distance const x, Distance limit) -> Distance
 {
     if ((x % 2) == 0)
         return x;
@@ -68,19 +92,23 @@ inline auto make_even(Distance const x, Distance limit) -> Distance
         return (x == limit) ? (x - 1) : (x + 1);
 }
 
-template <Distance Width, Distance Height>
-[[nodiscard]] auto do_horizontal_division(Maze<Width, Height>& m,
-                                          Chamber chamber)
-    -> std::array<Chamber, 2>
+template <Distance Width,
+          Distance Height,
+          typename... Policies,
+          std::uniform_random_bit_generator Gen>
+[[nodiscard]] constexpr auto do_horizontal_division(
+    Maze<Width, Height, Policies...>& m,
+    Chamber chamber,
+    Gen& gen) -> Division
 {
     // Walls are on odd intervals
     auto const split_y = make_odd(
-        random_value(chamber.top_left.y + 1, chamber.bottom_right.y - 1),
+        random_value(chamber.top_left.y + 1, chamber.bottom_right.y - 1, gen),
         chamber.bottom_right.y - 1);
     insert_horizontal_wall(m, split_y, chamber);
 
     auto const opening_x =
-        make_even(random_value(chamber.top_left.x, chamber.bottom_right.x),
+        make_even(random_value(chamber.top_left.x, chamber.bottom_right.x, gen),
                   chamber.bottom_right.x);
     m.set({opening_x, split_y}, Cell::Passage);
 
@@ -88,22 +116,29 @@ template <Distance Width, Distance Height>
         {chamber.top_left}, {chamber.bottom_right.x, (Distance)(split_y - 1)}};
     auto const second = Chamber{{chamber.top_left.x, (Distance)(split_y + 1)},
                                 {chamber.bottom_right}};
-    return {first, second};
+    auto const wall   = Step{{chamber.top_left.x, split_y},
+                             {chamber.bottom_right.x, split_y},
+                             Cell::Wall};
+    return {wall, {opening_x, split_y}, {first, second}};
 }
 
-template <Distance Width, Distance Height>
-[[nodiscard]] auto do_vertical_division(Maze<Width, Height>& m,
-                                        Chamber const chamber)
-    -> std::array<Chamber, 2>
+template <Distance Width,
+          Distance Height,
+          typename... Policies,
+          std::uniform_random_bit_generator Gen>
+[[nodiscard]] constexpr auto do_vertical_division(
+    Maze<Width, Height, Policies...>& m,
+    Chamber const chamber,
+    Gen& gen) -> Division
 {
     // Walls are on odd intervals
     auto const split_x = make_odd(
-        random_value(chamber.top_left.x + 1, chamber.bottom_right.x - 1),
+        random_value(chamber.top_left.x + 1, chamber.bottom_right.x - 1, gen),
         chamber.bottom_right.x - 1);
     insert_vertical_wall(m, split_x, chamber);
 
     auto const opening_y =
-        make_even(random_value(chamber.top_left.y, chamber.bottom_right.y),
+        make_even(random_value(chamber.top_left.y, chamber.bottom_right.y, gen),
                   chamber.bottom_right.y);
     m.set({split_x, opening_y}, Cell::Passage);
 
@@ -111,43 +146,216 @@ template <Distance Width, Distance Height>
         {chamber.top_left}, {(Distance)(split_x - 1), chamber.bottom_right.y}};
     auto const second = Chamber{{Distance(split_x + 1), chamber.top_left.y},
                                 {chamber.bottom_right}};
-    return {first, second};
+    auto const wall   = Step{{split_x, chamber.top_left.y},
+                             {split_x, chamber.bottom_right.y},
+                             Cell::Wall};
+    return {wall, {split_x, opening_y}, {first, second}};
 }
 
-/** top_left and bottom_right are inclusive, they are not walls. */
+/// Return the Chamber covering a Width x Height maze.
+/** An even last row or column is left out, so every room of the maze is at
+ *  even x and even y and nothing dangles past the last room. */
 template <Distance Width, Distance Height>
-void do_recursive_division(Maze<Width, Height>& m,
-                           Chamber const chamber,
-                           Wall_direction const wall_direction)
+[[nodiscard]] constexpr auto whole_chamber() -> Chamber
+{
+    return {{0, 0},
+            {(Distance)((Width - 1) & ~1), (Distance)((Height - 1) & ~1)}};
+}
+
+/// Open every Cell of \p chamber and close the rest of \p m.
+template <Distance Width, Distance Height, typename... Policies>
+constexpr void open_chamber(Maze<Width, Height, Policies...>& m,
+                            Chamber const chamber)
+{
+    if (chamber.bottom_right == Point{Width - 1, Height - 1}) {
+        m.fill(Cell::Passage);
+        return;
+    }
+    m.fill(Cell::Wall);
+    m.fill_rect(chamber.top_left, chamber.bottom_right, Cell::Passage);
+}
+
+/// Return true if \p chamber is too narrow to hold another wall.
+[[nodiscard]] constexpr auto is_indivisible(Chamber const chamber) -> bool
 {
     auto const& [top_left, bottom_right] = chamber;
+    return (bottom_right.x - top_left.x) < 2 ||
+           (bottom_right.y - top_left.y) < 2;
+}
+
+/// Divide \p chamber in \p direction, writing the wall and its opening to
+/// \p m.
+template <Distance Width,
+          Distance Height,
+          typename... Policies,
+          std::uniform_random_bit_generator Gen>
+constexpr auto divide(Maze<Width, Height, Policies...>& m,
+                      Chamber const chamber,
+                      Wall_direction const direction,
+                      Gen& gen) -> Division
+{
+    if (direction == Wall_direction::Horizontal)
+        return do_horizontal_division(m, chamber, gen);
+    else
+        return do_vertical_division(m, chamber, gen);
+}
+
+/** top_left and bottom_right are inclusive, they are not walls. */
+template <Distance Width,
+          Distance Height,
+          typename... Policies,
+          std::uniform_random_bit_generator Gen>
+constexpr void do_recursive_division(Maze<Width, Height, Policies...>& m,
+                                     Chamber const chamber,
+                                     Wall_direction const wall_direction,
+                                     Gen& gen)
+{
     // End recursion if chamber is a single passage width.
-    if ((bottom_right.x - top_left.x) < 2 || (bottom_right.y - top_left.y) < 2)
+    if (is_indivisible(chamber))
         return;
 
-    auto next_chambers = std::array<Chamber, 2>{};
-    if (wall_direction == Wall_direction::Horizontal)
-        next_chambers = do_horizontal_division(m, {top_left, bottom_right});
-    else
-        next_chambers = do_vertical_division(m, {top_left, bottom_right});
+    auto const division = divide(m, chamber, wall_direction, gen);
+    for (auto const c : division.chambers)
+        do_recursive_division(m, c, opposite(wall_direction), gen);
+}
 
-    for (auto const c : next_chambers)
-        do_recursive_division(m, c, opposite(wall_direction));
+/// Divide the next Chamber in \p stack that can hold a wall, pushing its
+/// halves so the first is divided next, in the same order as recursion.
+/** Returns std::nullopt once \p stack is empty. */
+template <Distance Width,
+          Distance Height,
+          typename... Policies,
+          std::uniform_random_bit_generator Gen>
+auto division_step(Maze<Width, Height, Policies...>& m,
+                   std::vector<Division_task>& stack,
+                   Gen& gen) -> std::optional<Division>
+{
+    while (!stack.empty()) {
+        auto const task = stack.back();
+        stack.pop_back();
+        if (is_indivisible(task.chamber))
+            continue;
+        auto const division = divide(m, task.chamber, task.direction, gen);
+        auto const next     = opposite(task.direction);
+        stack.push_back({division.chambers[1], next});
+        stack.push_back({division.chambers[0], next});
+        return division;
+    }
+    return std::nullopt;
 }
 
 }  // namespace maze::detail
 
 namespace maze {
 
+/// Overwrite \p m with a maze from a Recursive Division algorithm.
+/** Works on any Maze Storage, walls are written as long straight runs. All
+ *  randomness is drawn from \p gen. */
+template <Distance Width,
+          Distance Height,
+          typename... Policies,
+          std::uniform_random_bit_generator Gen>
+constexpr void generate_recursive_division_into(
+    Maze<Width, Height, Policies...>& m,
+    Gen& gen)
+{
+    constexpr auto chamber = detail::whole_chamber<Width, Height>();
+    detail::open_chamber(m, chamber);
+    detail::do_recursive_division(m, chamber, detail::Wall_direction::Vertical,
+                                  gen);
+}
+
+/// Overwrite \p m with a maze from a Recursive Division algorithm.
+/** Works on any Maze Storage, walls are written as long straight runs. */
+template <Distance Width, Distance Height, typename... Policies>
+void generate_recursive_division_into(Maze<Width, Height, Policies...>& m)
+{
+    generate_recursive_division_into(m, utility::random_gen);
+}
+
 /// Generate a maze with a Recursive Division algorithm.
-template <Distance Width, Distance Height>
-[[nodiscard]] auto generate_recursive_division() -> Maze<Width, Height>
+template <Distance Width, Distance Height, typename Layout = Row_major>
+[[nodiscard]] auto generate_recursive_division() -> Maze<Width, Height, Layout>
 {
-    auto m = Maze<Width, Height>{Cell::Passage};
-    do_recursive_division(m, {{0, 0}, {Width - 1, Height - 1}},
-                          detail::Wall_direction::Vertical);
+    auto m = Maze<Width, Height, Layout>{Cell::Passage};
+    generate_recursive_division_into(m);
     return m;
 }
 
+/// Generate a maze with a Recursive Division algorithm from \p gen.
+/** Usable in constant expressions when \p gen is, ex. Splitmix64. */
+template <Distance Width,
+          Distance Height,
+          typename Layout = Row_major,
+          std::uniform_random_bit_generator Gen>
+[[nodiscard]] constexpr auto generate_recursive_division(Gen& gen)
+    -> Maze<Width, Height, Layout>
+{
+    auto m = Maze<Width, Height, Layout>{Cell::Passage};
+    generate_recursive_division_into(m, gen);
+    return m;
+}
+
+/// Recursive Division algorithm as a Stepper.
+/** The first step opens every cell but an even last row or column, then each
+ *  division is a wall step followed by a step for its opening. */
+template <Distance Width,
+          Distance Height,
+          typename Layout,
+          typename Storage,
+          std::uniform_random_bit_generator Gen = std::mt19937>
+class Recursive_division_stepper {
+   public:
+    /// Overwrite \p m with Passages and prepare to divide it.
+    explicit Recursive_division_stepper(Maze<Width, Height, Layout, Storage>& m,
+                                        Gen gen = Gen{std::random_device{}()})
+        : maze_{m},
+          gen_{std::move(gen)},
+          pending_{Step{chamber.top_left, chamber.bottom_right, Cell::Passage}}
+    {
+        detail::open_chamber(maze_, chamber);
+        stack_.push_back({chamber, detail::Wall_direction::Vertical});
+    }
+
+   public:
+    /// Write the next wall or opening, returns std::nullopt once the maze is
+    /// complete.
+    auto step() -> std::optional<Step>
+    {
+        if (pending_.has_value())
+            return std::exchange(pending_, std::nullopt);
+        auto const division = detail::division_step(maze_, stack_, gen_);
+        if (!division.has_value()) {
+            done_ = true;
+            return std::nullopt;
+        }
+        auto const opening = division->opening;
+        pending_           = Step{opening, opening, Cell::Passage};
+        return division->wall;
+    }
+
+    /// Return true once step() has returned std::nullopt.
+    [[nodiscard]] auto done() const -> bool { return done_; }
+
+   private:
+    static constexpr auto chamber = detail::whole_chamber<Width, Height>();
+
+    Maze<Width, Height, Layout, Storage>& maze_;
+    Gen gen_;
+    std::vector<detail::Division_task> stack_;
+    std::optional<Step> pending_;
+    bool done_ = false;
+};
+
+/// Recursive Division Maze generated at compile time from \p Seed.
+template <Distance Width,
+          Distance Height,
+          std::uint64_t Seed,
+          typename Layout = Row_major>
+inline constexpr auto baked_recursive_division = [] {
+    auto gen = Splitmix64{Seed};
+    return generate_recursive_division<Width, Height, Layout>(gen);
+}();
+
 }  // namespace maze
 #endif  // MAZE_GENERATE_RECURSIVE_DIVISION_HPP
@@ -0,0 +1,108 @@
+#ifndef MAZE_GENERATE_SIDEWINDER_HPP
+#define MAZE_GENERATE_SIDEWINDER_HPP
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <random>
+#include <stop_token>
+
+#include <maze/cell.hpp>
+#include <maze/distance.hpp>
+#include <maze/generate_binary_tree.hpp>
+#include <maze/layout.hpp>
+#include <maze/maze.hpp>
+#include <maze/random.hpp>
+#include <maze/utility.hpp>
+
+namespace maze {
+
+/// Overwrite \p m with a maze from the Sidewinder algorithm, checking
+/// \p stop before each row of rooms.
+/** Each row is split into East running corridors by one random bit per room,
+ *  then every run carves North from one of its rooms. The runs come from a
+ *  few Word operations per 64 cells, only the North openings are placed one
+ *  at a time. The top row becomes one long corridor. Maze size should be odd
+ *  to completely fill Maze. Returns false, leaving \p m part carved, if a
+ *  stop was requested first. */
+template <Distance Width,
+          Distance Height,
+          typename... Policies,
+          std::uniform_random_bit_generator Gen>
+auto generate_sidewinder_into(Maze<Width, Height, Policies...>& m,
+                              Gen& gen,
+                              std::stop_token stop) -> bool
+{
+    constexpr auto rooms       = detail::room_bits<Width>();
+    constexpr auto can_go_east = detail::east_bits<Width>();
+
+    auto room_row  = detail::Row_bits<Width>{};
+    auto run_ends  = detail::Row_bits<Width>{};
+    auto north_row = detail::Row_bits<Width>{};
+    m.fill(Cell::Wall);
+    for (auto y = std::size_t{0}; y < Height; y += 2) {
+        if (stop.stop_requested())
+            return false;
+        for (auto i = std::size_t{0}; i < rooms.size(); ++i) {
+            // The top row can't go North, so it is a single run.
+            auto const east = (y == 0)
+                                  ? can_go_east[i]
+                                  : detail::random_word(gen) & can_go_east[i];
+            room_row[i]  = rooms[i] | (east << 1);
+            run_ends[i]  = rooms[i] & ~east;
+            north_row[i] = 0;
+        }
+        m.write_row(static_cast<Distance>(y), room_row);
+        if (y == 0)
+            continue;
+
+        // Each set bit of run_ends closes the run that began at start.
+        auto start = std::size_t{0};
+        for (auto i = std::size_t{0}; i < run_ends.size(); ++i) {
+            for (auto ends = run_ends[i]; ends != 0; ends &= ends - 1) {
+                auto const end =
+                    (i * word_bits) +
+                    static_cast<std::size_t>(std::countr_zero(ends));
+                auto const north =
+                    start + (2 * detail::uniform_to(gen, (end - start) / 2));
+                north_row[north / word_bits] |= Word{1}
+                                                << (north % word_bits);
+                start = end + 2;
+            }
+        }
+        m.write_row(static_cast<Distance>(y - 1), north_row);
+    }
+    return true;
+}
+
+/// Overwrite \p m with a maze from the Sidewinder algorithm.
+/** Maze size should be odd to completely fill Maze. All randomness is drawn
+ *  from \p gen. */
+template <Distance Width,
+          Distance Height,
+          typename... Policies,
+          std::uniform_random_bit_generator Gen>
+void generate_sidewinder_into(Maze<Width, Height, Policies...>& m, Gen& gen)
+{
+    generate_sidewinder_into(m, gen, std::stop_token{});
+}
+
+/// Overwrite \p m with a maze from the Sidewinder algorithm.
+/** Maze size should be odd to completely fill Maze. */
+template <Distance Width, Distance Height, typename... Policies>
+void generate_sidewinder_into(Maze<Width, Height, Policies...>& m)
+{
+    generate_sidewinder_into(m, utility::random_gen);
+}
+
+/// Generate a maze with the Sidewinder algorithm.
+/** Maze size should be odd to completely fill Maze. */
+template <Distance Width, Distance Height, typename Layout = Row_major>
+[[nodiscard]] auto generate_sidewinder() -> Maze<Width, Height, Layout>
+{
+    auto m = Maze<Width, Height, Layout>{Cell::Wall};
+    generate_sidewinder_into(m);
+    return m;
+}
+
+}  // namespace maze
+#endif  // MAZE_GENERATE_SIDEWINDER_HPP
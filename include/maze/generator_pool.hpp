@@ -0,0 +1,373 @@
+#ifndef MAZE_GENERATOR_POOL_HPP
+#define MAZE_GENERATOR_POOL_HPP
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <maze/cell.hpp>
+#include <maze/distance.hpp>
+#include <maze/generate_aldous_broder.hpp>
+#include <maze/generate_binary_tree.hpp>
+#include <maze/generate_ellers.hpp>
+#include <maze/generate_hunt_and_kill.hpp>
+#include <maze/generate_kruskal.hpp>
+#include <maze/generate_prims.hpp>
+#include <maze/generate_recursive_backtracking.hpp>
+#include <maze/generate_recursive_division.hpp>
+#include <maze/generate_sidewinder.hpp>
+#include <maze/layout.hpp>
+#include <maze/maze.hpp>
+#include <maze/random.hpp>
+#include <maze/serialize.hpp>
+#include <maze/storage.hpp>
+
+namespace maze {
+
+/// Scratch memory for every generator, keeps its capacity across calls.
+struct Generator_workspace {
+    Generator_workspace() = default;
+
+    /// Allocate all scratch memory from \p resource.
+    explicit Generator_workspace(std::pmr::memory_resource* resource)
+        : backtracking(resource),
+          kruskal(resource),
+          prims(resource),
+          ellers(resource),
+          hunt_and_kill(resource)
+    {}
+
+    /// Allocate all scratch memory for generating into \p m: file mapped
+    /// beside a Mapped_storage Maze, from the default resource otherwise.
+    template <Distance Width, Distance Height, typename... Policies>
+    explicit Generator_workspace(Maze<Width, Height, Policies...> const& m)
+        : Generator_workspace{std::make_unique<detail::Scratch_memory>(m)}
+    {}
+
+    Generator_workspace(Generator_workspace&&) = default;
+    /// Not assignable: scratch is replaced first, which would free a resource
+    /// the other members still hold memory from.
+    auto operator=(Generator_workspace&&) -> Generator_workspace& = delete;
+
+    /// Owns the resource of a workspace built for a Maze, if any.
+    std::unique_ptr<detail::Scratch_memory> scratch;
+
+    Backtracking_workspace backtracking;
+    Kruskal_workspace kruskal;
+    Prims_workspace prims;
+    Ellers_workspace ellers;
+    Hunt_and_kill_workspace hunt_and_kill;
+
+   private:
+    explicit Generator_workspace(
+        std::unique_ptr<detail::Scratch_memory> owned)
+        : Generator_workspace{owned->resource()}
+    {
+        scratch = std::move(owned);
+    }
+};
+
+/// Overwrite \p m with a maze from the generator named by \p id.
+/** Throws std::invalid_argument if \p id is Generator_id::Unknown. */
+template <Distance Width,
+          Distance Height,
+          typename... Policies,
+          std::uniform_random_bit_generator Gen>
+void generate_into(Generator_id id,
+                   Maze<Width, Height, Policies...>& m,
+                   Generator_workspace& workspace,
+                   Gen& gen)
+{
+    switch (id) {
+        case Generator_id::Recursive_backtracking:
+            generate_recursive_backtracking_into(m, workspace.backtracking,
+                                                 gen);
+            return;
+        case Generator_id::Kruskal:
+            generate_kruskal_into(m, workspace.kruskal, gen);
+            return;
+        case Generator_id::Prims:
+            generate_prims_into(m, workspace.prims, gen);
+            return;
+        case Generator_id::Aldous_broder:
+            generate_aldous_broder_into(m, gen);
+            return;
+        case Generator_id::Recursive_division:
+            generate_recursive_division_into(m, gen);
+            return;
+        case Generator_id::Ellers:
+            generate_ellers_into(m, workspace.ellers, gen);
+            return;
+        case Generator_id::Binary_tree:
+            generate_binary_tree_into(m, gen);
+            return;
+        case Generator_id::Sidewinder:
+            generate_sidewinder_into(m, gen);
+            return;
+        case Generator_id::Hunt_and_kill:
+            generate_hunt_and_kill_into(m, workspace.hunt_and_kill, gen);
+            return;
+        case Generator_id::Unknown: break;
+    }
+    throw std::invalid_argument{"generate_into: Unknown Generator_id."};
+}
+
+}  // namespace maze
+
+namespace maze::detail {
+
+/// Return the seed of maze number \p sequence from a pool's \p base seed.
+/** SplitMix64 finalizer, neighboring sequence numbers give unrelated seeds. */
+[[nodiscard]] constexpr auto mix_seed(std::uint64_t base,
+                                      std::uint64_t sequence) -> std::uint64_t
+{
+    return Splitmix64{base + (sequence * 0x9E3779B97F4A7C15ULL)}();
+}
+
+/// Return the number of hardware threads, at least one.
+[[nodiscard]] inline auto default_thread_count() -> std::size_t
+{
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+}  // namespace maze::detail
+
+namespace maze {
+
+/// Generates batches of Mazes on a fixed set of worker threads.
+/** Each worker owns a Generator_workspace and an RNG, reseeded per maze from
+ *  the pool seed and a running sequence number; that seed is reported in the
+ *  Maze_metadata so any maze can be regenerated with generate_into. Once the
+ *  workspaces have grown to fit, a batch allocates nothing. One batch runs at
+ *  a time, concurrent calls to generate wait their turn. */
+template <Distance Width, Distance Height, typename Layout = Row_major>
+class Generator_pool {
+   public:
+    using Maze_type = Maze<Width, Height, Layout>;
+
+   public:
+    /// Start \p thread_count workers, seeding every maze from \p seed.
+    /** Throws std::invalid_argument if \p thread_count is zero. If a worker
+     *  fails to start, those already started are stopped and joined and the
+     *  std::system_error is rethrown. */
+    explicit Generator_pool(
+        std::size_t thread_count = detail::default_thread_count(),
+        std::uint64_t seed       = std::random_device{}())
+        : seed_{seed}, workers_(thread_count)
+    {
+        if (thread_count == 0)
+            throw std::invalid_argument{"Generator_pool: zero threads."};
+        threads_.reserve(thread_count);
+        try {
+            for (auto& worker : workers_)
+                threads_.emplace_back([this, &worker] { run(worker); });
+        }
+        catch (...) {
+            stop_workers();
+            throw;
+        }
+    }
+
+    Generator_pool(Generator_pool const&) = delete;
+    auto operator=(Generator_pool const&) -> Generator_pool& = delete;
+
+    ~Generator_pool() { stop_workers(); }
+
+   public:
+    /// Fill every Maze in \p out using generator \p id.
+    /** If \p metadata is not empty it must be the size of \p out, and receives
+     *  each maze's seed. Throws std::invalid_argument on an Unknown id or a
+     *  size mismatch, and rethrows the first exception from a worker. */
+    void generate(Generator_id id,
+                  std::span<Maze_type> out,
+                  std::span<Maze_metadata> metadata = {})
+    {
+        if (!metadata.empty() && metadata.size() != out.size())
+            throw std::invalid_argument{"Generator_pool: metadata size."};
+        auto job = Slot_job{id, out, metadata};
+        run_batch(id, out.size(), &job, &Slot_job::run);
+    }
+
+    /// Generate \p count Mazes using generator \p id, passing each to
+    /// \p callback as (index, Maze_type const&, Maze_metadata).
+    /** \p callback is invoked concurrently from the worker threads, the Maze
+     *  reference is only valid for the duration of the call. Throws like the
+     *  span overload, including anything thrown by \p callback. */
+    template <typename Callback>
+        requires std::invocable<Callback&,
+                                std::size_t,
+                                Maze_type const&,
+                                Maze_metadata>
+    void generate(Generator_id id, std::size_t count, Callback&& callback)
+    {
+        using Job = Callback_job<std::remove_reference_t<Callback>>;
+        auto job  = Job{id, std::addressof(callback)};
+        run_batch(id, count, &job, &Job::run);
+    }
+
+    /// Return the number of worker threads.
+    [[nodiscard]] auto thread_count() const -> std::size_t
+    {
+        return threads_.size();
+    }
+
+   private:
+    struct Worker {
+        Generator_workspace workspace;
+        std::mt19937_64 gen;
+        std::unique_ptr<Maze_type> scratch;
+    };
+
+    /// Type erased batch: run(job, worker, seed, index) makes maze index.
+    using Job_fn = void (*)(void*, Worker&, std::uint64_t, std::size_t);
+
+    struct Slot_job {
+        Generator_id id;
+        std::span<Maze_type> out;
+        std::span<Maze_metadata> metadata;
+
+        static void run(void* self,
+                        Worker& worker,
+                        std::uint64_t seed,
+                        std::size_t index)
+        {
+            auto& job = *static_cast<Slot_job*>(self);
+            worker.gen.seed(seed);
+            generate_into(job.id, job.out[index], worker.workspace,
+                          worker.gen);
+            if (!job.metadata.empty())
+                job.metadata[index] = {seed, job.id};
+        }
+    };
+
+    template <typename Callback>
+    struct Callback_job {
+        Generator_id id;
+        Callback* callback;
+
+        static void run(void* self,
+                        Worker& worker,
+                        std::uint64_t seed,
+                        std::size_t index)
+        {
+            auto& job = *static_cast<Callback_job*>(self);
+            if (worker.scratch == nullptr)
+                worker.scratch = std::make_unique<Maze_type>(Cell::Wall);
+            worker.gen.seed(seed);
+            generate_into(job.id, *worker.scratch, worker.workspace,
+                          worker.gen);
+            (*job.callback)(index, std::as_const(*worker.scratch),
+                            Maze_metadata{seed, job.id});
+        }
+    };
+
+   private:
+    std::uint64_t const seed_;
+    std::uint64_t next_sequence_ = 0;
+    std::vector<Worker> workers_;
+    std::vector<std::thread> threads_;
+
+    std::mutex batch_mutex_;  // Serializes calls to generate.
+    std::mutex mutex_;        // Guards everything below.
+    std::condition_variable start_;
+    std::condition_variable done_;
+    bool stopping_            = false;
+    std::uint64_t batch_      = 0;
+    std::size_t busy_workers_ = 0;
+    std::exception_ptr error_;
+
+    // Current batch, written before batch_ is incremented.
+    void* job_             = nullptr;
+    Job_fn job_fn_         = nullptr;
+    std::uint64_t first_   = 0;
+    std::size_t count_     = 0;
+    std::atomic<std::size_t> next_index_ = 0;
+
+   private:
+    /// Stop the workers and join every thread started.
+    void stop_workers()
+    {
+        {
+            auto const lock = std::lock_guard{mutex_};
+            stopping_       = true;
+        }
+        start_.notify_all();
+        for (auto& thread : threads_)
+            thread.join();
+    }
+
+    /// Run \p count jobs on the workers and wait for them to finish.
+    void run_batch(Generator_id id,
+                   std::size_t count,
+                   void* job,
+                   Job_fn job_fn)
+    {
+        if (id == Generator_id::Unknown)
+            throw std::invalid_argument{"Generator_pool: Unknown id."};
+        if (count == 0)
+            return;
+
+        auto const batch_lock = std::lock_guard{batch_mutex_};
+        auto lock             = std::unique_lock{mutex_};
+        job_                  = job;
+        job_fn_               = job_fn;
+        first_                = next_sequence_;
+        count_                = count;
+        next_sequence_ += count;
+        next_index_.store(0, std::memory_order_relaxed);
+        busy_workers_ = workers_.size();
+        ++batch_;
+        start_.notify_all();
+        done_.wait(lock, [this] { return busy_workers_ == 0; });
+
+        if (error_ != nullptr)
+            std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+
+    /// Worker thread loop, claims maze indices until the batch is drained.
+    void run(Worker& worker)
+    {
+        auto seen = std::uint64_t{0};
+        while (true) {
+            {
+                auto lock = std::unique_lock{mutex_};
+                start_.wait(lock,
+                            [&] { return stopping_ || batch_ != seen; });
+                if (stopping_)
+                    return;
+                seen = batch_;
+            }
+            for (auto i = next_index_.fetch_add(1); i < count_;
+                 i      = next_index_.fetch_add(1)) {
+                try {
+                    job_fn_(job_, worker, detail::mix_seed(seed_, first_ + i),
+                            i);
+                }
+                catch (...) {
+                    auto const lock = std::lock_guard{mutex_};
+                    if (error_ == nullptr)
+                        error_ = std::current_exception();
+                    next_index_.store(count_);
+                }
+            }
+            auto const lock = std::lock_guard{mutex_};
+            if (--busy_workers_ == 0)
+                done_.notify_one();
+        }
+    }
+};
+
+}  // namespace maze
+#endif  // MAZE_GENERATOR_POOL_HPP
@@ -0,0 +1,219 @@
+#ifndef MAZE_LATTICE_HPP
+#define MAZE_LATTICE_HPP
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <random>
+
+#include <maze/cell.hpp>
+#include <maze/direction.hpp>
+#include <maze/distance.hpp>
+#include <maze/edge.hpp>
+#include <maze/maze.hpp>
+#include <maze/maze_3d.hpp>
+#include <maze/point.hpp>
+#include <maze/random.hpp>
+#include <maze/stepper.hpp>
+#include <maze/utility.hpp>
+
+namespace maze {
+
+/// The rooms of a Width x Height Maze and the Directions between them.
+/** Rooms are the Cells at even coordinates, each joined to its neighbours
+ *  two Cells away through the wall Cell in between. The generator engines
+ *  are written against a lattice, so one engine carves both Maze and
+ *  Maze_3d. */
+template <Distance Width, Distance Height>
+struct Lattice_2d {
+    using Point     = maze::Point;
+    using Direction = maze::Direction;
+    using Edge      = maze::Edge;
+
+    /// Every Direction, in the order generators try them.
+    static constexpr auto directions = utility::directions;
+    /// The Directions that enumerate each Edge once, from its first room.
+    static constexpr auto forward_directions =
+        std::array{Direction::East, Direction::South};
+
+    static constexpr auto columns = (std::size_t{Width} + 1) / 2;
+    static constexpr auto rows    = (std::size_t{Height} + 1) / 2;
+    /// Number of rooms, the bound of room_index().
+    static constexpr auto room_count = columns * rows;
+
+    /// Return the Cell next to \p p in Direction \p d.
+    /** Returns std::nullopt if it is outside of the maze. */
+    [[nodiscard]] static constexpr auto next_point(Point p, Direction d)
+        -> std::optional<Point>
+    {
+        return utility::next_point<Width, Height>(p, d);
+    }
+
+    /// Return the wall Cell between rooms \p a and \p b.
+    [[nodiscard]] static constexpr auto between(Point a, Point b) -> Point
+    {
+        return {static_cast<Distance>((a.x + b.x) / 2),
+                static_cast<Distance>((a.y + b.y) / 2)};
+    }
+
+    /// Return a random room, from \p gen.
+    template <std::uniform_random_bit_generator Gen>
+    [[nodiscard]] static constexpr auto random_room(Gen& gen) -> Point
+    {
+        return utility::make_even<Width, Height>(
+            utility::random_point<Width, Height>(gen));
+    }
+
+    /// Return the index of \p room among the rooms, row-major.
+    [[nodiscard]] static constexpr auto room_index(Point room) -> std::size_t
+    {
+        return (std::size_t{room.y} / 2 * columns) + (room.x / 2);
+    }
+
+    /// Call \p f with every room, in room_index() order.
+    template <typename F>
+    static constexpr void for_each_room(F&& f)
+    {
+        for (auto y = std::size_t{0}; y < Height; y += 2) {
+            for (auto x = std::size_t{0}; x < Width; x += 2)
+                f(Point{static_cast<Distance>(x), static_cast<Distance>(y)});
+        }
+    }
+};
+
+/// The rooms of a Width x Height x Depth Maze_3d and the Directions between
+/// them.
+/** Rooms are the Cells at even x, y and z, see Lattice_2d. */
+template <Distance Width, Distance Height, Distance Depth>
+struct Lattice_3d {
+    using Point     = Point_3d;
+    using Direction = Direction_3d;
+    using Edge      = Edge_3d;
+
+    /// Every Direction, in the order generators try them.
+    static constexpr auto directions = utility::directions_3d;
+    /// The Directions that enumerate each Edge once, from its first room.
+    static constexpr auto forward_directions =
+        std::array{Direction::East, Direction::South, Direction::Down};
+
+    static constexpr auto columns = (std::size_t{Width} + 1) / 2;
+    static constexpr auto rows    = (std::size_t{Height} + 1) / 2;
+    static constexpr auto layers  = (std::size_t{Depth} + 1) / 2;
+    /// Number of rooms, the bound of room_index().
+    static constexpr auto room_count = columns * rows * layers;
+
+    /// Return the Cell next to \p p in Direction \p d.
+    /** Returns std::nullopt if it is outside of the maze. */
+    [[nodiscard]] static constexpr auto next_point(Point p, Direction d)
+        -> std::optional<Point>
+    {
+        return utility::next_point<Width, Height, Depth>(p, d);
+    }
+
+    /// Return the wall Cell between rooms \p a and \p b.
+    [[nodiscard]] static constexpr auto between(Point a, Point b) -> Point
+    {
+        return {static_cast<Distance>((a.x + b.x) / 2),
+                static_cast<Distance>((a.y + b.y) / 2),
+                static_cast<Distance>((a.z + b.z) / 2)};
+    }
+
+    /// Return a random room, from \p gen.
+    template <std::uniform_random_bit_generator Gen>
+    [[nodiscard]] static constexpr auto random_room(Gen& gen) -> Point
+    {
+        auto const coordinate = [&](Distance limit) {
+            return static_cast<Distance>(
+                2 * utility::random_index((limit - 1) / 2, gen));
+        };
+        // Evaluated in order, so the same seed gives the same room everywhere.
+        auto const x = coordinate(Width);
+        auto const y = coordinate(Height);
+        auto const z = coordinate(Depth);
+        return {x, y, z};
+    }
+
+    /// Return the index of \p room among the rooms, layer-major.
+    [[nodiscard]] static constexpr auto room_index(Point room) -> std::size_t
+    {
+        return (((std::size_t{room.z} / 2 * rows) + (room.y / 2)) * columns) +
+               (room.x / 2);
+    }
+
+    /// Call \p f with every room, in room_index() order.
+    template <typename F>
+    static constexpr void for_each_room(F&& f)
+    {
+        for (auto z = std::size_t{0}; z < Depth; z += 2) {
+            for (auto y = std::size_t{0}; y < Height; y += 2) {
+                for (auto x = std::size_t{0}; x < Width; x += 2) {
+                    f(Point{static_cast<Distance>(x), static_cast<Distance>(y),
+                            static_cast<Distance>(z)});
+                }
+            }
+        }
+    }
+};
+
+}  // namespace maze
+
+namespace maze::detail {
+
+template <typename M>
+struct Lattice_for;
+
+template <Distance Width, Distance Height, typename... Policies>
+struct Lattice_for<Maze<Width, Height, Policies...>> {
+    using type = Lattice_2d<Width, Height>;
+};
+
+template <Distance Width, Distance Height, Distance Depth, typename Layout>
+struct Lattice_for<Maze_3d<Width, Height, Depth, Layout>> {
+    using type = Lattice_3d<Width, Height, Depth>;
+};
+
+/// The lattice of the rooms of Maze type M, a Maze or a Maze_3d.
+template <typename M>
+using Lattice_of = typename Lattice_for<M>::type;
+
+/// Return the room two Cells from room \p at in Direction \p d.
+/** Returns std::nullopt if it is outside of the maze. */
+template <typename Lattice>
+[[nodiscard]] constexpr auto room_neighbor(typename Lattice::Point at,
+                                           typename Lattice::Direction d)
+    -> std::optional<typename Lattice::Point>
+{
+    auto const one = Lattice::next_point(at, d);
+    if (!one.has_value())
+        return std::nullopt;
+    return Lattice::next_point(*one, d);
+}
+
+/// Append every Edge from room \p at to a room inside the maze to \p edges.
+template <typename Lattice, typename Edges>
+constexpr void append_edges(Edges& edges, typename Lattice::Point at)
+{
+    for (auto const d : Lattice::directions) {
+        if (auto const next = room_neighbor<Lattice>(at, d))
+            edges.push_back({at, *next});
+    }
+}
+
+/// Set room edge.b and the wall between it and edge.a to Passages.
+/** edge.a is assumed to already be a Passage. */
+template <typename M>
+constexpr void open_edge(M& m, typename Lattice_of<M>::Edge const& edge)
+{
+    m.set(Lattice_of<M>::between(edge.a, edge.b), Cell::Passage);
+    m.set(edge.b, Cell::Passage);
+}
+
+/// Return the Step of open_edge() on \p edge of a Width x Height Maze.
+template <Distance Width, Distance Height>
+[[nodiscard]] constexpr auto open_step(Edge const& edge) -> Step
+{
+    return make_step(Lattice_2d<Width, Height>::between(edge.a, edge.b),
+                     edge.b, Cell::Passage);
+}
+
+}  // namespace maze::detail
+#endif  // MAZE_LATTICE_HPP
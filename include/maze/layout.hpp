@@ -0,0 +1,353 @@
+#ifndef MAZE_LAYOUT_HPP
+#define MAZE_LAYOUT_HPP
+#include <array>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <maze/direction.hpp>
+#include <maze/distance.hpp>
+#include <maze/point.hpp>
+
+namespace maze {
+
+/// Storage word for packed Cell bits, a set bit is a Passage.
+using Word = std::uint64_t;
+
+/// Number of Cell bits in a single Word.
+inline constexpr auto word_bits = std::size_t{64};
+
+}  // namespace maze
+
+namespace maze::detail {
+
+/// Return true if bit \p index is set in \p words.
+[[nodiscard]] constexpr auto test_bit(std::span<Word const> words,
+                                      std::size_t index) -> bool
+{
+    return ((words[index / word_bits] >> (index % word_bits)) & 1u) != 0;
+}
+
+/// Set bit \p index in \p words to \p value.
+constexpr void assign_bit(std::span<Word> words, std::size_t index, bool value)
+{
+    auto const mask = Word{1} << (index % word_bits);
+    auto& word      = words[index / word_bits];
+    word            = value ? (word | mask) : (word & ~mask);
+}
+
+/// Return a Word with the low \p count bits set, \p count in [0, 64].
+[[nodiscard]] constexpr auto low_bits(std::size_t count) -> Word
+{
+    return count >= word_bits ? ~Word{0} : ((Word{1} << count) - 1);
+}
+
+/// Return \p count bits of \p words starting at bit \p first, \p count <= 64.
+[[nodiscard]] constexpr auto read_bits(std::span<Word const> words,
+                                       std::size_t first,
+                                       std::size_t count) -> Word
+{
+    auto const shift = first % word_bits;
+    auto result      = words[first / word_bits] >> shift;
+    if (shift + count > word_bits)
+        result |= words[(first / word_bits) + 1] << (word_bits - shift);
+    return result & low_bits(count);
+}
+
+/// Write the low \p count bits of \p bits to \p words at bit \p first.
+/** \p count <= 64, at most two Words are touched. */
+constexpr void write_bits(std::span<Word> words,
+                          std::size_t first,
+                          std::size_t count,
+                          Word bits)
+{
+    auto const shift = first % word_bits;
+    auto const mask  = low_bits(count);
+    auto& low        = words[first / word_bits];
+    low              = (low & ~(mask << shift)) | ((bits & mask) << shift);
+    if (shift + count > word_bits) {
+        auto const spill = word_bits - shift;
+        auto& high       = words[(first / word_bits) + 1];
+        high = (high & ~(mask >> spill)) | ((bits & mask) >> spill);
+    }
+}
+
+/// Copy \p count bits from \p source at \p from to \p dest at \p to.
+/** Works a Word at a time, the ranges must not overlap. */
+constexpr void copy_bits(std::span<Word const> source,
+                         std::size_t from,
+                         std::span<Word> dest,
+                         std::size_t to,
+                         std::size_t count)
+{
+    while (count != 0) {
+        auto const chunk = count < word_bits ? count : word_bits;
+        write_bits(dest, to, chunk, read_bits(source, from, chunk));
+        from += chunk;
+        to += chunk;
+        count -= chunk;
+    }
+}
+
+/// Satisfied by Layouts that store each row as a contiguous run of bits.
+/** Layout::row_begin<Width, Height>(y) is the bit index of Point{0, y}. */
+template <typename Layout>
+concept Row_contiguous = requires(Distance y) {
+    {
+        Layout::template row_begin<1, 1>(y)
+    } -> std::same_as<std::size_t>;
+};
+
+/// Satisfied by Layouts that keep a Wall border around every Cell.
+template <typename Layout>
+concept Sentinel_bordered = requires { requires Layout::sentinel_border; };
+
+/// Set the bits [\p first, \p last) of \p words to \p value.
+/** Writes whole Words at a time, only the partial end Words are masked. */
+constexpr void assign_bits(std::span<Word> words,
+                           std::size_t first,
+                           std::size_t last,
+                           bool value)
+{
+    if (first >= last)
+        return;
+    auto const first_word = first / word_bits;
+    auto const last_word  = (last - 1) / word_bits;
+    auto const head       = ~low_bits(first % word_bits);
+    auto const tail       = low_bits(((last - 1) % word_bits) + 1);
+    auto const write      = [&](std::size_t i, Word mask) {
+        words[i] = value ? (words[i] | mask) : (words[i] & ~mask);
+    };
+    if (first_word == last_word) {
+        write(first_word, head & tail);
+        return;
+    }
+    write(first_word, head);
+    for (auto i = first_word + 1; i < last_word; ++i)
+        words[i] = value ? ~Word{0} : Word{0};
+    write(last_word, tail);
+}
+
+/// Return the smallest n such that (1 << n) >= \p x.
+[[nodiscard]] constexpr auto ceil_log2(std::size_t x) -> std::size_t
+{
+    auto n = std::size_t{0};
+    while ((std::size_t{1} << n) < x)
+        ++n;
+    return n;
+}
+
+/// Spread the low 16 bits of \p x to the even bit positions of the result.
+[[nodiscard]] constexpr auto spread_bits(std::uint32_t x) -> std::uint32_t
+{
+    x &= 0x0000'FFFF;
+    x = (x | (x << 8)) & 0x00FF'00FF;
+    x = (x | (x << 4)) & 0x0F0F'0F0F;
+    x = (x | (x << 2)) & 0x3333'3333;
+    x = (x | (x << 1)) & 0x5555'5555;
+    return x;
+}
+
+}  // namespace maze::detail
+
+namespace maze {
+
+/// Layout policy: row-major bits where each row starts on a Word boundary.
+/** Bits past Width in the last Word of each row are always zero(Wall). Rows
+ *  are contiguous, so a band of rows occupies a contiguous range of Words. */
+struct Row_major {
+    template <Distance Width, Distance Height>
+    static constexpr auto words_per_row =
+        (std::size_t{Width} + word_bits - 1) / word_bits;
+
+    template <Distance Width, Distance Height>
+    static constexpr auto word_count =
+        words_per_row<Width, Height> * std::size_t{Height};
+
+    /// Return the bit index of \p p within the Word array.
+    template <Distance Width, Distance Height>
+    [[nodiscard]] static constexpr auto index(Point p) -> std::size_t
+    {
+        assert(p.x < Width && p.y < Height);
+        return row_begin<Width, Height>(p.y) + p.x;
+    }
+
+    /// Return the bit index of Point{0, \p y}.
+    template <Distance Width, Distance Height>
+    [[nodiscard]] static constexpr auto row_begin(Distance y) -> std::size_t
+    {
+        return y * words_per_row<Width, Height> * word_bits;
+    }
+
+    /// Set every Cell bit in \p words to one, leaving padding bits zero.
+    template <Distance Width, Distance Height>
+    static constexpr void fill(std::span<Word> words);
+};
+
+/// Layout policy: 8x8 tiles of Cells, each tile packed into a single Word.
+/** Tiles are row-major, bits within a tile are row-major. A Cell and its
+ *  vertical neighbors usually share a Word, instead of being a row apart. */
+struct Tiled_8x8 {
+    static constexpr auto tile_size = std::size_t{8};
+
+    template <Distance Width, Distance Height>
+    static constexpr auto tiles_per_row = (Width + tile_size - 1) / tile_size;
+
+    template <Distance Width, Distance Height>
+    static constexpr auto word_count =
+        tiles_per_row<Width, Height> *
+        ((Height + tile_size - 1) / tile_size);
+
+    /// Return the bit index of \p p within the Word array.
+    template <Distance Width, Distance Height>
+    [[nodiscard]] static constexpr auto index(Point p) -> std::size_t
+    {
+        assert(p.x < Width && p.y < Height);
+        auto const tile =
+            ((p.y / tile_size) * tiles_per_row<Width, Height>) +
+            (p.x / tile_size);
+        return (tile * word_bits) + ((p.y % tile_size) * tile_size) +
+               (p.x % tile_size);
+    }
+
+    /// Set every Cell bit in \p words to one, leaving padding bits zero.
+    template <Distance Width, Distance Height>
+    static constexpr void fill(std::span<Word> words);
+};
+
+/// Layout policy: Morton (Z-order) curve, interleaving x and y bits.
+/** Both dimensions are rounded up to a power of two, the longer one keeps its
+ *  extra high bits above the interleaved ones. Nearby Cells in any direction
+ *  share Words and cache lines; costs up to 4x the bits of Row_major. */
+struct Morton {
+    template <Distance Width, Distance Height>
+    static constexpr auto x_bits = detail::ceil_log2(Width);
+
+    template <Distance Width, Distance Height>
+    static constexpr auto y_bits = detail::ceil_log2(Height);
+
+    template <Distance Width, Distance Height>
+    static constexpr auto word_count =
+        ((std::size_t{1} << (x_bits<Width, Height> + y_bits<Width, Height>)) +
+         word_bits - 1) /
+        word_bits;
+
+    /// Return the bit index of \p p within the Word array.
+    template <Distance Width, Distance Height>
+    [[nodiscard]] static constexpr auto index(Point p) -> std::size_t
+    {
+        assert(p.x < Width && p.y < Height);
+        constexpr auto xb     = x_bits<Width, Height>;
+        constexpr auto yb     = y_bits<Width, Height>;
+        constexpr auto shared = xb < yb ? xb : yb;
+        constexpr auto mask   = (std::uint32_t{1} << shared) - 1;
+        auto const low        = detail::spread_bits(p.x & mask) |
+                                (detail::spread_bits(p.y & mask) << 1);
+        auto const high       = xb > yb ? (p.x >> shared) : (p.y >> shared);
+        return std::size_t{low} |
+               (static_cast<std::size_t>(high) << (2 * shared));
+    }
+
+    /// Set every Cell bit in \p words to one, leaving padding bits zero.
+    template <Distance Width, Distance Height>
+    static constexpr void fill(std::span<Word> words);
+};
+
+/// Layout policy: Row_major with a permanent one Cell Wall border.
+/** The border is not addressable by Point and is never set, so every Cell has
+ *  four neighbor bits and a neighbor is reached by adding offset(Direction)
+ *  to the bit index, with no bounds check. */
+struct Padded_row_major {
+    /// Marks Layouts where neighbor bits can be reached through offset().
+    static constexpr auto sentinel_border = true;
+
+    template <Distance Width, Distance Height>
+    static constexpr auto words_per_row =
+        (std::size_t{Width} + 2 + word_bits - 1) / word_bits;
+
+    template <Distance Width, Distance Height>
+    static constexpr auto row_bits = words_per_row<Width, Height> * word_bits;
+
+    template <Distance Width, Distance Height>
+    static constexpr auto word_count =
+        words_per_row<Width, Height> * (std::size_t{Height} + 2);
+
+    /// Return the bit index of \p p within the Word array.
+    template <Distance Width, Distance Height>
+    [[nodiscard]] static constexpr auto index(Point p) -> std::size_t
+    {
+        assert(p.x < Width && p.y < Height);
+        return row_begin<Width, Height>(p.y) + p.x;
+    }
+
+    /// Return the bit index of Point{0, \p y}.
+    template <Distance Width, Distance Height>
+    [[nodiscard]] static constexpr auto row_begin(Distance y) -> std::size_t
+    {
+        return ((y + std::size_t{1}) * row_bits<Width, Height>) + 1;
+    }
+
+    /// Return the bit index difference to the neighbor in Direction \p d.
+    template <Distance Width, Distance Height>
+    [[nodiscard]] static constexpr auto offset(Direction d) -> std::ptrdiff_t
+    {
+        constexpr auto row =
+            static_cast<std::ptrdiff_t>(row_bits<Width, Height>);
+        // Indexed by Direction: North, South, East, West.
+        constexpr auto offsets = std::array{-row, row, std::ptrdiff_t{1},
+                                            std::ptrdiff_t{-1}};
+        return offsets[static_cast<std::size_t>(d)];
+    }
+
+    /// Set every Cell bit in \p words to one, leaving border bits zero.
+    template <Distance Width, Distance Height>
+    static constexpr void fill(std::span<Word> words);
+};
+
+template <Distance Width, Distance Height>
+constexpr void Row_major::fill(std::span<Word> words)
+{
+    constexpr auto per_row = words_per_row<Width, Height>;
+    for (auto row = std::size_t{0}; row < Height; ++row)
+        detail::assign_bits(words.subspan(row * per_row, per_row), 0, Width,
+                            true);
+}
+
+template <Distance Width, Distance Height>
+constexpr void Tiled_8x8::fill(std::span<Word> words)
+{
+    constexpr auto per_row = tiles_per_row<Width, Height>;
+    for (auto i = std::size_t{0}; i < word_count<Width, Height>; ++i) {
+        auto const columns  = Width - ((i % per_row) * tile_size);
+        auto const rows     = Height - ((i / per_row) * tile_size);
+        auto const row_mask =
+            detail::low_bits(columns < tile_size ? columns : tile_size);
+        auto mask           = Word{0};
+        for (auto r = std::size_t{0}; r < tile_size && r < rows; ++r)
+            mask |= row_mask << (r * tile_size);
+        words[i] = mask;
+    }
+}
+
+template <Distance Width, Distance Height>
+constexpr void Morton::fill(std::span<Word> words)
+{
+    for (Distance y = 0; y < Height; ++y) {
+        for (Distance x = 0; x < Width; ++x)
+            detail::assign_bit(words, index<Width, Height>({x, y}), true);
+    }
+}
+
+template <Distance Width, Distance Height>
+constexpr void Padded_row_major::fill(std::span<Word> words)
+{
+    constexpr auto per_row = words_per_row<Width, Height>;
+    for (auto row = std::size_t{1}; row <= Height; ++row)
+        detail::assign_bits(words.subspan(row * per_row, per_row), 1,
+                            std::size_t{Width} + 1, true);
+}
+
+}  // namespace maze
+#endif  // MAZE_LAYOUT_HPP
@@ -1,116 +1,283 @@
 #ifndef MAZE_LONGEST_PATH_HPP
 #define MAZE_LONGEST_PATH_HPP
 #include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <stop_token>
+#include <utility>
 #include <vector>
 
 #include <maze/cell.hpp>
+#include <maze/cell_grid.hpp>
 #include <maze/direction.hpp>
 #include <maze/distance.hpp>
 #include <maze/maze.hpp>
+#include <maze/observer.hpp>
+#include <maze/path.hpp>
 #include <maze/point.hpp>
+#include <maze/storage.hpp>
 #include <maze/utility.hpp>
 
 namespace maze::detail {
 
-/// Recursive implementation; inc depth first distance calc and saving solution.
-/** Assumes \p at is a Passage cell. */
-template <Distance Width, Distance Height>
-void do_longest_path(Maze<Width, Height> const& maze,
-                     Point const at,
-                     Direction entry,
-                     int const distance,
-                     int& max_distance,
-                     std::vector<Point>& current_path,
-                     std::vector<Point>& solution_path)
+/// A cell on the explicit stack of a longest path search.
+struct Search_frame {
+    Point at;
+    /// Direction back to the previous cell, never searched.
+    Direction entry;
+    /// Index in utility::directions of the next Direction to try.
+    std::uint8_t next;
+};
+
+}  // namespace maze::detail
+
+namespace maze {
+
+/// Scratch memory for longest_path and longest_path_from.
+/** A Search_frame per cell of the deepest branch searched. Keeps its
+ *  capacity across calls. */
+struct Longest_path_workspace {
+    Longest_path_workspace() = default;
+
+    /// Allocate all scratch memory from \p resource.
+    explicit Longest_path_workspace(std::pmr::memory_resource* resource)
+        : stack(resource)
+    {}
+
+    std::pmr::vector<detail::Search_frame> stack;
+};
+
+}  // namespace maze
+
+namespace maze::detail {
+
+/// Return a Direction that is not a Passage from \p at, any will do as the
+/// entry of a search starting there.
+template <Cell_grid G>
+[[nodiscard]] auto start_entry(G const& maze, Point at) -> Direction
 {
-    current_path.push_back(at);
-    if (utility::is_dead_end(maze, at) && distance > max_distance) {
-        max_distance  = distance;
-        solution_path = current_path;
+    for (auto const direction : utility::directions) {
+        if (!utility::next_passage(maze, at, direction).has_value())
+            return direction;
     }
+    return Direction::North;
+}
 
-    for (auto const direction : utility::directions) {
-        if (direction != entry) {
-            auto const next = utility::next_point<Width, Height>(at, direction);
-            if (!next.has_value() || maze.get(*next) == Cell::Wall)
-                continue;
-            do_longest_path(maze, *next, utility::opposite(direction),
-                            distance + 1, max_distance, current_path,
-                            solution_path);
+/// Depth first search of the Passages reachable from \p start, a tree, over
+/// the explicit stack \p stack.
+/** Calls \p visit(at, distance) for every cell, in the order of a recursive
+ *  search trying utility::directions in turn, and ends the search early once
+ *  it returns true; \p stack then holds the cells from \p start to there.
+ *  Checks \p stop at every cell, returns false as soon as it is requested. */
+template <Cell_grid G, typename Stack, typename Visit, Observer O>
+auto search_tree(G const& maze,
+                 Point const start,
+                 Stack& stack,
+                 std::stop_token const& stop,
+                 O observer,
+                 Visit&& visit) -> bool
+{
+    stack.clear();
+    if (stop.stop_requested())
+        return false;
+    stack.push_back({start, start_entry(maze, start), 0});
+    observer.gauge(Counter::Path_depth, stack.size());
+    if (visit(start, std::size_t{0}))
+        return true;
+
+    while (!stack.empty()) {
+        auto& top = stack.back();
+        if (top.next == utility::directions.size()) {
+            stack.pop_back();
+            continue;
         }
+        auto const direction = utility::directions[top.next++];
+        if (direction == top.entry)
+            continue;
+        auto const next = utility::next_passage(maze, top.at, direction);
+        if (!next.has_value())
+            continue;
+        if (stop.stop_requested())
+            return false;
+        stack.push_back({*next, utility::opposite(direction), 0});
+        observer.gauge(Counter::Path_depth, stack.size());
+        if (visit(*next, stack.size() - 1))
+            return true;
     }
+    return true;
+}
 
-    current_path.pop_back();
+/// Return the first dead end found farthest from \p start and its distance.
+/** Returns std::nullopt if a stop was requested first, and \p start itself
+ *  if no dead end is farther. */
+template <Cell_grid G, typename Stack, Observer O>
+[[nodiscard]] auto farthest_dead_end(G const& maze,
+                                     Point const start,
+                                     Stack& stack,
+                                     std::stop_token const& stop,
+                                     O observer)
+    -> std::optional<std::pair<Point, std::size_t>>
+{
+    auto farthest = std::pair{start, std::size_t{0}};
+    auto const searched =
+        search_tree(maze, start, stack, stop, observer,
+                    [&](Point at, std::size_t distance) {
+                        if (distance > farthest.second &&
+                            utility::is_dead_end(maze, at))
+                            farthest = {at, distance};
+                        return false;
+                    });
+    if (!searched)
+        return std::nullopt;
+    return farthest;
+}
+
+/// Return the first leaf of \p m in row order, std::nullopt if it has none.
+template <Cell_grid G>
+[[nodiscard]] auto first_leaf(G const& m) -> std::optional<Point>
+{
+    for (Distance y = 0; y < G::height; ++y) {
+        for (Distance x = 0; x < G::width; ++x) {
+            if (m.get({x, y}) == Cell::Passage &&
+                utility::passage_count(m, {x, y}) == 1)
+                return Point{x, y};
+        }
+    }
+    return std::nullopt;
 }
 
 }  // namespace maze::detail
 
 namespace maze {
 
+/// Finds the longest path along \p maze, beginning at \p start, checking
+/// \p stop at every cell.
+/** Two depth first searches over an explicit stack taken from
+ *  \p workspace, so the path length is not bounded by the call stack: one
+ *  finds the farthest dead end, the next stops there and reads the path off
+ *  its stack. Linear in the cells reachable from \p start. Returns
+ *  std::nullopt if a stop was requested before the search finished,
+ *  otherwise as longest_path_from(maze, start). */
+template <Cell_grid G, Observer O = Null_observer>
+[[nodiscard]] auto longest_path_from(G const& maze,
+                                     Point const start,
+                                     Longest_path_workspace& workspace,
+                                     std::stop_token const& stop,
+                                     O observer = {}) -> std::optional<Path>
+{
+    auto& stack        = workspace.stack;
+    auto const farthest =
+        detail::farthest_dead_end(maze, start, stack, stop, observer);
+    if (!farthest.has_value())
+        return std::nullopt;
+    if (farthest->second == 0)
+        return Path{};
+
+    auto const end = farthest->first;
+    if (!detail::search_tree(maze, start, stack, stop, observer,
+                             [&](Point at, std::size_t) { return at == end; }))
+        return std::nullopt;
+    auto result = Path{start};
+    for (auto i = std::size_t{1}; i < stack.size(); ++i)
+        result.push_back(utility::opposite(stack[i].entry));
+    return result;
+}
+
+/// Finds the longest path along \p maze, beginning at \p start, checking
+/// \p stop at every cell.
+/** As the Longest_path_workspace overload. The scratch memory of a
+ *  Mapped_storage Maze is file mapped beside it. */
+template <Cell_grid G, Observer O = Null_observer>
+[[nodiscard]] auto longest_path_from(G const& maze,
+                                     Point const start,
+                                     std::stop_token const& stop,
+                                     O observer = {}) -> std::optional<Path>
+{
+    auto scratch   = detail::Scratch_memory{maze};
+    auto workspace = Longest_path_workspace{scratch.resource()};
+    return longest_path_from(maze, start, workspace, stop, observer);
+}
+
 /// Finds the longest path along \p maze, beginning at \p start.
 /** Returns an ordered list of Points, following Passage cells to the farthest
- *  point from \p start in \p maze. Returns an empty vector if \p maze and \p
+ *  point from \p start in \p maze. Returns an empty Path if \p maze and \p
  *  start are invalid in some way. \p start should only have one exit passage */
-template <Distance Width, Distance Height>
-[[nodiscard]] auto longest_path_from(Maze<Width, Height> const& maze,
-                                     Point const start) -> std::vector<Point>
+template <Cell_grid G, Observer O = Null_observer>
+[[nodiscard]] auto longest_path_from(G const& maze,
+                                     Point const start,
+                                     O observer = {}) -> Path
 {
-    auto solution_path = std::vector<Point>{};
-    auto current_path  = std::vector<Point>{};
-    auto max_distance  = 0;
-
-    // Any direction that is a Wall is fine to use.
-    auto start_entry = Direction::North;
-    for (auto const direction : utility::directions) {
-        auto const next = utility::next_point<Width, Height>(start, direction);
-        if (next.has_value() && (maze.get(*next) == Cell::Wall)) {
-            start_entry = direction;
-            break;
-        }
-    }
-    detail::do_longest_path(maze, start, start_entry, 0, max_distance,
-                            current_path, solution_path);
-    return solution_path;
+    return *longest_path_from(maze, start, std::stop_token{}, observer);
 }
 
 /// finds all leaf nodes in \p Maze. Points with only a single edge.
-template <Distance Width, Distance Height>
-[[nodiscard]] auto find_all_leaves(Maze<Width, Height> const& m)
-    -> std::vector<Point>
+template <Cell_grid G>
+[[nodiscard]] auto find_all_leaves(G const& m) -> std::vector<Point>
 {
     auto result = std::vector<Point>{};
-    for (Distance x = 0; x < Width; ++x) {
-        for (Distance y = 0; y < Height; ++y) {
-            if (m.get({x, y}) == Cell::Passage) {
-                auto count = 0;
-                for (auto direction : utility::directions) {
-                    auto const neighbor =
-                        utility::next_point<Width, Height>({x, y}, direction);
-                    if (neighbor.has_value() &&
-                        m.get(*neighbor) == Cell::Passage) {
-                        ++count;
-                    }
-                }
-                if (count == 1)
-                    result.push_back({x, y});
+    for (Distance x = 0; x < G::width; ++x) {
+        for (Distance y = 0; y < G::height; ++y) {
+            if (m.get({x, y}) == Cell::Passage &&
+                utility::passage_count(m, {x, y}) == 1) {
+                result.push_back({x, y});
             }
         }
     }
     return result;
 }
 
-template <Distance Width, Distance Height>
-[[nodiscard]] auto longest_path(Maze<Width, Height> const& m)
-    -> std::vector<Point>
+/// Finds the longest path in \p m, checking \p stop at every cell searched.
+/** \p m should be a perfect maze, a tree of Passages. The dead end farthest
+ *  from any leaf ends a longest path, which a search from there finds, so
+ *  three linear searches over scratch memory from \p workspace suffice.
+ *  Returns std::nullopt if a stop was requested before the search finished.
+ *  \p observer sees the "longest_path" phase, the leaves searched from and
+ *  the search depth. */
+template <Cell_grid G, Observer O = Null_observer>
+[[nodiscard]] auto longest_path(G const& m,
+                                Longest_path_workspace& workspace,
+                                std::stop_token stop,
+                                O observer = {}) -> std::optional<Path>
 {
-    auto solution     = std::vector<Point>{};
-    auto const leaves = find_all_leaves(m);
-    for (auto const leaf : leaves) {
-        auto path = longest_path_from(m, leaf);
-        if (path.size() > solution.size())
-            solution = std::move(path);
-    }
-    return solution;
+    auto const phase = detail::Phase_scope{observer, "longest_path"};
+    auto const leaf  = detail::first_leaf(m);
+    if (!leaf.has_value())
+        return Path{};
+    observer.count(Counter::Leaves, 1);
+    auto const farthest =
+        detail::farthest_dead_end(m, *leaf, workspace.stack, stop, observer);
+    if (!farthest.has_value())
+        return std::nullopt;
+    observer.count(Counter::Leaves, 1);
+    return longest_path_from(m, farthest->first, workspace, stop, observer);
+}
+
+/// Finds the longest path in \p m, checking \p stop at every cell searched.
+/** As the Longest_path_workspace overload. The scratch memory of a
+ *  Mapped_storage Maze is file mapped beside it. */
+template <Cell_grid G, Observer O = Null_observer>
+[[nodiscard]] auto longest_path(G const& m,
+                                std::stop_token stop,
+                                O observer = {}) -> std::optional<Path>
+{
+    auto scratch   = detail::Scratch_memory{m};
+    auto workspace = Longest_path_workspace{scratch.resource()};
+    return longest_path(m, workspace, std::move(stop), observer);
+}
+
+template <Cell_grid G>
+[[nodiscard]] auto longest_path(G const& m) -> Path
+{
+    return *longest_path(m, std::stop_token{});
+}
+
+/// Finds the longest path in \p m, reporting to \p observer.
+template <Cell_grid G, Observer O>
+[[nodiscard]] auto longest_path(G const& m, O observer) -> Path
+{
+    return *longest_path(m, std::stop_token{}, observer);
 }
 
 }  // namespace maze
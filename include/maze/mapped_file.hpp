@@ -0,0 +1,154 @@
+#ifndef MAZE_MAPPED_FILE_HPP
+#define MAZE_MAPPED_FILE_HPP
+#include <cerrno>
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace maze {
+
+/// Access rights of a Mapped_file.
+enum class Map_mode { Read_only, Read_write };
+
+/// Memory mapping of an entire file. POSIX only. Move only.
+/** Read_write mappings are shared, writes reach the file without a flush. */
+class Mapped_file {
+   public:
+    /// Map the existing file at \p path into memory.
+    /** Throws std::system_error if the file can't be opened or mapped. */
+    explicit Mapped_file(std::filesystem::path const& path,
+                         Map_mode mode = Map_mode::Read_only)
+        : mode_{mode}
+    {
+        auto const flags = (mode == Map_mode::Read_only) ? O_RDONLY : O_RDWR;
+        auto const fd    = ::open(path.c_str(), flags | O_CLOEXEC);
+        if (fd == -1)
+            throw_errno("Mapped_file: open " + path.string());
+
+        struct ::stat info {};
+        if (::fstat(fd, &info) == -1) {
+            ::close(fd);
+            throw_errno("Mapped_file: fstat " + path.string());
+        }
+        map(fd, static_cast<std::size_t>(info.st_size), path);
+    }
+
+    Mapped_file(Mapped_file&& other) noexcept
+        : data_{std::exchange(other.data_, nullptr)},
+          size_{std::exchange(other.size_, 0)},
+          mode_{other.mode_}
+    {}
+
+    auto operator=(Mapped_file&& other) noexcept -> Mapped_file&
+    {
+        if (this != &other) {
+            unmap();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            mode_ = other.mode_;
+        }
+        return *this;
+    }
+
+    Mapped_file(Mapped_file const&) = delete;
+    auto operator=(Mapped_file const&) -> Mapped_file& = delete;
+
+    ~Mapped_file() { unmap(); }
+
+   public:
+    /// Create or truncate the file at \p path to \p size zero bytes and map it
+    /// Read_write. The file is sparse until written.
+    /** Throws std::system_error if the file can't be created or mapped. */
+    [[nodiscard]] static auto create(std::filesystem::path const& path,
+                                     std::size_t size) -> Mapped_file
+    {
+        auto const fd =
+            ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd == -1)
+            throw_errno("Mapped_file: create " + path.string());
+        if (::ftruncate(fd, static_cast<::off_t>(size)) == -1) {
+            ::close(fd);
+            throw_errno("Mapped_file: ftruncate " + path.string());
+        }
+        auto result  = Mapped_file{};
+        result.mode_ = Map_mode::Read_write;
+        result.map(fd, size, path);
+        return result;
+    }
+
+   public:
+    /// Return the mapped bytes of the file.
+    [[nodiscard]] auto bytes() const -> std::span<std::byte const>
+    {
+        return {data_, size_};
+    }
+
+    /// Return the mapped bytes of the file, mutable.
+    /** Throws std::logic_error if *this is mapped Read_only. */
+    [[nodiscard]] auto writable_bytes() -> std::span<std::byte>
+    {
+        if (mode_ != Map_mode::Read_write)
+            throw std::logic_error{"Mapped_file: mapping is read-only."};
+        return {data_, size_};
+    }
+
+    /// Block until all writes have reached the file.
+    /** Throws std::system_error on failure. */
+    void flush()
+    {
+        if (data_ != nullptr && mode_ == Map_mode::Read_write &&
+            ::msync(data_, size_, MS_SYNC) == -1) {
+            throw_errno("Mapped_file: msync");
+        }
+    }
+
+   private:
+    std::byte* data_ = nullptr;
+    std::size_t size_ = 0;
+    Map_mode mode_    = Map_mode::Read_only;
+
+   private:
+    Mapped_file() = default;
+
+    /// Map \p size bytes of \p fd and close \p fd.
+    void map(int fd, std::size_t size, std::filesystem::path const& path)
+    {
+        size_ = size;
+        if (size_ != 0) {
+            auto const protection = (mode_ == Map_mode::Read_only)
+                                        ? PROT_READ
+                                        : (PROT_READ | PROT_WRITE);
+            auto* const address =
+                ::mmap(nullptr, size_, protection, MAP_SHARED, fd, 0);
+            if (address == MAP_FAILED) {
+                ::close(fd);
+                throw_errno("Mapped_file: mmap " + path.string());
+            }
+            data_ = static_cast<std::byte*>(address);
+        }
+        ::close(fd);
+    }
+
+    void unmap()
+    {
+        if (data_ != nullptr)
+            ::munmap(data_, size_);
+    }
+
+    [[noreturn]] static void throw_errno(std::string const& what)
+    {
+        throw std::system_error{errno, std::generic_category(), what};
+    }
+};
+
+}  // namespace maze
+#endif  // MAZE_MAPPED_FILE_HPP
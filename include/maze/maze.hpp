@@ -1,25 +1,72 @@
 #ifndef MAZE_MAZE_HPP
 #define MAZE_MAZE_HPP
-#include <bitset>
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <concepts>
 #include <cstddef>
+#include <span>
 #include <stdexcept>
+#include <utility>
 
 #include <maze/cell.hpp>
+#include <maze/direction.hpp>
 #include <maze/distance.hpp>
+#include <maze/layout.hpp>
 #include <maze/point.hpp>
+#include <maze/storage.hpp>
 
 namespace maze {
 
 /// 2D Representation of Cells that are either Walls or Passages.
-template <Distance Width, Distance Height>
+/** Layout decides where each Cell bit lives, Storage decides where the Words
+ *  live. Copyable if Storage is, Mapped_storage Mazes are move only. */
+template <Distance Width,
+          Distance Height,
+          typename Layout  = Row_major,
+          typename Storage = Inline_storage>
 class Maze {
+    static_assert(Width != 0 && Height != 0);
+
+   public:
+    /// Size in Cells, as for every Cell_grid.
+    static constexpr auto width  = Width;
+    static constexpr auto height = Height;
+
+    /// Number of Words backing the Cell bits, see words().
+    static constexpr auto word_count =
+        Layout::template word_count<Width, Height>;
+
+    /// Container of the Words, from Storage.
+    using Words = typename Storage::template words<word_count>;
+
+    /// True if Layout keeps a Wall border, enabling neighbor_index().
+    static constexpr auto has_sentinel_border =
+        detail::Sentinel_bordered<Layout>;
+
    public:
     /// Construct a maze where all Cells are initialize with \p all_cells.
-    constexpr Maze(Cell all_cells) : data_{}
+    constexpr Maze(Cell all_cells)
+        requires std::default_initializable<Words>
+        : data_{}
     {
         if (all_cells == Cell::Passage)
-            data_.flip();
+            fill(Cell::Passage);
+    }
+
+    /// Construct a maze over \p words where all Cells are \p all_cells.
+    /** Throws std::invalid_argument if \p words is not word_count long. */
+    Maze(Words words, Cell all_cells) : Maze{std::move(words)}
+    {
+        fill(all_cells);
+    }
+
+    /// Construct a maze that adopts the existing Cells in \p words.
+    /** Throws std::invalid_argument if \p words is not word_count long. */
+    explicit Maze(Words words) : data_{std::move(words)}
+    {
+        if (std::size(data_) != word_count)
+            throw std::invalid_argument{"Maze: storage size mismatch."};
     }
 
    public:
@@ -27,15 +74,195 @@ class Maze {
     /** asserts to check bounds in debug builds, logic error if out of bounds */
     [[nodiscard]] constexpr auto get(Point p) const -> Cell
     {
-        return to_cell(data_[to_index(p)]);
+        return to_cell(detail::test_bit(words(), to_index(p)));
     }
 
     /// Set the cell at \p p to \p c.
     /** asserts to check bounds in debug builds, logic error if out of bounds */
-    constexpr void set(Point p, Cell c) { data_[to_index(p)] = to_bit(c); }
+    constexpr void set(Point p, Cell c)
+    {
+        detail::assign_bit(words(), to_index(p), to_bit(c));
+    }
+
+    /// Return the Layout bit index of \p p, for use with get_at().
+    [[nodiscard]] static constexpr auto index_of(Point p) -> std::size_t
+    {
+        return to_index(p);
+    }
+
+    /// Return the bit index of the neighbor of \p index in Direction \p d.
+    /** A single add, the Wall border stands in for the bounds check. */
+    [[nodiscard]] static constexpr auto neighbor_index(std::size_t index,
+                                                       Direction d)
+        -> std::size_t
+        requires has_sentinel_border
+    {
+        return index + Layout::template offset<Width, Height>(d);
+    }
+
+    /// Get the cell at Layout bit \p index, from index_of or neighbor_index.
+    [[nodiscard]] constexpr auto get_at(std::size_t index) const -> Cell
+    {
+        return to_cell(detail::test_bit(words(), index));
+    }
+
+    /// Set every Cell to \p c.
+    constexpr void fill(Cell c)
+    {
+        std::ranges::fill(words(), Word{0});
+        if (c == Cell::Passage)
+            Layout::template fill<Width, Height>(words());
+    }
+
+    /// Set the Cells from {\p x_first, \p y} to {\p x_last, \p y} to \p c.
+    /** Inclusive. Row contiguous Layouts write whole Words at a time. */
+    constexpr void fill_row_range(Distance y,
+                                  Distance x_first,
+                                  Distance x_last,
+                                  Cell c)
+    {
+        assert(x_first <= x_last && x_last < Width && y < Height);
+        if constexpr (detail::Row_contiguous<Layout>) {
+            auto const row = Layout::template row_begin<Width, Height>(y);
+            detail::assign_bits(words(), row + x_first, row + x_last + 1,
+                                to_bit(c));
+        }
+        else {
+            for (auto x = std::size_t{x_first}; x <= x_last; ++x)
+                set({static_cast<Distance>(x), y}, c);
+        }
+    }
+
+    /// Set the Cells in the rectangle \p top_left to \p bottom_right to \p c.
+    /** Inclusive. Row contiguous Layouts write whole Words at a time. */
+    constexpr void fill_rect(Point top_left, Point bottom_right, Cell c)
+    {
+        assert(top_left.y <= bottom_right.y);
+        for (auto y = std::size_t{top_left.y}; y <= bottom_right.y; ++y) {
+            fill_row_range(static_cast<Distance>(y), top_left.x,
+                           bottom_right.x, c);
+        }
+    }
+
+    /// Copy the rectangle \p top_left to \p bottom_right of \p source into
+    /// *this, placing \p top_left at \p to.
+    /** Inclusive. Copies a Word at a time when both Layouts are row
+     *  contiguous. \p source may be *this only if the regions don't overlap.*/
+    template <Distance Source_width,
+              Distance Source_height,
+              typename Source_layout,
+              typename Source_storage>
+    constexpr void copy_region(Maze<Source_width,
+                                    Source_height,
+                                    Source_layout,
+                                    Source_storage> const& source,
+                               Point top_left,
+                               Point bottom_right,
+                               Point to)
+    {
+        assert(top_left.x <= bottom_right.x && top_left.y <= bottom_right.y);
+        assert(bottom_right.x < Source_width && bottom_right.y < Source_height);
+        assert(to.x + (bottom_right.x - top_left.x) < Width);
+        assert(to.y + (bottom_right.y - top_left.y) < Height);
+        auto const columns = std::size_t{bottom_right.x} - top_left.x + 1;
+        auto const rows    = std::size_t{bottom_right.y} - top_left.y + 1;
+        for (auto r = std::size_t{0}; r < rows; ++r) {
+            auto const from_y = static_cast<Distance>(top_left.y + r);
+            auto const to_y   = static_cast<Distance>(to.y + r);
+            if constexpr (detail::Row_contiguous<Layout> &&
+                          detail::Row_contiguous<Source_layout>) {
+                detail::copy_bits(
+                    source.words(),
+                    Source_layout::template row_begin<Source_width,
+                                                      Source_height>(from_y) +
+                        top_left.x,
+                    words(),
+                    Layout::template row_begin<Width, Height>(to_y) + to.x,
+                    columns);
+            }
+            else {
+                for (auto c = std::size_t{0}; c < columns; ++c) {
+                    set({static_cast<Distance>(to.x + c), to_y},
+                        source.get({static_cast<Distance>(top_left.x + c),
+                                    from_y}));
+                }
+            }
+        }
+    }
+
+    /// Overwrite row \p y from \p bits, bit x of the span becomes Cell x, a
+    /// set bit is a Passage.
+    /** \p bits holds at least Width bits, any past Width are ignored. Row
+     *  contiguous Layouts copy whole Words at a time. */
+    constexpr void write_row(Distance y, std::span<Word const> bits)
+    {
+        assert(y < Height && bits.size() * word_bits >= Width);
+        if constexpr (detail::Row_contiguous<Layout>) {
+            auto const begin = Layout::template row_begin<Width, Height>(y);
+            for (auto x = std::size_t{0}; x < Width; x += word_bits) {
+                auto const count = std::min(std::size_t{Width} - x, word_bits);
+                detail::write_bits(words(), begin + x, count,
+                                   bits[x / word_bits]);
+            }
+        }
+        else {
+            for (auto x = std::size_t{0}; x < Width; ++x) {
+                set({static_cast<Distance>(x), y},
+                    to_cell(detail::test_bit(bits, x)));
+            }
+        }
+    }
+
+    /// Return the Words of row \p y, Cell x is bit x of the span.
+    /** Bits past Width in the last Word are padding and always zero. */
+    [[nodiscard]] constexpr auto row_words(Distance y) const
+        -> std::span<Word const>
+        requires std::same_as<Layout, Row_major>
+    {
+        constexpr auto per_row = Row_major::words_per_row<Width, Height>;
+        return words().subspan(y * per_row, per_row);
+    }
+
+    /// Return the Words of row \p y, Cell x is bit x of the span. Mutable.
+    /** Bits past Width in the last Word are padding and must stay zero. */
+    [[nodiscard]] constexpr auto row_words(Distance y) -> std::span<Word>
+        requires std::same_as<Layout, Row_major>
+    {
+        constexpr auto per_row = Row_major::words_per_row<Width, Height>;
+        return words().subspan(y * per_row, per_row);
+    }
+
+    /// Return the packed Cell bits, a set bit is a Passage.
+    /** Bit positions are given by Layout. Padding bits must stay zero. */
+    [[nodiscard]] constexpr auto words() const
+        -> std::span<Word const, word_count>
+    {
+        return std::span<Word const, word_count>{std::data(data_), word_count};
+    }
+
+    /// Return the packed Cell bits, a set bit is a Passage. Mutable.
+    /** Bit positions are given by Layout. Padding bits must stay zero. */
+    [[nodiscard]] constexpr auto words() -> std::span<Word, word_count>
+    {
+        return std::span<Word, word_count>{std::data(data_), word_count};
+    }
+
+    /// Return the underlying Storage container, ex. to flush a mapping.
+    [[nodiscard]] constexpr auto storage() -> Words& { return data_; }
+
+    [[nodiscard]] constexpr auto storage() const -> Words const&
+    {
+        return data_;
+    }
+
+    [[nodiscard]] friend constexpr auto operator==(Maze const& lhs,
+                                                   Maze const& rhs) -> bool
+    {
+        return std::ranges::equal(lhs.words(), rhs.words());
+    }
 
    private:
-    std::bitset<Width * Height> data_;
+    Words data_;
 
    private:
     [[nodiscard]] static constexpr auto to_bit(Cell c) -> bool
@@ -54,9 +281,7 @@ class Maze {
 
     [[nodiscard]] static constexpr auto to_index(Point p) -> std::size_t
     {
-        auto const index = (p.y * Width) + p.x;
-        assert(index < (Width * Height));
-        return index;
+        return Layout::template index<Width, Height>(p);
     }
 };
 
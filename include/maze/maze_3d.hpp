@@ -0,0 +1,228 @@
+#ifndef MAZE_MAZE_3D_HPP
+#define MAZE_MAZE_3D_HPP
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include <maze/cell.hpp>
+#include <maze/direction.hpp>
+#include <maze/distance.hpp>
+#include <maze/layout.hpp>
+#include <maze/maze.hpp>
+#include <maze/point.hpp>
+
+namespace maze {
+
+/// A Point of a Maze_3d, z is the layer counted from the top.
+struct Point_3d {
+    Distance x;
+    Distance y;
+    Distance z;
+
+    friend auto constexpr operator<=>(Point_3d lhs, Point_3d rhs) = default;
+};
+
+/// A connection between two rooms of a Maze_3d, two Cells apart.
+struct Edge_3d {
+    Point_3d a;
+    Point_3d b;
+
+    friend auto operator<=>(Edge_3d, Edge_3d) = default;
+};
+
+/// Direction in a Maze_3d, the first four have the values of Direction.
+enum class Direction_3d {
+    North,  // top
+    South,  // bottom
+    East,   // right
+    West,   // left
+    Up,     // previous layer
+    Down    // next layer
+};
+
+/// Return the Direction_3d of the 2D Direction \p d.
+[[nodiscard]] constexpr auto to_3d(Direction d) -> Direction_3d
+{
+    return static_cast<Direction_3d>(d);
+}
+
+/// Layered 3D Representation of Cells that are either Walls or Passages.
+/** Depth layers of Width x Height Cells, each a Maze<Width, Height, Layout>
+ *  stored back to back, so a layer is a packed bit plane. Like the 2D Mazes
+ *  the generators carve, rooms are the Cells at even x, y and z, and the
+ *  Cells between two rooms are their walls; a wall at odd z is a stair. */
+template <Distance Width,
+          Distance Height,
+          Distance Depth,
+          typename Layout = Row_major>
+class Maze_3d {
+    static_assert(Depth != 0);
+
+   public:
+    /// Type of a single layer.
+    using Layer = Maze<Width, Height, Layout>;
+
+    /// Number of Cells, the index space of cell_index().
+    static constexpr auto cell_count =
+        std::size_t{Width} * Height * std::size_t{Depth};
+
+   public:
+    /// Construct a maze where all Cells are initialized with \p all_cells.
+    constexpr explicit Maze_3d(Cell all_cells)
+        : layers_{make_layers(all_cells, std::make_index_sequence<Depth>{})}
+    {}
+
+   public:
+    /// Get the cell representation at Point \p p.
+    [[nodiscard]] constexpr auto get(Point_3d p) const -> Cell
+    {
+        assert(p.z < Depth);
+        return layers_[p.z].get({p.x, p.y});
+    }
+
+    /// Set the cell at \p p to \p c.
+    constexpr void set(Point_3d p, Cell c)
+    {
+        assert(p.z < Depth);
+        layers_[p.z].set({p.x, p.y}, c);
+    }
+
+    /// Set every Cell to \p c.
+    constexpr void fill(Cell c)
+    {
+        for (auto& layer : layers_)
+            layer.fill(c);
+    }
+
+    /// Return layer \p z, for the 2D generators, solvers and display.
+    [[nodiscard]] constexpr auto layer(Distance z) -> Layer&
+    {
+        assert(z < Depth);
+        return layers_[z];
+    }
+
+    /// Return layer \p z.
+    [[nodiscard]] constexpr auto layer(Distance z) const -> Layer const&
+    {
+        assert(z < Depth);
+        return layers_[z];
+    }
+
+    /// Return a dense index of \p p in [0, cell_count), layer-major.
+    [[nodiscard]] static constexpr auto cell_index(Point_3d p) -> std::size_t
+    {
+        return (((std::size_t{p.z} * Height) + p.y) * Width) + p.x;
+    }
+
+    /// Return the Point of the dense index \p i, inverse of cell_index().
+    [[nodiscard]] static constexpr auto cell_at(std::size_t i) -> Point_3d
+    {
+        return {static_cast<Distance>(i % Width),
+                static_cast<Distance>((i / Width) % Height),
+                static_cast<Distance>(i / (std::size_t{Width} * Height))};
+    }
+
+    [[nodiscard]] friend constexpr auto operator==(Maze_3d const& lhs,
+                                                   Maze_3d const& rhs) -> bool
+    {
+        return std::ranges::equal(lhs.layers_, rhs.layers_);
+    }
+
+   private:
+    std::array<Layer, Depth> layers_;
+
+   private:
+    template <std::size_t... Zs>
+    [[nodiscard]] static constexpr auto make_layers(
+        Cell c,
+        std::index_sequence<Zs...>) -> std::array<Layer, Depth>
+    {
+        return {((void)Zs, Layer{c})...};
+    }
+};
+
+}  // namespace maze
+
+namespace maze::utility {
+
+/// Every Direction_3d, planar ones first.
+inline constexpr auto directions_3d =
+    std::array{Direction_3d::North, Direction_3d::South, Direction_3d::East,
+               Direction_3d::West,  Direction_3d::Up,    Direction_3d::Down};
+
+/// Return adjacent Point to \p p in Direction \p d, without bounds checks.
+[[nodiscard]] constexpr auto step(Point_3d p, Direction_3d d) -> Point_3d
+{
+    switch (d) {
+        case Direction_3d::North: return {p.x, (Distance)(p.y - 1), p.z};
+        case Direction_3d::South: return {p.x, (Distance)(p.y + 1), p.z};
+        case Direction_3d::East: return {(Distance)(p.x + 1), p.y, p.z};
+        case Direction_3d::West: return {(Distance)(p.x - 1), p.y, p.z};
+        case Direction_3d::Up: return {p.x, p.y, (Distance)(p.z - 1)};
+        case Direction_3d::Down: return {p.x, p.y, (Distance)(p.z + 1)};
+        default: throw std::logic_error{"Invalid Direction_3d"};
+    }
+}
+
+/// Return the opposite direction of \p d.
+[[nodiscard]] constexpr auto opposite(Direction_3d d) -> Direction_3d
+{
+    // Directions come in pairs, each the opposite of the other.
+    return static_cast<Direction_3d>(static_cast<int>(d) ^ 1);
+}
+
+/// Return adjacent Point to \p p in Direction \p d.
+/** Returns std::nullopt if outside of a Width x Height x Depth maze. */
+template <Distance Width, Distance Height, Distance Depth>
+[[nodiscard]] constexpr auto next_point(Point_3d p, Direction_3d d)
+    -> std::optional<Point_3d>
+{
+    auto const inside = [&] {
+        switch (d) {
+            case Direction_3d::North: return p.y != 0;
+            case Direction_3d::South: return p.y + 1 < Height;
+            case Direction_3d::East: return p.x + 1 < Width;
+            case Direction_3d::West: return p.x != 0;
+            case Direction_3d::Up: return p.z != 0;
+            case Direction_3d::Down: return p.z + 1 < Depth;
+            default: throw std::logic_error{"Invalid Direction_3d"};
+        }
+    }();
+    if (!inside)
+        return std::nullopt;
+    return step(p, d);
+}
+
+/// Return the adjacent Point to \p p in Direction \p d if it is a Passage.
+/** Returns std::nullopt for Walls and for Points outside of \p maze. */
+template <Distance Width, Distance Height, Distance Depth, typename Layout>
+[[nodiscard]] constexpr auto next_passage(
+    Maze_3d<Width, Height, Depth, Layout> const& maze,
+    Point_3d p,
+    Direction_3d d) -> std::optional<Point_3d>
+{
+    auto const next = next_point<Width, Height, Depth>(p, d);
+    if (next.has_value() && maze.get(*next) == Cell::Passage)
+        return next;
+    return std::nullopt;
+}
+
+/// Return the number of Cell::Passages adjacent to \p p in \p maze.
+template <Distance Width, Distance Height, Distance Depth, typename Layout>
+[[nodiscard]] constexpr auto passage_count(
+    Maze_3d<Width, Height, Depth, Layout> const& maze,
+    Point_3d p) -> int
+{
+    auto count = 0;
+    for (auto const direction : directions_3d)
+        count += next_passage(maze, p, direction).has_value();
+    return count;
+}
+
+}  // namespace maze::utility
+#endif  // MAZE_MAZE_3D_HPP
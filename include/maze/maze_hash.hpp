@@ -0,0 +1,274 @@
+#ifndef MAZE_MAZE_HASH_HPP
+#define MAZE_MAZE_HASH_HPP
+#include <array>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <maze/cell_grid.hpp>
+#include <maze/distance.hpp>
+#include <maze/layout.hpp>
+#include <maze/maze.hpp>
+#include <maze/point.hpp>
+#include <maze/random.hpp>
+#include <maze/verify.hpp>
+
+namespace maze {
+
+/// 128 bit hash of a Maze's Cells and size.
+struct Maze_hash {
+    std::uint64_t high = 0;
+    std::uint64_t low  = 0;
+
+    friend auto constexpr operator<=>(Maze_hash, Maze_hash) = default;
+};
+
+/// One of the 8 symmetries of a grid: a transpose, then mirror images.
+/** Applied to a Width x Height grid, a transpose swaps x and y and gives a
+ *  Height x Width grid, then flip_x mirrors x and flip_y mirrors y. */
+struct Symmetry {
+    bool transpose = false;
+    bool flip_x    = false;
+    bool flip_y    = false;
+
+    friend auto constexpr operator==(Symmetry, Symmetry) -> bool = default;
+};
+
+/// Return where \p s takes \p p of a \p width x \p height grid.
+[[nodiscard]] constexpr auto apply(Symmetry s,
+                                   Point p,
+                                   Distance width,
+                                   Distance height) -> Point
+{
+    if (s.transpose) {
+        std::swap(p.x, p.y);
+        std::swap(width, height);
+    }
+    if (s.flip_x)
+        p.x = static_cast<Distance>(width - 1 - p.x);
+    if (s.flip_y)
+        p.y = static_cast<Distance>(height - 1 - p.y);
+    return p;
+}
+
+/// Return where the inverse of \p s takes \p p, of the grid \p s produced
+/// from a \p width x \p height grid.
+[[nodiscard]] constexpr auto unapply(Symmetry s,
+                                     Point p,
+                                     Distance width,
+                                     Distance height) -> Point
+{
+    if (s.transpose)
+        std::swap(width, height);
+    if (s.flip_x)
+        p.x = static_cast<Distance>(width - 1 - p.x);
+    if (s.flip_y)
+        p.y = static_cast<Distance>(height - 1 - p.y);
+    if (s.transpose)
+        std::swap(p.x, p.y);
+    return p;
+}
+
+/// A Maze's hash in canonical orientation, and the Symmetry that takes the
+/// Maze there.
+struct Canonical_hash {
+    Maze_hash hash;
+    Symmetry symmetry;
+
+    friend auto constexpr operator==(Canonical_hash, Canonical_hash)
+        -> bool = default;
+};
+
+}  // namespace maze
+
+namespace maze::detail {
+
+/// Return \p w with its bit order reversed.
+[[nodiscard]] constexpr auto reverse_bits(Word w) -> Word
+{
+    auto shift = std::size_t{1};
+    for (auto const mask : {Word{0x5555'5555'5555'5555},
+                            Word{0x3333'3333'3333'3333},
+                            Word{0x0F0F'0F0F'0F0F'0F0F},
+                            Word{0x00FF'00FF'00FF'00FF},
+                            Word{0x0000'FFFF'0000'FFFF}}) {
+        w = ((w >> shift) & mask) | ((w & mask) << shift);
+        shift *= 2;
+    }
+    return std::rotl(w, 32);
+}
+
+/// Transpose the 64 x 64 bit matrix \p block, bit c of Word r is row r,
+/// column c.
+/** Swaps ever smaller off diagonal quadrants, 6 rounds of 32 Word swaps. */
+constexpr void transpose_64(std::span<Word, word_bits> block)
+{
+    auto mask = Word{0x0000'0000'FFFF'FFFF};
+    for (auto j = std::size_t{32}; j != 0; j >>= 1, mask ^= mask << j) {
+        for (auto k = std::size_t{0}; k < word_bits; k = ((k | j) + 1) & ~j) {
+            auto const t = ((block[k] >> j) ^ block[k | j]) & mask;
+            block[k] ^= t << j;
+            block[k | j] ^= t;
+        }
+    }
+}
+
+/// A grid of bits, rows padded to whole Words, padding bits zero.
+struct Bit_grid {
+    std::size_t width  = 0;
+    std::size_t height = 0;
+    std::vector<Word> words;
+
+    [[nodiscard]] constexpr auto stride() const -> std::size_t
+    {
+        return (width + word_bits - 1) / word_bits;
+    }
+
+    [[nodiscard]] constexpr auto row(std::size_t y) -> std::span<Word>
+    {
+        return std::span{words}.subspan(y * stride(), stride());
+    }
+
+    [[nodiscard]] constexpr auto row(std::size_t y) const
+        -> std::span<Word const>
+    {
+        return std::span{words}.subspan(y * stride(), stride());
+    }
+};
+
+/// Return the Cells of \p maze as a Bit_grid, a Passage is a set bit.
+template <Cell_grid G>
+[[nodiscard]] auto to_bit_grid(G const& maze) -> Bit_grid
+{
+    auto grid = Bit_grid{G::width, G::height, {}};
+    grid.words.resize(grid.stride() * G::height);
+    for (auto y = Distance{0}; y < G::height; ++y) {
+        auto const row = grid.row(y);
+        for (auto i = std::size_t{0}; i < row.size(); ++i)
+            row[i] = row_chunk(maze, y, i);
+    }
+    return grid;
+}
+
+/// Return \p grid mirrored in x: reversed Word order, reversed bits, then
+/// shifted down past the padding.
+[[nodiscard]] inline auto flip_x(Bit_grid const& grid) -> Bit_grid
+{
+    auto result       = Bit_grid{grid.width, grid.height, {}};
+    auto const stride = grid.stride();
+    auto const pad    = (stride * word_bits) - grid.width;
+    result.words.resize(grid.words.size());
+    for (auto y = std::size_t{0}; y < grid.height; ++y) {
+        auto const from = grid.row(y);
+        auto const to   = result.row(y);
+        for (auto i = std::size_t{0}; i < stride; ++i)
+            to[i] = reverse_bits(from[stride - 1 - i]);
+        if (pad == 0)
+            continue;
+        for (auto i = std::size_t{0}; i < stride; ++i) {
+            to[i] >>= pad;
+            if (i + 1 < stride)
+                to[i] |= to[i + 1] << (word_bits - pad);
+        }
+    }
+    return result;
+}
+
+/// Return \p grid mirrored in y, its rows reversed.
+[[nodiscard]] inline auto flip_y(Bit_grid const& grid) -> Bit_grid
+{
+    auto result = Bit_grid{grid.width, grid.height, {}};
+    result.words.reserve(grid.words.size());
+    for (auto y = grid.height; y-- != 0;) {
+        auto const row = grid.row(y);
+        result.words.insert(result.words.end(), row.begin(), row.end());
+    }
+    return result;
+}
+
+/// Return \p grid transposed, 64 x 64 blocks at a time.
+[[nodiscard]] inline auto transpose(Bit_grid const& grid) -> Bit_grid
+{
+    auto result = Bit_grid{grid.height, grid.width, {}};
+    result.words.resize(result.stride() * result.height);
+    auto block = std::array<Word, word_bits>{};
+    for (auto by = std::size_t{0}; by < grid.height; by += word_bits) {
+        for (auto bx = std::size_t{0}; bx < grid.width; bx += word_bits) {
+            for (auto k = std::size_t{0}; k < word_bits; ++k) {
+                block[k] = by + k < grid.height
+                               ? grid.row(by + k)[bx / word_bits]
+                               : Word{0};
+            }
+            transpose_64(block);
+            for (auto k = std::size_t{0};
+                 k < word_bits && bx + k < grid.width; ++k)
+                result.row(bx + k)[by / word_bits] = block[k];
+        }
+    }
+    return result;
+}
+
+/// Return the hash of \p grid's bits and size.
+/** Two multiply-rotate lanes over every Word, each finished with the
+ *  SplitMix64 finalizer. */
+[[nodiscard]] inline auto hash_grid(Bit_grid const& grid) -> Maze_hash
+{
+    auto a = Splitmix64{(grid.width << 32) ^ grid.height}();
+    auto b = Splitmix64{~a}();
+    for (auto const w : grid.words) {
+        a = std::rotl((a ^ w) * 0x9E37'79B9'7F4A'7C15, 29);
+        b = std::rotl((b + w) * 0xC2B2'AE3D'27D4'EB4F, 31) ^ a;
+    }
+    return {Splitmix64{b}(), Splitmix64{a}()};
+}
+
+}  // namespace maze::detail
+
+namespace maze {
+
+/// Return the 128 bit hash of the Cells and size of \p m.
+/** Equal for equal Cells whatever the Layout or Storage, and for a
+ *  Wall_maze and its equivalent Maze. Not cryptographic, only for telling
+ *  Mazes apart. */
+template <Cell_grid G>
+[[nodiscard]] auto maze_hash(G const& m) -> Maze_hash
+{
+    return detail::hash_grid(detail::to_bit_grid(m));
+}
+
+/// Return the hash of \p m that is the same for all 8 of its rotations and
+/// mirror images, and the Symmetry taking \p m to the orientation hashed.
+/** The orientation hashed is the one whose maze_hash() is least. A transpose of
+ *  64 x 64 bit blocks and a flip_x of reversed Words give the other
+ *  orientations, linear in the size of \p m. */
+template <Cell_grid G>
+[[nodiscard]] auto canonical_hash(G const& m) -> Canonical_hash
+{
+    auto best = Canonical_hash{};
+    auto any  = false;
+    auto const consider = [&](detail::Bit_grid const& grid, Symmetry s) {
+        auto const h = detail::hash_grid(grid);
+        if (!any || h < best.hash)
+            best = {h, s};
+        any = true;
+    };
+
+    auto const grid = detail::to_bit_grid(m);
+    for (auto const transpose : {false, true}) {
+        auto const base = transpose ? detail::transpose(grid) : grid;
+        auto const x    = detail::flip_x(base);
+        consider(base, {transpose, false, false});
+        consider(x, {transpose, true, false});
+        consider(detail::flip_y(base), {transpose, false, true});
+        consider(detail::flip_y(x), {transpose, true, true});
+    }
+    return best;
+}
+
+}  // namespace maze
+#endif  // MAZE_MAZE_HASH_HPP
@@ -0,0 +1,70 @@
+#ifndef MAZE_MAZE_VIEW_HPP
+#define MAZE_MAZE_VIEW_HPP
+#include <algorithm>
+#include <span>
+#include <stdexcept>
+
+#include <maze/cell.hpp>
+#include <maze/distance.hpp>
+#include <maze/layout.hpp>
+#include <maze/maze.hpp>
+#include <maze/point.hpp>
+
+namespace maze {
+
+/// Read-only, non-owning view of packed Cell bits with the Maze get API.
+/** The viewed Words must outlive the view, no copy of the bits is made. */
+template <Distance Width, Distance Height, typename Layout = Row_major>
+class Maze_view {
+   public:
+    /// Size in Cells, as for every Cell_grid.
+    static constexpr auto width  = Width;
+    static constexpr auto height = Height;
+
+    static constexpr auto word_count =
+        Layout::template word_count<Width, Height>;
+
+   public:
+    /// View \p words, laid out as Maze<Width, Height>::words().
+    constexpr explicit Maze_view(std::span<Word const, word_count> words)
+        : words_{words}
+    {}
+
+    /// View the Cells of \p maze.
+    template <typename Storage>
+    constexpr Maze_view(Maze<Width, Height, Layout, Storage> const& maze)
+        : words_{maze.words()}
+    {}
+
+   public:
+    /// Get the cell representation at Point \p p.
+    [[nodiscard]] constexpr auto get(Point p) const -> Cell
+    {
+        return detail::test_bit(words_,
+                                Layout::template index<Width, Height>(p))
+                   ? Cell::Passage
+                   : Cell::Wall;
+    }
+
+    /// Return the viewed Words.
+    [[nodiscard]] constexpr auto words() const
+        -> std::span<Word const, word_count>
+    {
+        return words_;
+    }
+
+    /// Return an owning copy of the viewed Cells.
+    [[nodiscard]] constexpr auto to_maze() const
+        -> Maze<Width, Height, Layout>
+    {
+        auto result = Maze<Width, Height, Layout>{Cell::Wall};
+        std::ranges::copy(words_, std::begin(result.words()));
+        return result;
+    }
+
+   private:
+    std::span<Word const, word_count> words_;
+};
+
+}  // namespace maze
+#endif  // MAZE_MAZE_VIEW_HPP
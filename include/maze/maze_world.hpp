@@ -0,0 +1,297 @@
+#ifndef MAZE_MAZE_WORLD_HPP
+#define MAZE_MAZE_WORLD_HPP
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <maze/async.hpp>
+#include <maze/cell.hpp>
+#include <maze/distance.hpp>
+#include <maze/generator_pool.hpp>
+#include <maze/layout.hpp>
+#include <maze/maze.hpp>
+#include <maze/point.hpp>
+#include <maze/serialize.hpp>
+
+namespace maze {
+
+/// Cell position in an unbounded Maze_world.
+struct World_point {
+    std::int64_t x;
+    std::int64_t y;
+
+    friend auto constexpr operator==(World_point, World_point)
+        -> bool = default;
+};
+
+/// Position of a chunk in a Maze_world, in chunks.
+struct Chunk_coord {
+    std::int64_t x;
+    std::int64_t y;
+
+    friend auto constexpr operator==(Chunk_coord, Chunk_coord)
+        -> bool = default;
+};
+
+}  // namespace maze
+
+namespace maze::detail {
+
+/// Return \p a / \p b rounded towards negative infinity, \p b > 0.
+[[nodiscard]] constexpr auto floor_div(std::int64_t a, std::int64_t b)
+    -> std::int64_t
+{
+    return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+/// Return the seed of chunk \p c in a world seeded with \p seed.
+[[nodiscard]] constexpr auto chunk_seed(std::uint64_t seed, Chunk_coord c)
+    -> std::uint64_t
+{
+    return mix_seed(mix_seed(seed, static_cast<std::uint64_t>(c.x)),
+                    static_cast<std::uint64_t>(c.y));
+}
+
+/// Hashes a Chunk_coord for the chunk cache.
+struct Chunk_coord_hash {
+    [[nodiscard]] auto operator()(Chunk_coord c) const -> std::size_t
+    {
+        return static_cast<std::size_t>(chunk_seed(0, c));
+    }
+};
+
+}  // namespace maze::detail
+
+namespace maze {
+
+/// An unbounded maze made of Width x Height chunks, generated on demand.
+/** The plane is tiled every (Width + 1) x (Height + 1) cells: a chunk, then a
+ *  one cell seam column to its East and seam row to its South. Each chunk is
+ *  generated from a seed hashed from the world seed and its Chunk_coord, and
+ *  each seam has a single opening at a room picked from the same hash, so
+ *  every chunk connects to its four neighbors and any cell is reproducible
+ *  without generating anything else. Chunks are perfect mazes, loops only
+ *  appear across chunks.
+ *
+ *  At most capacity() chunks stay cached, least recently used first out.
+ *  Chunks are shared, a chunk handed out stays valid after eviction. All
+ *  members are safe to call from several threads. */
+template <Distance Width, Distance Height, typename Layout = Row_major>
+class Maze_world {
+    static_assert(Width % 2 == 1 && Height % 2 == 1,
+                  "Maze_world: chunk rooms must reach every chunk edge.");
+
+   public:
+    using Chunk = Maze<Width, Height, Layout>;
+
+   public:
+    /// Create a world of \p id chunks from \p seed, caching \p capacity
+    /// chunks.
+    /** Throws std::invalid_argument on an Unknown id or zero capacity. */
+    Maze_world(std::uint64_t seed, Generator_id id, std::size_t capacity)
+        : state_{std::make_shared<State>(seed, id, capacity)}
+    {
+        if (id == Generator_id::Unknown)
+            throw std::invalid_argument{"Maze_world: Unknown Generator_id."};
+        if (capacity == 0)
+            throw std::invalid_argument{"Maze_world: zero capacity."};
+    }
+
+   public:
+    /// Return the Cell at \p p, generating its chunk if it is not cached.
+    [[nodiscard]] auto get(World_point p) -> Cell
+    {
+        auto const c = chunk_of(p);
+        auto const x = p.x - (c.x * period_x);
+        auto const y = p.y - (c.y * period_y);
+        if (x == Width && y == Height)
+            return Cell::Wall;
+        if (x == Width)
+            return y == east_opening(c) ? Cell::Passage : Cell::Wall;
+        if (y == Height)
+            return x == south_opening(c) ? Cell::Passage : Cell::Wall;
+        return chunk(c)->get(
+            {static_cast<Distance>(x), static_cast<Distance>(y)});
+    }
+
+    /// Return chunk \p c, generating it if it is not cached.
+    [[nodiscard]] auto chunk(Chunk_coord c) -> std::shared_ptr<Chunk const>
+    {
+        return state_->chunk(c);
+    }
+
+    /// Generate the chunks within \p radius chunks of \p observer on
+    /// \p executor, skipping those already cached.
+    /** The tasks keep the cache alive, so the world may be destroyed first. */
+    template <Executor E>
+    void prefetch(E& executor, World_point observer, std::int64_t radius)
+    {
+        auto const center = chunk_of(observer);
+        for (auto dy = -radius; dy <= radius; ++dy) {
+            for (auto dx = -radius; dx <= radius; ++dx) {
+                auto const c = Chunk_coord{center.x + dx, center.y + dy};
+                if (!state_->claim(c))
+                    continue;
+                try {
+                    executor.execute([state = state_, c] { state->chunk(c); });
+                }
+                catch (...) {
+                    state_->release(c);
+                    throw;
+                }
+            }
+        }
+    }
+
+    /// Return the chunk holding \p p.
+    [[nodiscard]] static constexpr auto chunk_of(World_point p) -> Chunk_coord
+    {
+        return {detail::floor_div(p.x, period_x),
+                detail::floor_div(p.y, period_y)};
+    }
+
+    /// Return the row of the opening in the seam East of chunk \p c.
+    [[nodiscard]] auto east_opening(Chunk_coord c) const -> std::int64_t
+    {
+        auto const hash = detail::mix_seed(state_->chunk_seed(c), 1);
+        return 2 * static_cast<std::int64_t>(hash % ((Height + 1) / 2));
+    }
+
+    /// Return the column of the opening in the seam South of chunk \p c.
+    [[nodiscard]] auto south_opening(Chunk_coord c) const -> std::int64_t
+    {
+        auto const hash = detail::mix_seed(state_->chunk_seed(c), 2);
+        return 2 * static_cast<std::int64_t>(hash % ((Width + 1) / 2));
+    }
+
+    /// Return the number of chunks currently cached.
+    [[nodiscard]] auto cached_count() const -> std::size_t
+    {
+        return state_->cached_count();
+    }
+
+    /// Return the maximum number of chunks cached.
+    [[nodiscard]] auto capacity() const -> std::size_t
+    {
+        return state_->capacity;
+    }
+
+   private:
+    static constexpr auto period_x = std::int64_t{Width} + 1;
+    static constexpr auto period_y = std::int64_t{Height} + 1;
+
+    /// Cache and generator scratch, shared with prefetch tasks.
+    struct State {
+        struct Entry {
+            Chunk_coord coord;
+            std::shared_ptr<Chunk const> chunk;
+        };
+        using Lru = std::list<Entry>;
+
+        State(std::uint64_t world_seed,
+              Generator_id generator,
+              std::size_t max_chunks)
+            : seed{world_seed}, id{generator}, capacity{max_chunks}
+        {}
+
+        std::uint64_t const seed;
+        Generator_id const id;
+        std::size_t const capacity;
+
+        mutable std::mutex mutex;  // Guards everything below.
+        Lru lru;                   // Most recently used first.
+        std::unordered_map<Chunk_coord,
+                           typename Lru::iterator,
+                           detail::Chunk_coord_hash>
+            index;
+        std::unordered_set<Chunk_coord, detail::Chunk_coord_hash> pending;
+        std::vector<std::unique_ptr<Generator_workspace>> workspaces;
+
+        [[nodiscard]] auto chunk_seed(Chunk_coord c) const -> std::uint64_t
+        {
+            return detail::chunk_seed(seed, c);
+        }
+
+        [[nodiscard]] auto cached_count() const -> std::size_t
+        {
+            auto const lock = std::lock_guard{mutex};
+            return lru.size();
+        }
+
+        /// Mark \p c as being prefetched, false if cached or already pending.
+        auto claim(Chunk_coord c) -> bool
+        {
+            auto const lock = std::lock_guard{mutex};
+            return !index.contains(c) && pending.insert(c).second;
+        }
+
+        /// Undo claim(\p c), a prefetch of \p c that will not run.
+        void release(Chunk_coord c)
+        {
+            auto const lock = std::lock_guard{mutex};
+            pending.erase(c);
+        }
+
+        /// Return chunk \p c from the cache, or generate and insert it.
+        /** Generation runs unlocked, two threads may race to make the same
+         *  chunk; both get identical Cells and the first insert wins. If
+         *  generation throws, \p c is no longer pending and the exception
+         *  propagates. */
+        auto chunk(Chunk_coord c) -> std::shared_ptr<Chunk const>
+        {
+            auto workspace = std::unique_ptr<Generator_workspace>{};
+            {
+                auto const lock = std::lock_guard{mutex};
+                if (auto const found = index.find(c); found != index.end()) {
+                    lru.splice(lru.begin(), lru, found->second);
+                    return found->second->chunk;
+                }
+                if (!workspaces.empty()) {
+                    workspace = std::move(workspaces.back());
+                    workspaces.pop_back();
+                }
+            }
+            auto made = std::shared_ptr<Chunk>{};
+            try {
+                if (workspace == nullptr)
+                    workspace = std::make_unique<Generator_workspace>();
+                made     = std::make_shared<Chunk>(Cell::Wall);
+                auto gen = std::mt19937_64{chunk_seed(c)};
+                generate_into(id, *made, *workspace, gen);
+            }
+            catch (...) {
+                release(c);
+                throw;
+            }
+
+            auto const lock = std::lock_guard{mutex};
+            workspaces.push_back(std::move(workspace));
+            pending.erase(c);
+            if (auto const found = index.find(c); found != index.end()) {
+                lru.splice(lru.begin(), lru, found->second);
+                return found->second->chunk;
+            }
+            lru.push_front({c, std::move(made)});
+            index.emplace(c, lru.begin());
+            if (lru.size() > capacity) {
+                index.erase(lru.back().coord);
+                lru.pop_back();
+            }
+            return lru.front().chunk;
+        }
+    };
+
+   private:
+    std::shared_ptr<State> state_;
+};
+
+}  // namespace maze
+#endif  // MAZE_MAZE_WORLD_HPP
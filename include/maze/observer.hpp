@@ -0,0 +1,249 @@
+#ifndef MAZE_OBSERVER_HPP
+#define MAZE_OBSERVER_HPP
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace maze {
+
+/// Quantities reported by instrumented algorithms.
+enum class Counter : std::uint8_t {
+    Walk_steps,     // Aldous Broder: random walk moves, a count.
+    Frontier_size,  // Prim's: frontier Edges, a gauge.
+    Edges_checked,  // Kruskal: Edges tested for a merge, a count.
+    Merges,         // Kruskal: sets merged, a count.
+    Path_depth,     // longest_path: search depth, a gauge.
+    Leaves,         // longest_path: leaves searched from, a count.
+    Words_scanned   // Hunt-and-Kill: room mask Words hunted, a count.
+};
+
+/// Number of Counter values.
+inline constexpr auto counter_count = std::size_t{7};
+
+/// Return the snake case name of \p c.
+[[nodiscard]] constexpr auto to_string(Counter c) -> std::string_view
+{
+    switch (c) {
+        case Counter::Walk_steps: return "walk_steps";
+        case Counter::Frontier_size: return "frontier_size";
+        case Counter::Edges_checked: return "edges_checked";
+        case Counter::Merges: return "merges";
+        case Counter::Path_depth: return "path_depth";
+        case Counter::Leaves: return "leaves";
+        case Counter::Words_scanned: return "words_scanned";
+    }
+    return "unknown";
+}
+
+/// Receives counters and phases from instrumented algorithms.
+/** Observers are small handles passed by value. count() adds to a running
+ *  total, gauge() reports a current level of which the peak is of interest.
+ *  Phases nest. */
+template <typename T>
+concept Observer = std::copy_constructible<T> &&
+                   requires(T const observer,
+                            Counter c,
+                            std::size_t n,
+                            std::string_view name) {
+                       observer.count(c, n);
+                       observer.gauge(c, n);
+                       observer.begin_phase(name);
+                       observer.end_phase();
+                   };
+
+/// Observer that records nothing, the default. Every hook compiles away.
+struct Null_observer {
+    constexpr void count(Counter, std::size_t) const {}
+    constexpr void gauge(Counter, std::size_t) const {}
+    constexpr void begin_phase(std::string_view) const {}
+    constexpr void end_phase() const {}
+};
+
+}  // namespace maze
+
+namespace maze::detail {
+
+/// Reports a phase to an Observer for the lifetime of this object.
+template <Observer O>
+class Phase_scope {
+   public:
+    constexpr Phase_scope(O observer, std::string_view name)
+        : observer_{observer}
+    {
+        observer_.begin_phase(name);
+    }
+
+    Phase_scope(Phase_scope const&) = delete;
+    auto operator=(Phase_scope const&) -> Phase_scope& = delete;
+
+    constexpr ~Phase_scope() { observer_.end_phase(); }
+
+   private:
+    O observer_;
+};
+
+}  // namespace maze::detail
+
+namespace maze {
+
+class Trace_recorder;
+
+/// Observer handle that forwards to a Trace_recorder.
+struct Trace_observer {
+    Trace_recorder* recorder;
+
+    void count(Counter c, std::size_t n) const;
+    void gauge(Counter c, std::size_t n) const;
+    void begin_phase(std::string_view name) const;
+    void end_phase() const;
+};
+
+/// Records counter totals, gauge peaks and timed phases.
+/** write_chrome_trace() exports the phases as a Chrome trace / Perfetto
+ *  timeline, with each phase's counters as counter events at its end. Phase
+ *  names must outlive the recorder, ex. string literals. Not thread safe,
+ *  use one recorder per thread. */
+class Trace_recorder {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+   public:
+    Trace_recorder() : origin_{Clock::now()} {}
+
+   public:
+    /// Return an Observer that records into *this.
+    [[nodiscard]] auto observer() -> Trace_observer { return {this}; }
+
+    /// Return the total of count Counter \p c, or the peak of gauge \p c.
+    [[nodiscard]] auto value(Counter c) const -> std::uint64_t
+    {
+        return totals_[index(c)];
+    }
+
+    void count(Counter c, std::size_t n)
+    {
+        totals_[index(c)] += n;
+        if (!open_.empty())
+            open_.back().values[index(c)] += n;
+    }
+
+    void gauge(Counter c, std::size_t n)
+    {
+        auto& peak = totals_[index(c)];
+        peak       = std::max<std::uint64_t>(peak, n);
+        if (!open_.empty()) {
+            auto& phase_peak = open_.back().values[index(c)];
+            phase_peak       = std::max<std::uint64_t>(phase_peak, n);
+        }
+    }
+
+    void begin_phase(std::string_view name)
+    {
+        auto const now = elapsed();
+        events_.push_back({name, 'B', now, 0});
+        open_.push_back({{}, name});
+    }
+
+    /// Close the innermost phase, recording its counters.
+    void end_phase()
+    {
+        auto const now = elapsed();
+        if (open_.empty())
+            return;
+        auto const closed = open_.back();
+        open_.pop_back();
+        for (auto i = std::size_t{0}; i < counter_count; ++i) {
+            if (closed.values[i] == 0)
+                continue;
+            auto const c = static_cast<Counter>(i);
+            events_.push_back({to_string(c), 'C', now, closed.values[i]});
+            // Fold into the enclosing phase.
+            if (!open_.empty()) {
+                auto& outer = open_.back().values[i];
+                outer = is_gauge(c) ? std::max(outer, closed.values[i])
+                                    : outer + closed.values[i];
+            }
+        }
+        events_.push_back({closed.name, 'E', now, 0});
+    }
+
+    /// Write every recorded event as Chrome trace event format JSON.
+    /** Load the output in chrome://tracing or ui.perfetto.dev. */
+    void write_chrome_trace(std::ostream& os) const
+    {
+        os << "{\"traceEvents\":[";
+        auto first = true;
+        for (auto const& e : events_) {
+            os << (first ? "\n" : ",\n") << "{\"name\":\"" << e.name
+               << "\",\"ph\":\"" << e.phase << "\",\"ts\":" << e.micros
+               << ",\"pid\":1,\"tid\":1";
+            if (e.phase == 'C')
+                os << ",\"args\":{\"value\":" << e.value << '}';
+            os << '}';
+            first = false;
+        }
+        os << "\n]}\n";
+    }
+
+   private:
+    struct Event {
+        std::string_view name;
+        char phase;  // 'B'egin, 'E'nd or 'C'ounter.
+        double micros;
+        std::uint64_t value;
+    };
+
+    struct Open_phase {
+        std::array<std::uint64_t, counter_count> values;
+        std::string_view name;
+    };
+
+    Clock::time_point origin_;
+    std::array<std::uint64_t, counter_count> totals_ = {};
+    std::vector<Open_phase> open_;
+    std::vector<Event> events_;
+
+   private:
+    [[nodiscard]] static auto index(Counter c) -> std::size_t
+    {
+        return static_cast<std::size_t>(c);
+    }
+
+    [[nodiscard]] static auto is_gauge(Counter c) -> bool
+    {
+        return c == Counter::Frontier_size || c == Counter::Path_depth;
+    }
+
+    [[nodiscard]] auto elapsed() const -> double
+    {
+        return std::chrono::duration<double, std::micro>(Clock::now() -
+                                                         origin_)
+            .count();
+    }
+};
+
+inline void Trace_observer::count(Counter c, std::size_t n) const
+{
+    recorder->count(c, n);
+}
+
+inline void Trace_observer::gauge(Counter c, std::size_t n) const
+{
+    recorder->gauge(c, n);
+}
+
+inline void Trace_observer::begin_phase(std::string_view name) const
+{
+    recorder->begin_phase(name);
+}
+
+inline void Trace_observer::end_phase() const { recorder->end_phase(); }
+
+}  // namespace maze
+#endif  // MAZE_OBSERVER_HPP
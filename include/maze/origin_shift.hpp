@@ -0,0 +1,202 @@
+#ifndef MAZE_ORIGIN_SHIFT_HPP
+#define MAZE_ORIGIN_SHIFT_HPP
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <maze/cell.hpp>
+#include <maze/direction.hpp>
+#include <maze/distance.hpp>
+#include <maze/layout.hpp>
+#include <maze/maze.hpp>
+#include <maze/point.hpp>
+#include <maze/random.hpp>
+#include <maze/stepper.hpp>
+#include <maze/utility.hpp>
+
+namespace maze {
+
+/// Walls changed by a single Origin_shift_maze::shift().
+/** Both are std::nullopt when the new root already pointed at the old one, the
+ *  edge only reverses and the Maze is unchanged. */
+struct Origin_shift_change {
+    /// The new root room, in Maze coordinates.
+    Point root;
+    /// Wall cell that became a Passage.
+    std::optional<Point> opened;
+    /// Wall cell that became a Wall.
+    std::optional<Point> closed;
+
+    friend auto constexpr operator==(Origin_shift_change const&,
+                                     Origin_shift_change const&)
+        -> bool = default;
+};
+
+/// A perfect Maze kept as a tree of rooms rooted at a moving origin.
+/** Every room but the root points to its parent. Each shift() moves the root
+ *  to a random neighboring room, points the old root at it and drops the new
+ *  root's parent edge, so the Maze stays perfect and changes by at most two
+ *  wall cells, in O(1). The Maze must outlive this object and is only written
+ *  by it. One byte of parent Direction per room. */
+template <Distance Width,
+          Distance Height,
+          typename Layout,
+          typename Storage,
+          std::uniform_random_bit_generator Gen = std::mt19937>
+class Origin_shift_maze {
+   public:
+    using Maze_type = Maze<Width, Height, Layout, Storage>;
+
+    /// Rooms per row, at every even x.
+    static constexpr auto columns = static_cast<Distance>((Width + 1) / 2);
+
+    /// Rows of rooms, at every even y.
+    static constexpr auto rows = static_cast<Distance>((Height + 1) / 2);
+
+   public:
+    /// Adopt the perfect maze in \p m, rooted at a random room.
+    /** Fill \p m with any generator first. Throws std::invalid_argument if the
+     *  rooms of \p m and the walls between them do not form a spanning tree. */
+    explicit Origin_shift_maze(Maze<Width, Height, Layout, Storage>& m,
+                               Gen gen = Gen{std::random_device{}()})
+        : maze_{m},
+          gen_{std::move(gen)},
+          root_{utility::random_point<columns, rows>(gen_)},
+          parent_(std::size_t{columns} * rows, unvisited)
+    {
+        adopt();
+    }
+
+   public:
+    /// Move the root to a random neighboring room.
+    auto shift() -> Origin_shift_change
+    {
+        auto options = std::array<Direction, 4>{};
+        auto count   = std::size_t{0};
+        for (auto const d : utility::directions) {
+            if (utility::next_point<columns, rows>(root_, d))
+                options[count++] = d;
+        }
+        // A single room has nowhere to go.
+        if (count == 0)
+            return {root(), std::nullopt, std::nullopt};
+
+        auto const d       = options[detail::uniform_to(gen_, count - 1)];
+        auto const next    = utility::step(root_, d);
+        auto const old_dir = parent_[index(next)];
+        auto change  = Origin_shift_change{
+            utility::times_two(next), std::nullopt, std::nullopt};
+        if (old_dir != static_cast<std::uint8_t>(utility::opposite(d))) {
+            change.opened = wall_between(root_, d);
+            change.closed =
+                wall_between(next, static_cast<Direction>(old_dir));
+            maze_.set(*change.opened, Cell::Passage);
+            maze_.set(*change.closed, Cell::Wall);
+        }
+        parent_[index(root_)] = static_cast<std::uint8_t>(d);
+        parent_[index(next)]  = no_parent;
+        root_                 = next;
+        return change;
+    }
+
+    /// Shift the root \p count times, calling \p on_step with every changed
+    /// wall cell.
+    template <std::invocable<Step const&> Callback>
+    void shift(std::size_t count, Callback&& on_step)
+    {
+        for (; count != 0; --count) {
+            auto const change = shift();
+            if (change.opened)
+                on_step(detail::make_step(*change.opened, *change.opened,
+                                          Cell::Passage));
+            if (change.closed)
+                on_step(detail::make_step(*change.closed, *change.closed,
+                                          Cell::Wall));
+        }
+    }
+
+    /// Return the root room, in Maze coordinates.
+    [[nodiscard]] auto root() const -> Point
+    {
+        return utility::times_two(root_);
+    }
+
+    /// Return the Direction from room \p p, in Maze coordinates, to its
+    /// parent. std::nullopt for the root.
+    [[nodiscard]] auto parent(Point p) const -> std::optional<Direction>
+    {
+        auto const dir = parent_[index(utility::half(p))];
+        if (dir == no_parent)
+            return std::nullopt;
+        return static_cast<Direction>(dir);
+    }
+
+    /// Return the Maze kept in sync with the tree.
+    [[nodiscard]] auto maze() const -> Maze_type const& { return maze_; }
+
+   private:
+    static constexpr auto no_parent = std::uint8_t{4};
+    static constexpr auto unvisited = std::uint8_t{5};
+
+    Maze_type& maze_;
+    Gen gen_;
+    Point root_;  // In room coordinates.
+    std::vector<std::uint8_t> parent_;
+
+   private:
+    [[nodiscard]] static auto index(Point room) -> std::size_t
+    {
+        return (std::size_t{room.y} * columns) + room.x;
+    }
+
+    /// Return the wall cell between \p room and its neighbor in \p d.
+    [[nodiscard]] static auto wall_between(Point room, Direction d) -> Point
+    {
+        return utility::step(utility::times_two(room), d);
+    }
+
+    /// Point every room at its parent on the path to root_, breadth first.
+    void adopt()
+    {
+        auto open_edges = std::size_t{0};
+        for (auto y = Distance{0}; y < rows; ++y) {
+            for (auto x = Distance{0}; x < columns; ++x) {
+                for (auto const d : {Direction::South, Direction::East}) {
+                    auto const room = Point{x, y};
+                    if (utility::next_point<columns, rows>(room, d) &&
+                        maze_.get(wall_between(room, d)) == Cell::Passage)
+                        ++open_edges;
+                }
+            }
+        }
+
+        auto queue = std::vector<Point>{root_};
+        parent_[index(root_)] = no_parent;
+        for (auto i = std::size_t{0}; i < queue.size(); ++i) {
+            auto const at = queue[i];
+            if (maze_.get(utility::times_two(at)) != Cell::Passage)
+                break;
+            for (auto const d : utility::directions) {
+                auto const next = utility::next_point<columns, rows>(at, d);
+                if (!next || parent_[index(*next)] != unvisited ||
+                    maze_.get(wall_between(at, d)) != Cell::Passage)
+                    continue;
+                parent_[index(*next)] =
+                    static_cast<std::uint8_t>(utility::opposite(d));
+                queue.push_back(*next);
+            }
+        }
+        if (queue.size() != parent_.size() || open_edges != queue.size() - 1)
+            throw std::invalid_argument{
+                "Origin_shift_maze: Maze is not a perfect maze."};
+    }
+};
+
+}  // namespace maze
+#endif  // MAZE_ORIGIN_SHIFT_HPP
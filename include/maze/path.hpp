@@ -0,0 +1,312 @@
+#ifndef MAZE_PATH_HPP
+#define MAZE_PATH_HPP
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <maze/direction.hpp>
+#include <maze/distance.hpp>
+#include <maze/layout.hpp>
+#include <maze/point.hpp>
+#include <maze/utility.hpp>
+
+namespace maze {
+
+/// A path of adjacent Points, stored as a start Point and a 2 bit Direction
+/// per step.
+/** A path of n Points takes n / 4 bytes, plus a Point every 256 steps so
+ *  operator[] only sums the steps of at most 8 Words, with popcounts. Reads
+ *  like a std::vector<Point>: size() counts Points and iteration yields
+ *  them, by value. */
+class Path {
+   public:
+    class Iterator;
+    using value_type      = Point;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using iterator        = Iterator;
+    using const_iterator  = Iterator;
+
+   public:
+    /// Create an empty Path.
+    Path() = default;
+
+    /// Create a Path of the single Point \p start.
+    explicit Path(Point start)
+        : start_{start}, end_{start}, size_{1}, checkpoints_{start}
+    {}
+
+    /// Create a Path through \p points, each adjacent to the one before.
+    /** Throws std::invalid_argument if two neighbors are not adjacent. */
+    template <std::ranges::input_range R>
+        requires(!std::same_as<std::remove_cvref_t<R>, Path> &&
+                 std::convertible_to<std::ranges::range_reference_t<R>,
+                                     Point>)
+    explicit Path(R&& points)
+    {
+        for (auto const p : points)
+            push_back(static_cast<Point>(p));
+    }
+
+   public:
+    /// Append the Point one step in Direction \p d from back().
+    /** The Path must not be empty. */
+    void push_back(Direction d)
+    {
+        auto const step = size_ - 1;
+        if (step % steps_per_word == 0)
+            steps_.push_back(Word{0});
+        steps_.back() |= Word{static_cast<unsigned>(d)}
+                         << (2 * (step % steps_per_word));
+        end_ = utility::step(end_, d);
+        if (size_++ % checkpoint_steps == 0)
+            checkpoints_.push_back(end_);
+    }
+
+    /// Append \p p, which must be adjacent to back() if there is one.
+    /** Throws std::invalid_argument if it is not. */
+    void push_back(Point p)
+    {
+        if (size_ == 0) {
+            *this = Path{p};
+            return;
+        }
+        for (auto const d : utility::directions) {
+            if (utility::step(end_, d) == p) {
+                push_back(d);
+                return;
+            }
+        }
+        throw std::invalid_argument{"Path::push_back: Point not adjacent."};
+    }
+
+    /// Remove the last Point. The Path must not be empty.
+    void pop_back()
+    {
+        if (--size_ == 0) {
+            *this = Path{};
+            return;
+        }
+        if (size_ % checkpoint_steps == 0)
+            checkpoints_.pop_back();
+        auto const step = size_ - 1;
+        end_ = utility::step(end_, utility::opposite(direction(step)));
+        steps_.back() &= ~(Word{3} << (2 * (step % steps_per_word)));
+        if (step % steps_per_word == 0)
+            steps_.pop_back();
+    }
+
+    /// Return the number of Points.
+    [[nodiscard]] auto size() const -> std::size_t { return size_; }
+
+    /// Return true if the Path has no Points.
+    [[nodiscard]] auto empty() const -> bool { return size_ == 0; }
+
+    /// Return the first Point. The Path must not be empty.
+    [[nodiscard]] auto front() const -> Point { return start_; }
+
+    /// Return the last Point. The Path must not be empty.
+    [[nodiscard]] auto back() const -> Point { return end_; }
+
+    /// Return the Direction of step \p i, from Point i to Point i + 1.
+    [[nodiscard]] auto direction(std::size_t i) const -> Direction
+    {
+        auto const shift = 2 * (i % steps_per_word);
+        return static_cast<Direction>((steps_[i / steps_per_word] >> shift) &
+                                      3u);
+    }
+
+    /// Return Point \p i, i < size().
+    [[nodiscard]] auto operator[](std::size_t i) const -> Point
+    {
+        auto const checkpoint = i / checkpoint_steps;
+        auto x = std::int64_t{checkpoints_[checkpoint].x};
+        auto y = std::int64_t{checkpoints_[checkpoint].y};
+        for (auto step = checkpoint * checkpoint_steps; step < i;) {
+            auto const count = std::min(i - step, steps_per_word);
+            auto const word  = steps_[step / steps_per_word] &
+                              detail::low_bits(2 * count);
+            // Direction bit 1 is East or West, bit 0 is South or West.
+            auto const valid = detail::low_bits(2 * count) & even_fields;
+            auto const lo    = word & even_fields;
+            auto const hi    = (word >> 1) & even_fields;
+            x += std::popcount(hi & ~lo & valid) - std::popcount(hi & lo);
+            y += std::popcount(~hi & lo & valid) -
+                 std::popcount(~hi & ~lo & valid);
+            step += count;
+        }
+        return {static_cast<Distance>(x), static_cast<Distance>(y)};
+    }
+
+    [[nodiscard]] auto begin() const -> Iterator;
+    [[nodiscard]] auto end() const -> Iterator;
+
+    /// Return true if \p p is on the Path, in O(size()).
+    /** Use to_mask() for many queries. */
+    [[nodiscard]] auto contains(Point p) const -> bool;
+
+    /// Return a bit per cell of a Width x Height grid, row by row, set for
+    /// the cells on the Path.
+    template <Distance Width, Distance Height>
+    [[nodiscard]] auto to_mask() const -> std::vector<Word>;
+
+    /// Return the Points of the Path.
+    [[nodiscard]] auto to_points() const -> std::vector<Point>;
+
+    friend auto operator==(Path const& lhs, Path const& rhs) -> bool
+    {
+        return lhs.size_ == rhs.size_ &&
+               (lhs.size_ == 0 ||
+                (lhs.start_ == rhs.start_ && lhs.steps_ == rhs.steps_));
+    }
+
+   private:
+    static constexpr auto steps_per_word   = word_bits / 2;
+    static constexpr auto checkpoint_steps = steps_per_word * 8;
+    static constexpr auto even_fields      = Word{0x5555'5555'5555'5555};
+
+    Point start_ = {0, 0};
+    Point end_   = {0, 0};
+    std::size_t size_ = 0;
+    std::vector<Word> steps_;  // Unused high fields are zero.
+    std::vector<Point> checkpoints_;  // Point i * checkpoint_steps.
+};
+
+/// Random access iterator over the Points of a Path, yields them by value.
+class Path::Iterator {
+   public:
+    using iterator_concept  = std::random_access_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type        = Point;
+    using difference_type   = std::ptrdiff_t;
+
+   public:
+    Iterator() = default;
+
+    Iterator(Path const* path, std::size_t index, Point at)
+        : path_{path}, index_{index}, at_{at}
+    {}
+
+   public:
+    auto operator*() const -> Point { return at_; }
+
+    auto operator[](difference_type n) const -> Point
+    {
+        return (*path_)[index_ + n];
+    }
+
+    auto operator++() -> Iterator&
+    {
+        if (++index_ < path_->size())
+            at_ = utility::step(at_, path_->direction(index_ - 1));
+        return *this;
+    }
+
+    auto operator++(int) -> Iterator
+    {
+        auto const copy = *this;
+        ++*this;
+        return copy;
+    }
+
+    auto operator--() -> Iterator&
+    {
+        if (index_ < path_->size())
+            at_ = utility::step(
+                at_, utility::opposite(path_->direction(index_ - 1)));
+        --index_;
+        return *this;
+    }
+
+    auto operator--(int) -> Iterator
+    {
+        auto const copy = *this;
+        --*this;
+        return copy;
+    }
+
+    auto operator+=(difference_type n) -> Iterator&
+    {
+        index_ += n;
+        at_ = index_ < path_->size() ? (*path_)[index_] : path_->back();
+        return *this;
+    }
+
+    auto operator-=(difference_type n) -> Iterator& { return *this += -n; }
+
+    friend auto operator+(Iterator it, difference_type n) -> Iterator
+    {
+        return it += n;
+    }
+
+    friend auto operator+(difference_type n, Iterator it) -> Iterator
+    {
+        return it += n;
+    }
+
+    friend auto operator-(Iterator it, difference_type n) -> Iterator
+    {
+        return it -= n;
+    }
+
+    friend auto operator-(Iterator const& lhs, Iterator const& rhs)
+        -> difference_type
+    {
+        return static_cast<difference_type>(lhs.index_) -
+               static_cast<difference_type>(rhs.index_);
+    }
+
+    friend auto operator==(Iterator const& lhs, Iterator const& rhs) -> bool
+    {
+        return lhs.index_ == rhs.index_;
+    }
+
+    friend auto operator<=>(Iterator const& lhs, Iterator const& rhs)
+    {
+        return lhs.index_ <=> rhs.index_;
+    }
+
+   private:
+    Path const* path_  = nullptr;
+    std::size_t index_ = 0;
+    Point at_          = {0, 0};  // Point index_, back() at the end.
+};
+
+inline auto Path::begin() const -> Iterator { return {this, 0, start_}; }
+
+inline auto Path::end() const -> Iterator { return {this, size_, end_}; }
+
+inline auto Path::contains(Point p) const -> bool
+{
+    for (auto const at : *this) {
+        if (at == p)
+            return true;
+    }
+    return false;
+}
+
+template <Distance Width, Distance Height>
+auto Path::to_mask() const -> std::vector<Word>
+{
+    auto mask = std::vector<Word>(
+        ((std::size_t{Width} * Height) + word_bits - 1) / word_bits);
+    for (auto const p : *this)
+        detail::assign_bit(mask, (std::size_t{p.y} * Width) + p.x, true);
+    return mask;
+}
+
+inline auto Path::to_points() const -> std::vector<Point>
+{
+    return {begin(), end()};
+}
+
+}  // namespace maze
+#endif  // MAZE_PATH_HPP
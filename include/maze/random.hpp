@@ -0,0 +1,116 @@
+#ifndef MAZE_RANDOM_HPP
+#define MAZE_RANDOM_HPP
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <utility>
+
+namespace maze {
+
+/// SplitMix64 random bit generator, usable in constant expressions.
+/** Small and fast, seeds the compile time generators; the same seed gives the
+ *  same Maze at compile time and at run time. */
+class Splitmix64 {
+   public:
+    using result_type = std::uint64_t;
+
+   public:
+    constexpr explicit Splitmix64(std::uint64_t seed = 0) : state_{seed} {}
+
+   public:
+    [[nodiscard]] static constexpr auto min() -> result_type { return 0; }
+
+    [[nodiscard]] static constexpr auto max() -> result_type
+    {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    constexpr auto operator()() -> result_type
+    {
+        auto z = (state_ += 0x9E3779B97F4A7C15ULL);
+        z      = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z      = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+   private:
+    std::uint64_t state_;
+};
+
+}  // namespace maze
+
+namespace maze::detail {
+
+/// Return one value in [0, Gen::max() - Gen::min()] from \p gen.
+/** Generators of 32 and 64 bits are supported, like std::mt19937(_64). */
+template <std::uniform_random_bit_generator Gen>
+[[nodiscard]] constexpr auto draw(Gen& gen) -> std::uint64_t
+{
+    constexpr auto range = std::uint64_t{Gen::max() - Gen::min()};
+    static_assert(range == std::numeric_limits<std::uint32_t>::max() ||
+                      range == std::numeric_limits<std::uint64_t>::max(),
+                  "draw: Gen must produce 32 or 64 random bits.");
+    return std::uint64_t{gen() - Gen::min()};
+}
+
+/// Return 64 random bits from \p gen, two draws for a 32 bit Gen.
+template <std::uniform_random_bit_generator Gen>
+[[nodiscard]] constexpr auto random_word(Gen& gen) -> std::uint64_t
+{
+    if constexpr (Gen::max() - Gen::min() ==
+                  std::numeric_limits<std::uint64_t>::max()) {
+        return draw(gen);
+    }
+    else {
+        auto const high = draw(gen);
+        return (high << 32) | draw(gen);
+    }
+}
+
+/// Return a uniform value in [0, bound] from \p next, which returns values in
+/// [0, range].
+template <typename Draw>
+[[nodiscard]] constexpr auto uniform_to(Draw&& next,
+                                        std::uint64_t range,
+                                        std::uint64_t bound) -> std::uint64_t
+{
+    if (bound == range)
+        return next();
+    auto const n = bound + 1;
+    // Reject the (range + 1) % n smallest draws so each remainder is as likely.
+    auto const threshold = (range - bound) % n;
+    auto x               = next();
+    while (x < threshold)
+        x = next();
+    return x % n;
+}
+
+/// Return a uniform value in [0, bound] from \p gen.
+/** Usable in constant expressions, unlike std::uniform_int_distribution. */
+template <std::uniform_random_bit_generator Gen>
+[[nodiscard]] constexpr auto uniform_to(Gen& gen, std::uint64_t bound)
+    -> std::uint64_t
+{
+    constexpr auto range = std::uint64_t{Gen::max() - Gen::min()};
+    if (bound <= range)
+        return uniform_to([&] { return draw(gen); }, range, bound);
+    return uniform_to([&] { return random_word(gen); },
+                      std::numeric_limits<std::uint64_t>::max(), bound);
+}
+
+/// Fisher-Yates shuffle of \p range from \p gen, usable in constant
+/// expressions.
+template <typename Range, std::uniform_random_bit_generator Gen>
+constexpr void shuffle(Range& range, Gen& gen)
+{
+    auto const size = std::size(range);
+    for (auto i = size; i > 1; --i) {
+        auto const j = static_cast<std::size_t>(uniform_to(gen, i - 1));
+        using std::swap;
+        swap(range[i - 1], range[j]);
+    }
+}
+
+}  // namespace maze::detail
+#endif  // MAZE_RANDOM_HPP
@@ -0,0 +1,227 @@
+#ifndef MAZE_SERIALIZE_HPP
+#define MAZE_SERIALIZE_HPP
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+#include <maze/cell.hpp>
+#include <maze/distance.hpp>
+#include <maze/layout.hpp>
+#include <maze/mapped_file.hpp>
+#include <maze/maze.hpp>
+#include <maze/maze_view.hpp>
+#include <maze/point.hpp>
+
+namespace maze {
+
+/// Identifies the algorithm a stored Maze was generated with.
+enum class Generator_id : std::uint32_t {
+    Unknown,
+    Recursive_backtracking,
+    Kruskal,
+    Prims,
+    Aldous_broder,
+    Recursive_division,
+    Ellers,
+    Binary_tree,
+    Sidewinder,
+    Hunt_and_kill
+};
+
+/// Provenance of a stored Maze, saved in the binary header.
+struct Maze_metadata {
+    std::uint64_t seed     = 0;
+    Generator_id generator = Generator_id::Unknown;
+
+    friend auto constexpr operator==(Maze_metadata, Maze_metadata)
+        -> bool = default;
+};
+
+/// Current version of the binary format written by write_binary.
+inline constexpr auto binary_version = std::uint16_t{1};
+
+/// Fixed size header at the start of a binary Maze file.
+/** Followed directly by word_count Words, laid out as Maze::words(). Every
+ *  field is in the byte order of the writer, byte_order detects mismatches.
+ *  The header size keeps the Word payload 8 byte aligned. */
+struct Binary_header {
+    std::array<char, 4> magic = {'M', 'A', 'Z', 'E'};
+    std::uint16_t version     = binary_version;
+    std::uint16_t byte_order  = 0x0102;
+    std::uint16_t width       = 0;
+    std::uint16_t height      = 0;
+    std::uint32_t generator   = 0;
+    std::uint64_t seed        = 0;
+    std::uint64_t word_count  = 0;
+};
+
+static_assert(sizeof(Binary_header) == 32);
+
+}  // namespace maze
+
+namespace maze::detail {
+
+/// Build the header for a Maze<Width, Height> with \p metadata.
+template <Distance Width, Distance Height>
+[[nodiscard]] auto make_header(Maze_metadata metadata) -> Binary_header
+{
+    auto header       = Binary_header{};
+    header.width      = Width;
+    header.height     = Height;
+    header.generator  = static_cast<std::uint32_t>(metadata.generator);
+    header.seed       = metadata.seed;
+    header.word_count = Maze<Width, Height>::word_count;
+    return header;
+}
+
+/// Throws std::runtime_error if \p header can't be read as Maze<Width,Height>.
+template <Distance Width, Distance Height>
+void check_header(Binary_header const& header)
+{
+    auto const expected = Binary_header{};
+    if (header.magic != expected.magic)
+        throw std::runtime_error{"Maze binary: bad magic."};
+    if (header.byte_order != expected.byte_order)
+        throw std::runtime_error{"Maze binary: foreign byte order."};
+    if (header.version != binary_version)
+        throw std::runtime_error{"Maze binary: unsupported version."};
+    if (header.width != Width || header.height != Height)
+        throw std::runtime_error{"Maze binary: dimension mismatch."};
+    if (header.word_count != Maze<Width, Height>::word_count)
+        throw std::runtime_error{"Maze binary: word count mismatch."};
+}
+
+/// Throws std::runtime_error if a padding bit past Width is set in \p words.
+/** Padding must stay zero, or operator== and the Word at a time algorithms
+ *  would disagree with get(). */
+template <Distance Width, Distance Height>
+void check_padding(std::span<Word const> words)
+{
+    constexpr auto per_row = Row_major::words_per_row<Width, Height>;
+    constexpr auto padding =
+        ~low_bits(std::size_t{Width} - ((per_row - 1) * word_bits));
+    if constexpr (padding != 0) {
+        for (auto y = std::size_t{0}; y < Height; ++y) {
+            if ((words[(y * per_row) + per_row - 1] & padding) != 0)
+                throw std::runtime_error{"Maze binary: padding bits set."};
+        }
+    }
+}
+
+/// Return the metadata stored in \p header.
+[[nodiscard]] inline auto to_metadata(Binary_header const& header)
+    -> Maze_metadata
+{
+    return {header.seed, static_cast<Generator_id>(header.generator)};
+}
+
+}  // namespace maze::detail
+
+namespace maze {
+
+/// Write \p maze and \p metadata to \p os in the binary Maze format.
+/** Throws std::runtime_error if \p os fails. */
+template <Distance Width, Distance Height>
+void write_binary(std::ostream& os,
+                  Maze<Width, Height> const& maze,
+                  Maze_metadata metadata = {})
+{
+    auto const header = detail::make_header<Width, Height>(metadata);
+    auto const words  = maze.words();
+    os.write(reinterpret_cast<char const*>(&header), sizeof(header));
+    os.write(reinterpret_cast<char const*>(words.data()), words.size_bytes());
+    if (!os)
+        throw std::runtime_error{"write_binary: stream failure."};
+}
+
+/// Read a Maze and its metadata from \p is, written by write_binary.
+/** Throws std::runtime_error if \p is fails, holds a different Maze type or
+ *  sets a padding bit. */
+template <Distance Width, Distance Height>
+[[nodiscard]] auto read_binary(std::istream& is)
+    -> std::pair<Maze<Width, Height>, Maze_metadata>
+{
+    auto header = Binary_header{};
+    if (!is.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        throw std::runtime_error{"read_binary: truncated header."};
+    detail::check_header<Width, Height>(header);
+
+    auto maze        = Maze<Width, Height>{Cell::Wall};
+    auto const words = maze.words();
+    if (!is.read(reinterpret_cast<char*>(words.data()), words.size_bytes()))
+        throw std::runtime_error{"read_binary: truncated payload."};
+    detail::check_padding<Width, Height>(words);
+    return {maze, detail::to_metadata(header)};
+}
+
+/// Return a zero-copy view of a binary Maze stored in \p bytes.
+/** \p bytes must be 8 byte aligned, as any mapped file is. Throws
+ *  std::runtime_error if \p bytes does not hold a Maze<Width, Height> or
+ *  sets a padding bit. */
+template <Distance Width, Distance Height>
+[[nodiscard]] auto view_binary(std::span<std::byte const> bytes)
+    -> std::pair<Maze_view<Width, Height>, Maze_metadata>
+{
+    constexpr auto word_count = Maze<Width, Height>::word_count;
+    if (bytes.size() < sizeof(Binary_header) + (word_count * sizeof(Word)))
+        throw std::runtime_error{"view_binary: truncated input."};
+    if (reinterpret_cast<std::uintptr_t>(bytes.data()) % alignof(Word) != 0)
+        throw std::runtime_error{"view_binary: misaligned input."};
+
+    auto header = Binary_header{};
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    detail::check_header<Width, Height>(header);
+
+    auto const words = std::span<Word const, word_count>{
+        reinterpret_cast<Word const*>(bytes.data() + sizeof(header)),
+        word_count};
+    detail::check_padding<Width, Height>(words);
+    return {Maze_view<Width, Height>{words}, detail::to_metadata(header)};
+}
+
+/// A binary Maze file mapped read-only into memory.
+/** Loading is zero-copy, Cells are read straight from the page cache. */
+template <Distance Width, Distance Height>
+class Mapped_maze {
+   public:
+    /// Map the binary Maze file at \p path.
+    /** Throws std::system_error if mapping fails and std::runtime_error if
+     *  the file does not hold a Maze<Width, Height>. */
+    explicit Mapped_maze(std::filesystem::path const& path)
+        : file_{path}, view_and_metadata_{view_binary<Width, Height>(
+                           file_.bytes())}
+    {}
+
+   public:
+    /// Get the cell representation at Point \p p.
+    [[nodiscard]] auto get(Point p) const -> Cell
+    {
+        return view_and_metadata_.first.get(p);
+    }
+
+    /// Return a view of the mapped Cells, valid for the lifetime of *this.
+    [[nodiscard]] auto view() const -> Maze_view<Width, Height>
+    {
+        return view_and_metadata_.first;
+    }
+
+    /// Return the metadata stored with the Maze.
+    [[nodiscard]] auto metadata() const -> Maze_metadata
+    {
+        return view_and_metadata_.second;
+    }
+
+   private:
+    Mapped_file file_;
+    std::pair<Maze_view<Width, Height>, Maze_metadata> view_and_metadata_;
+};
+
+}  // namespace maze
+#endif  // MAZE_SERIALIZE_HPP
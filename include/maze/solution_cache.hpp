@@ -0,0 +1,196 @@
+#ifndef MAZE_SOLUTION_CACHE_HPP
+#define MAZE_SOLUTION_CACHE_HPP
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <maze/analytics.hpp>
+#include <maze/cell_grid.hpp>
+#include <maze/distance.hpp>
+#include <maze/longest_path.hpp>
+#include <maze/maze.hpp>
+#include <maze/maze_hash.hpp>
+#include <maze/path.hpp>
+#include <maze/point.hpp>
+
+namespace maze {
+
+/// A solved Maze: a longest path through it and its metrics.
+struct Maze_solution {
+    Path path;
+    Maze_metrics metrics;
+
+    friend auto operator==(Maze_solution const&, Maze_solution const&)
+        -> bool = default;
+};
+
+}  // namespace maze
+
+namespace maze::detail {
+
+/// Hashes a Maze_hash for an unordered container, it is already mixed.
+struct Maze_hash_hasher {
+    [[nodiscard]] auto operator()(Maze_hash h) const -> std::size_t
+    {
+        return static_cast<std::size_t>(h.low);
+    }
+};
+
+}  // namespace maze::detail
+
+namespace maze {
+
+/// A bounded cache of Maze_solutions keyed by canonical_hash().
+/** Solutions are stored in canonical orientation, so a Maze shares its entry
+ *  with all of its rotations and mirror images; a hit maps the path back to
+ *  the orientation asked for. Metrics are the same in every orientation for
+ *  odd sized Mazes. At most capacity() solutions stay cached, least recently
+ *  used first out. All members are safe to call from several threads. */
+class Solution_cache {
+   public:
+    /// Create a cache of \p capacity solutions.
+    /** Throws std::invalid_argument on zero capacity. */
+    explicit Solution_cache(std::size_t capacity) : capacity_{capacity}
+    {
+        if (capacity == 0)
+            throw std::invalid_argument{"Solution_cache: zero capacity."};
+    }
+
+    Solution_cache(Solution_cache const&) = delete;
+    auto operator=(Solution_cache const&) -> Solution_cache& = delete;
+
+   public:
+    /// Return the longest path through \p m and its metrics, solving and
+    /// caching them if \p m is not cached in any orientation.
+    /** \p m is any Cell_grid, a Maze_view or Wall_maze is read in place.
+     *  Solving runs unlocked, two threads may race to solve the same Maze;
+     *  both get a valid solution and the first insert wins. */
+    template <Cell_grid G>
+    [[nodiscard]] auto solve(G const& m) -> Maze_solution
+    {
+        auto const key = canonical_hash(m);
+        if (auto const found = lookup(key.hash))
+            return from_canonical<G::width, G::height>(*found, key.symmetry);
+
+        auto solution = Maze_solution{longest_path(m), analyze(m)};
+        auto stored   = std::make_shared<Maze_solution>(solution);
+        stored->path  = Path{solution.path |
+                            std::views::transform([&](Point p) {
+                                return apply(key.symmetry, p, G::width,
+                                             G::height);
+                            })};
+        insert(key.hash, std::move(stored));
+        return solution;
+    }
+
+    /// Return the cached solution of \p m, or std::nullopt if it is not
+    /// cached in any orientation. Never solves.
+    template <Cell_grid G>
+    [[nodiscard]] auto find(G const& m) -> std::optional<Maze_solution>
+    {
+        auto const key = canonical_hash(m);
+        if (auto const found = lookup(key.hash))
+            return from_canonical<G::width, G::height>(*found, key.symmetry);
+        return std::nullopt;
+    }
+
+    /// Return the number of solve() and find() calls answered from the cache.
+    [[nodiscard]] auto hits() const -> std::size_t
+    {
+        auto const lock = std::lock_guard{mutex_};
+        return hits_;
+    }
+
+    /// Return the number of solve() and find() calls not in the cache.
+    [[nodiscard]] auto misses() const -> std::size_t
+    {
+        auto const lock = std::lock_guard{mutex_};
+        return misses_;
+    }
+
+    /// Return the number of solutions currently cached.
+    [[nodiscard]] auto size() const -> std::size_t
+    {
+        auto const lock = std::lock_guard{mutex_};
+        return lru_.size();
+    }
+
+    /// Return the maximum number of solutions cached.
+    [[nodiscard]] auto capacity() const -> std::size_t { return capacity_; }
+
+    /// Drop every cached solution, the counters are kept.
+    void clear()
+    {
+        auto const lock = std::lock_guard{mutex_};
+        index_.clear();
+        lru_.clear();
+    }
+
+   private:
+    using Solution_ptr = std::shared_ptr<Maze_solution const>;
+
+    struct Entry {
+        Maze_hash key;
+        Solution_ptr solution;
+    };
+    using Lru = std::list<Entry>;
+
+    std::size_t const capacity_;
+    mutable std::mutex mutex_;  // Guards everything below.
+    Lru lru_;                   // Most recently used first.
+    std::unordered_map<Maze_hash, Lru::iterator, detail::Maze_hash_hasher>
+        index_;
+    std::size_t hits_   = 0;
+    std::size_t misses_ = 0;
+
+   private:
+    /// Return the solution cached under \p key, counting a hit or miss.
+    auto lookup(Maze_hash key) -> Solution_ptr
+    {
+        auto const lock = std::lock_guard{mutex_};
+        auto const found = index_.find(key);
+        if (found == index_.end()) {
+            ++misses_;
+            return nullptr;
+        }
+        ++hits_;
+        lru_.splice(lru_.begin(), lru_, found->second);
+        return found->second->solution;
+    }
+
+    void insert(Maze_hash key, Solution_ptr solution)
+    {
+        auto const lock = std::lock_guard{mutex_};
+        if (index_.contains(key))
+            return;
+        lru_.push_front({key, std::move(solution)});
+        index_.emplace(key, lru_.begin());
+        if (lru_.size() > capacity_) {
+            index_.erase(lru_.back().key);
+            lru_.pop_back();
+        }
+    }
+
+    /// Return \p canonical mapped back through \p symmetry to a Width x
+    /// Height Maze.
+    template <Distance Width, Distance Height>
+    [[nodiscard]] static auto from_canonical(Maze_solution const& canonical,
+                                             Symmetry symmetry)
+        -> Maze_solution
+    {
+        auto result = canonical;
+        result.path = Path{canonical.path |
+                           std::views::transform([&](Point p) {
+                               return unapply(symmetry, p, Width, Height);
+                           })};
+        return result;
+    }
+};
+
+}  // namespace maze
+#endif  // MAZE_SOLUTION_CACHE_HPP
@@ -0,0 +1,110 @@
+#ifndef MAZE_SOLVE_3D_HPP
+#define MAZE_SOLVE_3D_HPP
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <maze/cell.hpp>
+#include <maze/distance.hpp>
+#include <maze/maze_3d.hpp>
+
+namespace maze::detail {
+
+/// Breadth first search of the Passages of \p maze from \p start.
+/** Sets came_from[cell_index(p)] to 1 + the Direction_3d that leads back
+ *  towards \p start for every Passage reached, 0 for the rest and 7 for
+ *  \p start. Returns the last Point reached, one farthest from \p start. */
+template <Distance Width, Distance Height, Distance Depth, typename Layout>
+auto breadth_first_3d(Maze_3d<Width, Height, Depth, Layout> const& maze,
+                      Point_3d start,
+                      std::vector<std::uint8_t>& came_from) -> Point_3d
+{
+    using Maze_type = Maze_3d<Width, Height, Depth, Layout>;
+    came_from.assign(Maze_type::cell_count, 0);
+    auto queue = std::vector<std::size_t>{Maze_type::cell_index(start)};
+    came_from[queue.front()] = 7;
+    for (auto head = std::size_t{0}; head < queue.size(); ++head) {
+        auto const at = Maze_type::cell_at(queue[head]);
+        for (auto const d : utility::directions_3d) {
+            auto const next = utility::next_passage(maze, at, d);
+            if (!next.has_value())
+                continue;
+            auto const index = Maze_type::cell_index(*next);
+            if (came_from[index] != 0)
+                continue;
+            came_from[index] =
+                static_cast<std::uint8_t>(1 + static_cast<int>(
+                                                  utility::opposite(d)));
+            queue.push_back(index);
+        }
+    }
+    return Maze_type::cell_at(queue.back());
+}
+
+/// Return the Points from the search start to \p end, following \p
+/// came_from as breadth_first_3d() left it for a Maze_type.
+template <typename Maze_type>
+[[nodiscard]] auto trace_back_3d(std::vector<std::uint8_t> const& came_from,
+                                 Point_3d end) -> std::vector<Point_3d>
+{
+    auto path = std::vector<Point_3d>{end};
+    for (auto at = end; came_from[Maze_type::cell_index(at)] != 7;) {
+        auto const back = came_from[Maze_type::cell_index(at)] - 1;
+        at = utility::step(at, static_cast<Direction_3d>(back));
+        path.push_back(at);
+    }
+    std::ranges::reverse(path);
+    return path;
+}
+
+}  // namespace maze::detail
+
+namespace maze {
+
+/// Return the shortest path of Passages from \p from to \p to in \p maze.
+/** Both ends are included. Returns an empty vector if either is a Wall or
+ *  \p to can't be reached. Linear in the Cells of \p maze. */
+template <Distance Width, Distance Height, Distance Depth, typename Layout>
+[[nodiscard]] auto shortest_path(
+    Maze_3d<Width, Height, Depth, Layout> const& maze,
+    Point_3d from,
+    Point_3d to) -> std::vector<Point_3d>
+{
+    using Maze_type = Maze_3d<Width, Height, Depth, Layout>;
+    if (maze.get(from) == Cell::Wall || maze.get(to) == Cell::Wall)
+        return {};
+    auto came_from = std::vector<std::uint8_t>{};
+    detail::breadth_first_3d(maze, from, came_from);
+    if (came_from[Maze_type::cell_index(to)] == 0)
+        return {};
+    return detail::trace_back_3d<Maze_type>(came_from, to);
+}
+
+/// Finds the longest path in the perfect maze \p m.
+/** Returns an ordered list of Points between the two dead ends farthest
+ *  apart, from two breadth first searches, so linear in the Cells of \p m
+ *  where the 2D longest_path tries every leaf. Only the Passages connected
+ *  to the first Passage are searched. Returns an empty vector if \p m has
+ *  no Passage. */
+template <Distance Width, Distance Height, Distance Depth, typename Layout>
+[[nodiscard]] auto longest_path(Maze_3d<Width, Height, Depth, Layout> const& m)
+    -> std::vector<Point_3d>
+{
+    using Maze_type = Maze_3d<Width, Height, Depth, Layout>;
+    auto first      = std::size_t{0};
+    while (first < Maze_type::cell_count &&
+           m.get(Maze_type::cell_at(first)) == Cell::Wall)
+        ++first;
+    if (first == Maze_type::cell_count)
+        return {};
+
+    auto came_from = std::vector<std::uint8_t>{};
+    auto const end =
+        detail::breadth_first_3d(m, Maze_type::cell_at(first), came_from);
+    auto const other = detail::breadth_first_3d(m, end, came_from);
+    return detail::trace_back_3d<Maze_type>(came_from, other);
+}
+
+}  // namespace maze
+#endif  // MAZE_SOLVE_3D_HPP
@@ -0,0 +1,106 @@
+#ifndef MAZE_STEPPER_HPP
+#define MAZE_STEPPER_HPP
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <stop_token>
+
+#include <maze/cell.hpp>
+#include <maze/distance.hpp>
+#include <maze/point.hpp>
+
+namespace maze {
+
+/// Cells changed by a single step of a generator, already written to its Maze.
+/** Inclusive rectangle, a carved edge is a straight run of cells and a
+ *  recursive division wall is a full row or column. */
+struct Step {
+    Point top_left;
+    Point bottom_right;
+    Cell cell;
+
+    friend auto constexpr operator==(Step, Step) -> bool = default;
+};
+
+/// Resumable maze generator, every call to step() makes one change to a Maze.
+/** step() returns std::nullopt once the maze is complete, done() is then true.
+ *  The Maze must outlive the Stepper and not be written to in between. */
+template <typename T>
+concept Stepper = requires(T& stepper, T const& const_stepper) {
+    { stepper.step() } -> std::same_as<std::optional<Step>>;
+    { const_stepper.done() } -> std::same_as<bool>;
+};
+
+}  // namespace maze
+
+namespace maze::detail {
+
+/// Return the Step covering the straight run between \p a and \p b.
+[[nodiscard]] constexpr auto make_step(Point a, Point b, Cell c) -> Step
+{
+    return {{std::min(a.x, b.x), std::min(a.y, b.y)},
+            {std::max(a.x, b.x), std::max(a.y, b.y)},
+            c};
+}
+
+}  // namespace maze::detail
+
+namespace maze {
+
+/// Take at most \p count steps from \p stepper, calling \p on_step with each.
+/** Returns true if the maze is complete. */
+template <Stepper S, std::invocable<Step const&> Callback>
+auto run_steps(S& stepper, std::size_t count, Callback&& on_step) -> bool
+{
+    for (; count != 0; --count) {
+        auto const step = stepper.step();
+        if (!step.has_value())
+            break;
+        on_step(*step);
+    }
+    return stepper.done();
+}
+
+/// Take steps from \p stepper until \p budget has elapsed, calling \p on_step
+/// with each. Returns true if the maze is complete.
+/** The clock is read every few steps, so the budget can be overrun by the
+ *  length of a handful of steps. */
+template <Stepper S, std::invocable<Step const&> Callback>
+auto run_for(S& stepper,
+             std::chrono::steady_clock::duration budget,
+             Callback&& on_step) -> bool
+{
+    constexpr auto steps_per_check = std::size_t{32};
+    auto const deadline = std::chrono::steady_clock::now() + budget;
+    do {
+        if (run_steps(stepper, steps_per_check, on_step))
+            return true;
+    } while (std::chrono::steady_clock::now() < deadline);
+    return false;
+}
+
+/// Take steps from \p stepper until the maze is complete or \p stop is
+/// requested. Returns true if the maze is complete.
+template <Stepper S>
+auto run_until_done(S& stepper, std::stop_token stop) -> bool
+{
+    constexpr auto steps_per_check = std::size_t{32};
+    while (!stop.stop_requested()) {
+        if (run_steps(stepper, steps_per_check, [](Step const&) {}))
+            return true;
+    }
+    return stepper.done();
+}
+
+/// Take steps from \p stepper until \p budget has elapsed.
+/** Returns true if the maze is complete. */
+template <Stepper S>
+auto run_for(S& stepper, std::chrono::steady_clock::duration budget) -> bool
+{
+    return run_for(stepper, budget, [](Step const&) {});
+}
+
+}  // namespace maze
+#endif  // MAZE_STEPPER_HPP
@@ -0,0 +1,209 @@
+#ifndef MAZE_STORAGE_HPP
+#define MAZE_STORAGE_HPP
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include <unistd.h>
+
+#include <maze/layout.hpp>
+#include <maze/mapped_file.hpp>
+
+namespace maze {
+
+/// Fixed length array of T kept in a Read_write file mapping. Move only.
+/** Lets Mazes and solver scratch arrays grow past physical memory, the page
+ *  cache decides what stays resident. */
+template <typename T>
+    requires std::is_trivially_copyable_v<T>
+class Mapped_array {
+   public:
+    /// Create or truncate the file at \p path to hold \p count zeroed Ts.
+    /** Throws std::system_error if the file can't be created or mapped. */
+    [[nodiscard]] static auto create(std::filesystem::path const& path,
+                                     std::size_t count) -> Mapped_array
+    {
+        return Mapped_array{Mapped_file::create(path, count * sizeof(T)), path};
+    }
+
+    /// Map the existing file at \p path, keeping its contents.
+    /** Throws std::system_error if the file can't be opened or mapped and
+     *  std::runtime_error if its size is not a multiple of sizeof(T). */
+    [[nodiscard]] static auto open(std::filesystem::path const& path)
+        -> Mapped_array
+    {
+        auto file = Mapped_file{path, Map_mode::Read_write};
+        if (file.bytes().size() % sizeof(T) != 0)
+            throw std::runtime_error{"Mapped_array: file size mismatch."};
+        return Mapped_array{std::move(file), path};
+    }
+
+   public:
+    [[nodiscard]] auto data() -> T* { return elements_.data(); }
+
+    [[nodiscard]] auto data() const -> T const* { return elements_.data(); }
+
+    [[nodiscard]] auto size() const -> std::size_t { return elements_.size(); }
+
+    [[nodiscard]] auto begin() -> T* { return elements_.data(); }
+
+    [[nodiscard]] auto begin() const -> T const* { return elements_.data(); }
+
+    [[nodiscard]] auto end() -> T* { return begin() + size(); }
+
+    [[nodiscard]] auto end() const -> T const* { return begin() + size(); }
+
+    [[nodiscard]] auto operator[](std::size_t i) -> T& { return elements_[i]; }
+
+    [[nodiscard]] auto operator[](std::size_t i) const -> T const&
+    {
+        return elements_[i];
+    }
+
+    /// Return the path of the mapped file.
+    [[nodiscard]] auto path() const -> std::filesystem::path const&
+    {
+        return path_;
+    }
+
+    /// Block until all writes have reached the file.
+    /** Throws std::system_error on failure. */
+    void flush() { file_.flush(); }
+
+   private:
+    Mapped_file file_;
+    std::span<T> elements_;
+    std::filesystem::path path_;
+
+   private:
+    Mapped_array(Mapped_file file, std::filesystem::path path)
+        : file_{std::move(file)},
+          elements_{reinterpret_cast<T*>(file_.writable_bytes().data()),
+                    file_.bytes().size() / sizeof(T)},
+          path_{std::move(path)}
+    {}
+};
+
+/// Memory resource mapping each large allocation to its own file, so solver
+/// scratch can outgrow physical memory like a Mapped_storage Maze.
+/** Allocations of at least \p threshold bytes get a sparse file in
+ *  \p directory, unlinked as soon as it is mapped, so nothing is left behind
+ *  when the memory is released or the process dies. Smaller ones come from
+ *  \p upstream. allocate() throws std::system_error if a file can't be
+ *  created. Thread safe. Mappings are page aligned, larger alignments are not
+ *  supported. */
+class Mapped_resource : public std::pmr::memory_resource {
+   public:
+    explicit Mapped_resource(
+        std::filesystem::path directory,
+        std::size_t threshold               = std::size_t{1} << 20,
+        std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : directory_{std::move(directory)},
+          threshold_{threshold},
+          upstream_{upstream}
+    {}
+
+    Mapped_resource(Mapped_resource const&) = delete;
+    auto operator=(Mapped_resource const&) -> Mapped_resource& = delete;
+
+   private:
+    std::filesystem::path directory_;
+    std::size_t threshold_;
+    std::pmr::memory_resource* upstream_;
+    std::mutex mutex_;
+    std::size_t next_id_ = 0;
+    std::unordered_map<void*, Mapped_file> mappings_;
+
+   private:
+    [[nodiscard]] auto is_mapped(std::size_t bytes) const -> bool
+    {
+        return bytes != 0 && bytes >= threshold_;
+    }
+
+    auto do_allocate(std::size_t bytes, std::size_t alignment) -> void* override
+    {
+        if (!is_mapped(bytes))
+            return upstream_->allocate(bytes, alignment);
+
+        auto const lock = std::scoped_lock{mutex_};
+        auto const owner = reinterpret_cast<std::uintptr_t>(this);
+        auto const path =
+            directory_ / ("maze-scratch-" + std::to_string(::getpid()) + "-" +
+                          std::to_string(owner) + "-" +
+                          std::to_string(next_id_++));
+        auto file = Mapped_file::create(path, bytes);
+        std::filesystem::remove(path);
+        auto* const data = file.writable_bytes().data();
+        mappings_.emplace(data, std::move(file));
+        return data;
+    }
+
+    void do_deallocate(void* p, std::size_t bytes,
+                       std::size_t alignment) override
+    {
+        if (!is_mapped(bytes)) {
+            upstream_->deallocate(p, bytes, alignment);
+            return;
+        }
+        auto const lock = std::scoped_lock{mutex_};
+        mappings_.erase(p);
+    }
+
+    [[nodiscard]] auto do_is_equal(std::pmr::memory_resource const& other)
+        const noexcept -> bool override
+    {
+        return this == &other;
+    }
+};
+
+/// Storage policy: Words held inside the Maze object, usable in constexpr.
+struct Inline_storage {
+    template <std::size_t WordCount>
+    using words = std::array<Word, WordCount>;
+};
+
+/// Storage policy: Words held in a file mapping, see Mapped_array.
+/** The Maze must be constructed from a Mapped_array<Word> of word_count. */
+struct Mapped_storage {
+    template <std::size_t WordCount>
+    using words = Mapped_array<Word>;
+};
+
+}  // namespace maze
+
+namespace maze::detail {
+
+/// Scratch memory for a solver run over a Cell_grid: a Mapped_resource next
+/// to the file of a Mapped_storage Maze, the default resource otherwise.
+class Scratch_memory {
+   public:
+    template <typename G>
+    explicit Scratch_memory(G const& grid)
+    {
+        if constexpr (requires { grid.storage().path(); })
+            mapped_.emplace(grid.storage().path().parent_path());
+    }
+
+    [[nodiscard]] auto resource() -> std::pmr::memory_resource*
+    {
+        if (mapped_.has_value())
+            return &*mapped_;
+        return std::pmr::get_default_resource();
+    }
+
+   private:
+    std::optional<Mapped_resource> mapped_;
+};
+
+}  // namespace maze::detail
+#endif  // MAZE_STORAGE_HPP
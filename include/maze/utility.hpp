@@ -9,10 +9,12 @@
 #include <stdexcept>
 
 #include <maze/cell.hpp>
+#include <maze/cell_grid.hpp>
 #include <maze/direction.hpp>
 #include <maze/distance.hpp>
 #include <maze/maze.hpp>
 #include <maze/point.hpp>
+#include <maze/random.hpp>
 
 namespace maze::utility {
 
@@ -34,33 +36,50 @@ auto make_directions_pack() -> Directions_pack<Direction::North,
     return {};
 }
 
-/// Return all four Directions in a random order.
-[[nodiscard]] auto shuffled_directions() -> std::array<Direction, 4>
+/// Return all four Directions in a random order, drawn from \p gen.
+template <std::uniform_random_bit_generator Gen>
+[[nodiscard]] constexpr auto shuffled_directions(Gen& gen)
+    -> std::array<Direction, 4>
 {
     auto init = directions;
-    std::shuffle(std::begin(init), std::end(init), random_gen);
+    detail::shuffle(init, gen);
     return init;
 }
 
+/// Return all four Directions in a random order.
+[[nodiscard]] auto shuffled_directions() -> std::array<Direction, 4>
+{
+    return shuffled_directions(random_gen);
+}
+
+/// Generate a random Point between { [0, Width), [0, Height) } from \p gen.
+template <Distance Width,
+          Distance Height,
+          std::uniform_random_bit_generator Gen>
+[[nodiscard]] constexpr auto random_point(Gen& gen) -> Point
+{
+    static_assert(Width != 0 && Height != 0);
+    auto const x = static_cast<Distance>(detail::uniform_to(gen, Width - 1));
+    auto const y = static_cast<Distance>(detail::uniform_to(gen, Height - 1));
+    return {x, y};
+}
+
 /// Generate a random Point between { [0, Width), [0, Height) };
 template <Distance Width, Distance Height>
 [[nodiscard]] auto random_point() -> Point
 {
-    static_assert(Width != 0 && Height != 0);
-    static auto x_dist = std::uniform_int_distribution<Distance>{0, Width - 1};
-    static auto y_dist = std::uniform_int_distribution<Distance>{0, Height - 1};
-
-    return {x_dist(random_gen), y_dist(random_gen)};
+    return random_point<Width, Height>(random_gen);
 }
 
 /// Return adjacent Point to \p p  in Direction \p d.
 /** Returns std::nullopt if outside of x: [0, Width-1); y: [0, Height-1); */
 template <Distance Width, Distance Height>
-[[nodiscard]] auto next_point(Point p, Direction d) -> std::optional<Point>
+[[nodiscard]] constexpr auto next_point(Point p, Direction d)
+    -> std::optional<Point>
 {
     switch (d) {
         case Direction::North:
-            return (p.y - 1 < 0)
+            return (p.y == 0)
                        ? std::nullopt
                        : std::optional<Point>{{p.x, (Distance)(p.y - 1)}};
         case Direction::South:
@@ -72,15 +91,27 @@ template <Distance Width, Distance Height>
                        ? std::nullopt
                        : std::optional<Point>{{(Distance)(p.x + 1), p.y}};
         case Direction::West:
-            return (p.x - 1 < 0)
+            return (p.x == 0)
                        ? std::nullopt
                        : std::optional<Point>{{(Distance)(p.x - 1), p.y}};
         default: throw std::logic_error{"Invalid Direction"};
     }
 }
 
+/// Return adjacent Point to \p p in Direction \p d, without bounds checks.
+[[nodiscard]] constexpr auto step(Point p, Direction d) -> Point
+{
+    switch (d) {
+        case Direction::North: return {p.x, (Distance)(p.y - 1)};
+        case Direction::South: return {p.x, (Distance)(p.y + 1)};
+        case Direction::East: return {(Distance)(p.x + 1), p.y};
+        case Direction::West: return {(Distance)(p.x - 1), p.y};
+        default: throw std::logic_error{"Invalid Direction"};
+    }
+}
+
 /// Return the opposite direction of \p d.
-[[nodiscard]] auto opposite(Direction d) -> Direction
+[[nodiscard]] constexpr auto opposite(Direction d) -> Direction
 {
     switch (d) {
         case Direction::North: return Direction::South;
@@ -92,23 +123,60 @@ template <Distance Width, Distance Height>
 }
 
 /// Returns true if \p p  is a Cell::Passage in \p maze.
-template <Distance Width, Distance Height>
-[[nodiscard]] auto is_passage(Maze<Width, Height> const& maze, Point p) -> bool
+template <Cell_grid G>
+[[nodiscard]] constexpr auto is_passage(G const& maze, Point p) -> bool
 {
     return maze.get(p) == Cell::Passage;
 }
 
-/// Return true if there is only a single adjacent Cell::Passage to \p p.
-template <Distance Width, Distance Height>
-[[nodiscard]] auto is_dead_end(Maze<Width, Height> const& maze, Point p) -> bool
+/// Return the number of Cell::Passages adjacent to \p p in \p maze.
+/** With a sentinel border Layout each neighbor is a single index add. */
+template <Cell_grid G>
+[[nodiscard]] auto passage_count(G const& maze, Point p) -> int
+{
+    auto count = 0;
+    if constexpr (detail::Sentinel_grid<G>) {
+        auto const at = G::index_of(p);
+        for (auto const direction : directions) {
+            count += maze.get_at(G::neighbor_index(at, direction)) ==
+                Cell::Passage;
+        }
+    }
+    else {
+        for (auto const direction : directions) {
+            auto const next = next_point<G::width, G::height>(p, direction);
+            if (next.has_value() && maze.get(*next) == Cell::Passage)
+                ++count;
+        }
+    }
+    return count;
+}
+
+/// Return the adjacent Point to \p p in Direction \p d if it is a Passage.
+/** Returns std::nullopt for Walls and for Points outside of \p maze. */
+template <Cell_grid G>
+[[nodiscard]] auto next_passage(G const& maze, Point p, Direction d)
+    -> std::optional<Point>
 {
-    auto passage_count = 0;
-    for (auto const direction : directions) {
-        auto const next = next_point<Width, Height>(p, direction);
+    if constexpr (detail::Sentinel_grid<G>) {
+        auto const at = G::neighbor_index(G::index_of(p), d);
+        if (maze.get_at(at) == Cell::Passage)
+            return step(p, d);
+        return std::nullopt;
+    }
+    else {
+        auto const next = next_point<G::width, G::height>(p, d);
         if (next.has_value() && maze.get(*next) == Cell::Passage)
-            ++passage_count;
+            return next;
+        return std::nullopt;
     }
-    return passage_count == 1;
+}
+
+/// Return true if there is only a single adjacent Cell::Passage to \p p.
+template <Cell_grid G>
+[[nodiscard]] auto is_dead_end(G const& maze, Point p) -> bool
+{
+    return passage_count(maze, p) == 1;
 }
 
 /// Iterator wrapper that returns the dereference of the value_t on operator*.
@@ -217,11 +285,11 @@ class Dereference_iterator {
 };
 
 /// Return true if \p d is odd.
-[[nodiscard]] inline auto is_odd(Distance d) -> bool { return (d % 2) == 1; }
+[[nodiscard]] constexpr auto is_odd(Distance d) -> bool { return (d % 2) == 1; }
 
 /// Makes a single value even, without going over Limit.
 template <Distance Limit>
-[[nodiscard]] auto make_even(Distance const at) -> Distance
+[[nodiscard]] constexpr auto make_even(Distance const at) -> Distance
 {
     if (utility::is_odd(at)) {
         if (at + 1 >= Limit)
@@ -235,12 +303,12 @@ template <Distance Limit>
 
 /// Returns a point that has coordinates that are even and within limits(W/H).
 template <Distance Width, Distance Height>
-[[nodiscard]] auto make_even(maze::Point p) -> maze::Point
+[[nodiscard]] constexpr auto make_even(maze::Point p) -> maze::Point
 {
     return {make_even<Width>(p.x), make_even<Height>(p.y)};
 }
 
-[[nodiscard]] auto times_two(Point p) -> Point
+[[nodiscard]] constexpr auto times_two(Point p) -> Point
 {
     return {(Distance)(p.x * 2), (Distance)(p.y * 2)};
 }
@@ -253,41 +321,48 @@ struct Point_diff {
     Distance_diff y;
 };
 
-[[nodiscard]] auto subtract(Point a, Point b) -> Point_diff
+[[nodiscard]] constexpr auto subtract(Point a, Point b) -> Point_diff
 {
     return {(Distance_diff)(a.x - b.x), (Distance_diff)(a.y - b.y)};
 }
 
-[[nodiscard]] auto add(Point a, Point b) -> Point
+[[nodiscard]] constexpr auto add(Point a, Point b) -> Point
 {
     return {(Distance)(a.x + b.x), (Distance)(a.y + b.y)};
 }
 
-[[nodiscard]] auto add(Point a, Point_diff b) -> Point
+[[nodiscard]] constexpr auto add(Point a, Point_diff b) -> Point
 {
     return {(Distance)(a.x + b.x), (Distance)(a.y + b.y)};
 }
 
-[[nodiscard]] auto add(Point_diff a, Point b) -> Point
+[[nodiscard]] constexpr auto add(Point_diff a, Point b) -> Point
 {
     return {(Distance)(a.x + b.x), (Distance)(a.y + b.y)};
 }
 
-[[nodiscard]] auto half(Point p) -> Point
+[[nodiscard]] constexpr auto half(Point p) -> Point
 {
     return {(Distance)(p.x / 2), (Distance)(p.y / 2)};
 }
 
-[[nodiscard]] auto half(Point_diff p) -> Point_diff
+[[nodiscard]] constexpr auto half(Point_diff p) -> Point_diff
 {
     return {(Distance_diff)(p.x / 2), (Distance_diff)(p.y / 2)};
 }
 
+/// Generates a random index from [0, limit], drawn from \p gen.
+template <std::uniform_random_bit_generator Gen>
+[[nodiscard]] constexpr auto random_index(std::size_t limit, Gen& gen)
+    -> std::size_t
+{
+    return static_cast<std::size_t>(detail::uniform_to(gen, limit));
+}
+
 /// Generates a random index from [0, limit].
 [[nodiscard]] auto random_index(std::size_t limit) -> std::size_t
 {
-    auto dist = std::uniform_int_distribution<std::size_t>{0, limit};
-    return dist(random_gen);
+    return random_index(limit, random_gen);
 }
 
 [[nodiscard]] constexpr auto ceil(float x) -> Distance
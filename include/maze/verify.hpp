@@ -0,0 +1,272 @@
+#ifndef MAZE_VERIFY_HPP
+#define MAZE_VERIFY_HPP
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <numeric>
+#include <string_view>
+#include <vector>
+
+#include <maze/cell.hpp>
+#include <maze/cell_grid.hpp>
+#include <maze/distance.hpp>
+#include <maze/generate_kruskal.hpp>
+#include <maze/layout.hpp>
+#include <maze/maze.hpp>
+#include <maze/point.hpp>
+#include <maze/storage.hpp>
+
+namespace maze {
+
+/// The first reason a Maze is not a perfect maze.
+enum class Maze_defect : std::uint8_t {
+    None,           // A perfect maze.
+    Closed_room,    // A Wall at even x and even y.
+    Open_corner,    // A Passage at odd x and odd y.
+    Dangling_edge,  // A Passage on an even sized Maze's last row or column.
+    Cycle,          // A Passage that closes a loop.
+    Disconnected    // Rooms that no Passage reaches.
+};
+
+/// Return the snake case name of \p d.
+[[nodiscard]] constexpr auto to_string(Maze_defect d) -> std::string_view
+{
+    switch (d) {
+        case Maze_defect::None: return "none";
+        case Maze_defect::Closed_room: return "closed_room";
+        case Maze_defect::Open_corner: return "open_corner";
+        case Maze_defect::Dangling_edge: return "dangling_edge";
+        case Maze_defect::Cycle: return "cycle";
+        case Maze_defect::Disconnected: return "disconnected";
+    }
+    return "unknown";
+}
+
+/// Result of verify_perfect().
+struct Verification {
+    /// Maze_defect::None if the Maze is perfect.
+    Maze_defect defect = Maze_defect::None;
+    /// Cell of the first defect found, in row order, {0, 0} if none.
+    Point at = {0, 0};
+    /// Rooms, the cells at even x and even y.
+    std::size_t rooms = 0;
+    /// Passages joining two rooms, counted up to the first defect.
+    std::size_t edges = 0;
+
+    /// Return true if the Maze is perfect.
+    [[nodiscard]] constexpr explicit operator bool() const
+    {
+        return defect == Maze_defect::None;
+    }
+
+    friend auto constexpr operator==(Verification const&, Verification const&)
+        -> bool = default;
+};
+
+/// Scratch memory for verify_perfect.
+/** One union-find parent per room. Keeps its capacity across calls. */
+struct Verify_workspace {
+    Verify_workspace() = default;
+
+    /// Allocate all scratch memory from \p resource.
+    explicit Verify_workspace(std::pmr::memory_resource* resource)
+        : parent(resource)
+    {}
+
+    std::pmr::vector<std::size_t> parent;
+};
+
+}  // namespace maze
+
+namespace maze::detail {
+
+/// Bits at even positions, Cells at even x of a row Word.
+inline constexpr auto even_cells = Word{0x5555'5555'5555'5555};
+
+/// Return Cells [64 * \p i, 64 * \p i + 64) of row \p y, a set bit is a
+/// Passage. Bits past Width are zero.
+template <Distance Width, Distance Height, typename Layout, typename Storage>
+[[nodiscard]] constexpr auto row_chunk(
+    Maze<Width, Height, Layout, Storage> const& maze,
+    Distance y,
+    std::size_t i) -> Word
+{
+    auto const first = i * word_bits;
+    auto const count = std::min(std::size_t{Width} - first, word_bits);
+    if constexpr (Row_contiguous<Layout>) {
+        auto const begin = Layout::template row_begin<Width, Height>(y);
+        return read_bits(maze.words(), begin + first, count);
+    }
+    else {
+        auto bits = Word{0};
+        for (auto k = std::size_t{0}; k < count; ++k) {
+            auto const at = Point{static_cast<Distance>(first + k), y};
+            if (maze.get(at) == Cell::Passage)
+                bits |= Word{1} << k;
+        }
+        return bits;
+    }
+}
+
+/// Return Cells [64 * \p i, 64 * \p i + 64) of row \p y of \p grid, a set
+/// bit is a Passage. Bits past its width are zero.
+/** Uses the grid's own row_chunk() if it has one, else gets each Cell. */
+template <Cell_grid G>
+[[nodiscard]] constexpr auto row_chunk(G const& grid,
+                                       Distance y,
+                                       std::size_t i) -> Word
+{
+    if constexpr (requires { grid.row_chunk(y, i); }) {
+        return grid.row_chunk(y, i);
+    }
+    else {
+        auto const first = i * word_bits;
+        auto const count = std::min(std::size_t{G::width} - first, word_bits);
+        auto bits        = Word{0};
+        for (auto k = std::size_t{0}; k < count; ++k) {
+            auto const at = Point{static_cast<Distance>(first + k), y};
+            if (grid.get(at) == Cell::Passage)
+                bits |= Word{1} << k;
+        }
+        return bits;
+    }
+}
+
+/// Return the first Point set in row chunk \p bits, chunk \p i of row \p y.
+[[nodiscard]] constexpr auto first_in_chunk(Word bits,
+                                            std::size_t i,
+                                            Distance y) -> Point
+{
+    return {static_cast<Distance>((i * word_bits) + std::countr_zero(bits)),
+            y};
+}
+
+/// Check \p maze in a single pass over its rows, a Word at a time.
+/** Room rows must have every room open, corner rows every corner closed,
+ *  checked with whole Word masks. Each edge Passage joins its two rooms in a
+ *  union-find forest over \p parent; joining rooms already joined is a Cycle.
+ *  With no cycle, rooms - edges is the number of components, so the Maze is
+ *  perfect iff edges == rooms - 1. */
+template <Cell_grid G, typename Parents>
+[[nodiscard]] constexpr auto do_verify_perfect(G const& maze, Parents& parent)
+    -> Verification
+{
+    constexpr auto width   = std::size_t{G::width};
+    constexpr auto height  = std::size_t{G::height};
+    constexpr auto columns = (width + 1) / 2;
+    constexpr auto rows    = (height + 1) / 2;
+    constexpr auto chunks  = (width + word_bits - 1) / word_bits;
+    constexpr auto tail    = width - ((chunks - 1) * word_bits);
+
+    auto result  = Verification{};
+    result.rooms = columns * rows;
+    parent.resize(result.rooms);
+    std::iota(std::begin(parent), std::end(parent), std::size_t{0});
+
+    auto const fail = [&](Maze_defect d, Point at) {
+        result.defect = d;
+        result.at     = at;
+        return result;
+    };
+    // Bits past the last room of an even width row must be Walls.
+    auto const dangling = [](std::size_t i) -> Word {
+        return (width % 2 == 0 && i + 1 == chunks) ? Word{1} << (tail - 1)
+                                                   : Word{0};
+    };
+
+    for (auto y = Distance{0}; y < height; ++y) {
+        auto const room_row = y % 2 == 0;
+        auto const last_row = height % 2 == 0 && y + 1 == height;
+        for (auto i = std::size_t{0}; i < chunks; ++i) {
+            auto const valid = low_bits(i + 1 == chunks ? tail : word_bits);
+            auto const bits  = row_chunk(maze, y, i);
+            auto const even  = bits & even_cells;
+            auto const odd   = bits & ~even_cells & valid;
+            auto edges       = Word{0};
+            if (room_row) {
+                if (auto const closed = ~bits & even_cells & valid;
+                    closed != 0)
+                    return fail(Maze_defect::Closed_room,
+                                first_in_chunk(closed, i, y));
+                if (auto const open = odd & dangling(i); open != 0)
+                    return fail(Maze_defect::Dangling_edge,
+                                first_in_chunk(open, i, y));
+                edges = odd;
+            }
+            else {
+                if (odd != 0)
+                    return fail(Maze_defect::Open_corner,
+                                first_in_chunk(odd, i, y));
+                if (last_row && even != 0)
+                    return fail(Maze_defect::Dangling_edge,
+                                first_in_chunk(even, i, y));
+                edges = even;
+            }
+
+            for (; edges != 0; edges &= edges - 1) {
+                auto const at = first_in_chunk(edges, i, y);
+                // Rooms on either side, West/East or North/South.
+                auto const a = room_row
+                                   ? (y / 2 * columns) + ((at.x - 1) / 2)
+                                   : ((y - 1) / 2 * columns) + (at.x / 2);
+                auto const b = room_row ? a + 1 : a + columns;
+                auto const root_a = find_root(parent, a);
+                auto const root_b = find_root(parent, b);
+                if (root_a == root_b)
+                    return fail(Maze_defect::Cycle, at);
+                parent[root_b] = root_a;
+                ++result.edges;
+            }
+        }
+    }
+
+    if (result.edges + 1 == result.rooms)
+        return result;
+    // Report the first room not joined to room {0, 0}.
+    auto const origin = find_root(parent, 0);
+    auto room         = std::size_t{1};
+    while (find_root(parent, room) == origin)
+        ++room;
+    return fail(Maze_defect::Disconnected,
+                {static_cast<Distance>(room % columns * 2),
+                 static_cast<Distance>(room / columns * 2)});
+}
+
+}  // namespace maze::detail
+
+namespace maze {
+
+/// Check that \p m is a perfect maze: every room at even x and even y open,
+/// every corner at odd x and odd y closed, and the open walls between rooms
+/// forming a spanning tree, connected and acyclic.
+/** Runs in a single pass over the rows of \p m, near linear in its size.
+ *  Scratch memory is taken from \p workspace. */
+template <Cell_grid G>
+[[nodiscard]] auto verify_perfect(G const& m, Verify_workspace& workspace)
+    -> Verification
+{
+    return detail::do_verify_perfect(m, workspace.parent);
+}
+
+/// Check that \p m is a perfect maze.
+/** The scratch memory of a Mapped_storage Maze is file mapped beside it. */
+template <Cell_grid G>
+[[nodiscard]] auto verify_perfect(G const& m) -> Verification
+{
+    auto scratch   = detail::Scratch_memory{m};
+    auto workspace = Verify_workspace{scratch.resource()};
+    return verify_perfect(m, workspace);
+}
+
+/// Return true if \p m is a perfect maze. Usable in constant expressions.
+template <Cell_grid G>
+[[nodiscard]] constexpr auto is_perfect(G const& m) -> bool
+{
+    auto parent = std::vector<std::size_t>{};
+    return static_cast<bool>(detail::do_verify_perfect(m, parent));
+}
+
+}  // namespace maze
+#endif  // MAZE_VERIFY_HPP
@@ -0,0 +1,316 @@
+#ifndef MAZE_WALL_MAZE_HPP
+#define MAZE_WALL_MAZE_HPP
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+#include <maze/cell.hpp>
+#include <maze/direction.hpp>
+#include <maze/distance.hpp>
+#include <maze/edge.hpp>
+#include <maze/generate_kruskal.hpp>
+#include <maze/layout.hpp>
+#include <maze/maze.hpp>
+#include <maze/observer.hpp>
+#include <maze/point.hpp>
+#include <maze/random.hpp>
+#include <maze/verify.hpp>
+
+namespace maze::detail {
+
+/// Spread the 32 bits of \p x to the even bit positions of a Word.
+[[nodiscard]] constexpr auto spread_word(std::uint32_t x) -> Word
+{
+    auto w = Word{x};
+    w      = (w | (w << 16)) & 0x0000'FFFF'0000'FFFF;
+    w      = (w | (w << 8)) & 0x00FF'00FF'00FF'00FF;
+    w      = (w | (w << 4)) & 0x0F0F'0F0F'0F0F'0F0F;
+    w      = (w | (w << 2)) & 0x3333'3333'3333'3333;
+    w      = (w | (w << 1)) & 0x5555'5555'5555'5555;
+    return w;
+}
+
+/// Gather the even bits of \p w to the low 32 bits, inverse of spread_word().
+[[nodiscard]] constexpr auto compact_word(Word w) -> std::uint32_t
+{
+    w &= 0x5555'5555'5555'5555;
+    w = (w | (w >> 1)) & 0x3333'3333'3333'3333;
+    w = (w | (w >> 2)) & 0x0F0F'0F0F'0F0F'0F0F;
+    w = (w | (w >> 4)) & 0x00FF'00FF'00FF'00FF;
+    w = (w | (w >> 8)) & 0x0000'FFFF'0000'FFFF;
+    w = (w | (w >> 16)) & 0x0000'0000'FFFF'FFFF;
+    return static_cast<std::uint32_t>(w);
+}
+
+}  // namespace maze::detail
+
+namespace maze {
+
+/// A Maze stored as rooms with an East and a South wall bit each.
+/** Width and Height are those of the equivalent Maze, where rooms are the
+ *  Cells at even x and y, and the Cells between two rooms are their walls.
+ *  Only the wall bits are stored, 2 bits per room against the 4 Cells a room
+ *  takes in a Maze, so rooms are always Passages and the Cells at odd x and
+ *  odd y always Walls, as in every maze the generators carve. Each bit plane
+ *  is row-major with rows starting on a Word boundary, a set bit is an open
+ *  wall. Bits with no Cell in the Maze, East of the last column of an odd
+ *  Width, South of the last row of an odd Height, are zero. */
+template <Distance Width, Distance Height>
+class Wall_maze {
+    static_assert(Width != 0 && Height != 0);
+
+   public:
+    /// Size in Cells of the equivalent Maze, as for every Cell_grid.
+    static constexpr auto width  = Width;
+    static constexpr auto height = Height;
+
+    /// Rooms per row and rows of rooms.
+    static constexpr auto columns = static_cast<Distance>((Width + 1) / 2);
+    static constexpr auto rows    = static_cast<Distance>((Height + 1) / 2);
+
+    /// Words per row of rooms, in each of the two bit planes.
+    static constexpr auto words_per_row =
+        (std::size_t{columns} + word_bits - 1) / word_bits;
+
+    /// Words in each of the two bit planes.
+    static constexpr auto word_count = words_per_row * rows;
+
+   public:
+    /// Construct a maze with every wall closed.
+    constexpr Wall_maze() = default;
+
+    /// Construct the Wall_maze of \p maze.
+    /** Throws std::invalid_argument if a room of \p maze is a Wall or a Cell
+     *  at odd x and odd y a Passage, those can't be represented. */
+    template <typename Layout, typename Storage>
+    constexpr explicit Wall_maze(
+        Maze<Width, Height, Layout, Storage> const& maze)
+    {
+        constexpr auto chunks = (std::size_t{Width} + word_bits - 1) /
+                                word_bits;
+        constexpr auto tail = std::size_t{Width} - ((chunks - 1) * word_bits);
+        for (auto y = Distance{0}; y < Height; ++y) {
+            auto& plane = y % 2 == 0 ? east_ : south_;
+            auto const row = (std::size_t{y} / 2) * words_per_row;
+            for (auto i = std::size_t{0}; i < chunks; ++i) {
+                auto const valid = detail::low_bits(
+                    i + 1 == chunks ? tail : word_bits);
+                auto const bits = detail::row_chunk(maze, y, i);
+                if (y % 2 == 0 && (~bits & detail::even_cells & valid) != 0)
+                    throw std::invalid_argument{"Wall_maze: closed room."};
+                if (y % 2 != 0 && (bits & ~detail::even_cells) != 0)
+                    throw std::invalid_argument{"Wall_maze: open corner."};
+                auto const walls =
+                    Word{detail::compact_word(y % 2 == 0 ? bits >> 1 : bits)};
+                plane[row + (i / 2)] |= walls << (32 * (i % 2));
+            }
+        }
+    }
+
+   public:
+    /// Get the Cell of the equivalent Maze at Point \p p.
+    [[nodiscard]] constexpr auto get(Point p) const -> Cell
+    {
+        assert(p.x < Width && p.y < Height);
+        auto const room = Point{static_cast<Distance>(p.x / 2),
+                                static_cast<Distance>(p.y / 2)};
+        if (p.x % 2 == 0 && p.y % 2 == 0)
+            return Cell::Passage;
+        if (p.x % 2 != 0 && p.y % 2 != 0)
+            return Cell::Wall;
+        auto const& plane = p.x % 2 != 0 ? east_ : south_;
+        return detail::test_bit(plane, bit_index(room)) ? Cell::Passage
+                                                        : Cell::Wall;
+    }
+
+    /// Return true if the wall of \p room in Direction \p d is open.
+    /** \p room is in room coordinates, {x / 2, y / 2} of the Maze. */
+    [[nodiscard]] constexpr auto is_open(Point room, Direction d) const
+        -> bool
+    {
+        assert(room.x < columns && room.y < rows);
+        switch (d) {
+            case Direction::North:
+                return room.y != 0 &&
+                       detail::test_bit(south_, bit_index(north_of(room)));
+            case Direction::South:
+                return detail::test_bit(south_, bit_index(room));
+            case Direction::East:
+                return detail::test_bit(east_, bit_index(room));
+            case Direction::West:
+                return room.x != 0 &&
+                       detail::test_bit(east_, bit_index(west_of(room)));
+        }
+        return false;
+    }
+
+    /// Open or close the wall of \p room in Direction \p d.
+    /** The wall must be inside the equivalent Maze. */
+    constexpr void set_open(Point room, Direction d, bool open)
+    {
+        assert(room.x < columns && room.y < rows);
+        switch (d) {
+            case Direction::North:
+                assert(room.y != 0);
+                detail::assign_bit(south_, bit_index(north_of(room)), open);
+                break;
+            case Direction::South:
+                assert((2 * std::size_t{room.y}) + 1 < Height);
+                detail::assign_bit(south_, bit_index(room), open);
+                break;
+            case Direction::East:
+                assert((2 * std::size_t{room.x}) + 1 < Width);
+                detail::assign_bit(east_, bit_index(room), open);
+                break;
+            case Direction::West:
+                assert(room.x != 0);
+                detail::assign_bit(east_, bit_index(west_of(room)), open);
+                break;
+        }
+    }
+
+    /// Open the wall between the adjacent rooms of \p edge.
+    constexpr void carve(Edge const edge)
+    {
+        auto const& [a, b] = edge;
+        if (a.y == b.y)
+            set_open(a.x < b.x ? a : b, Direction::East, true);
+        else
+            set_open(a.y < b.y ? a : b, Direction::South, true);
+    }
+
+    /// Close every wall.
+    constexpr void close_all()
+    {
+        east_.fill(Word{0});
+        south_.fill(Word{0});
+    }
+
+    /// Return Cells [64 * \p i, 64 * \p i + 64) of row \p y of the
+    /// equivalent Maze, a set bit is a Passage. Bits past Width are zero.
+    /** Spreads 32 wall bits of a plane, no Maze is built. */
+    [[nodiscard]] constexpr auto row_chunk(Distance y, std::size_t i) const
+        -> Word
+    {
+        assert(y < Height && i * word_bits < Width);
+        auto const& plane = y % 2 == 0 ? east_ : south_;
+        auto const row    = (std::size_t{y} / 2) * words_per_row;
+        auto const walls  = detail::spread_word(static_cast<std::uint32_t>(
+            plane[row + (i / 2)] >> (32 * (i % 2))));
+        if (y % 2 != 0)
+            return walls;
+        auto const valid = detail::low_bits(
+            std::min(std::size_t{Width} - (i * word_bits), word_bits));
+        return ((walls << 1) | detail::even_cells) & valid;
+    }
+
+    /// Overwrite \p maze with the equivalent Cells.
+    /** Builds each Maze row a Word at a time from the wall bits. */
+    template <typename Layout, typename Storage>
+    constexpr void write_to(Maze<Width, Height, Layout, Storage>& maze) const
+    {
+        constexpr auto chunks = (std::size_t{Width} + word_bits - 1) /
+                                word_bits;
+        auto bits = std::array<Word, chunks>{};
+        for (auto y = Distance{0}; y < Height; ++y) {
+            for (auto i = std::size_t{0}; i < chunks; ++i)
+                bits[i] = row_chunk(y, i);
+            maze.write_row(y, bits);
+        }
+    }
+
+    /// Return the equivalent Maze.
+    template <typename Layout = Row_major>
+    [[nodiscard]] constexpr auto to_maze() const
+        -> Maze<Width, Height, Layout>
+    {
+        auto result = Maze<Width, Height, Layout>{Cell::Wall};
+        write_to(result);
+        return result;
+    }
+
+    /// Return the East wall bits, bit x of row y is room {x, y}.
+    [[nodiscard]] constexpr auto east_words() const
+        -> std::array<Word, word_count> const&
+    {
+        return east_;
+    }
+
+    /// Return the South wall bits, bit x of row y is room {x, y}.
+    [[nodiscard]] constexpr auto south_words() const
+        -> std::array<Word, word_count> const&
+    {
+        return south_;
+    }
+
+    friend constexpr auto operator==(Wall_maze const&, Wall_maze const&)
+        -> bool = default;
+
+   private:
+    std::array<Word, word_count> east_{};
+    std::array<Word, word_count> south_{};
+
+   private:
+    [[nodiscard]] static constexpr auto bit_index(Point room) -> std::size_t
+    {
+        return (std::size_t{room.y} * words_per_row * word_bits) + room.x;
+    }
+
+    [[nodiscard]] static constexpr auto north_of(Point room) -> Point
+    {
+        return {room.x, static_cast<Distance>(room.y - 1)};
+    }
+
+    [[nodiscard]] static constexpr auto west_of(Point room) -> Point
+    {
+        return {static_cast<Distance>(room.x - 1), room.y};
+    }
+};
+
+/// Overwrite \p m with a maze from a randomized Kruskal's MST algorithm.
+/** Opens wall bits only, at half the memory traffic of a Maze. Draws the
+ *  same randomness as the Maze overload, so equal generators give equivalent
+ *  mazes. \p observer sees the "kruskal" phase, Edges checked and merges. */
+template <Distance Width,
+          Distance Height,
+          std::uniform_random_bit_generator Gen,
+          Observer O = Null_observer>
+void generate_kruskal_into(Wall_maze<Width, Height>& m,
+                           Kruskal_workspace& workspace,
+                           Gen& gen,
+                           O observer = {})
+{
+    using Rooms      = Wall_maze<Width, Height>;
+    auto const phase = detail::Phase_scope{observer, "kruskal"};
+    auto& edges      = workspace.edges;
+    auto& parent     = workspace.parent;
+
+    detail::generate_all_maze_edges<Rooms::columns, Rooms::rows>(edges);
+    detail::shuffle(edges, gen);
+    parent.resize(std::size_t{Rooms::columns} * Rooms::rows);
+    std::iota(std::begin(parent), std::end(parent), std::size_t{0});
+    m.close_all();
+
+    auto const index_of = [](Point p) {
+        return (std::size_t{p.y} * Rooms::columns) + p.x;
+    };
+    for (auto const edge : edges) {
+        auto const root_a = detail::find_root(parent, index_of(edge.a));
+        auto const root_b = detail::find_root(parent, index_of(edge.b));
+        observer.count(Counter::Edges_checked, 1);
+        if (root_a != root_b) {
+            parent[root_b] = root_a;
+            observer.count(Counter::Merges, 1);
+            m.carve(edge);
+        }
+    }
+}
+
+}  // namespace maze
+#endif  // MAZE_WALL_MAZE_HPP
@@ -0,0 +1,82 @@
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+#include <utility>
+
+#include <maze/analytics.hpp>
+#include <maze/differential.hpp>
+#include <maze/distance.hpp>
+#include <maze/generator_pool.hpp>
+#include <maze/layout.hpp>
+#include <maze/longest_path.hpp>
+#include <maze/maze.hpp>
+#include <maze/serialize.hpp>
+
+// Runs run_differential over every generator and Layout, sized for CI. Each
+// maze is checked with verify_perfect, then the dead end count and longest
+// path of find_all_leaves and longest_path, the reference, must match those
+// of analyze, the candidate. Exits 1 on any invalid maze or mismatch.
+
+namespace {
+
+constexpr auto seed  = std::uint64_t{2024};
+constexpr auto count = std::size_t{12};
+
+constexpr auto generators = std::array{
+    std::pair{maze::Generator_id::Recursive_backtracking,
+              "recursive_backtracking"},
+    std::pair{maze::Generator_id::Kruskal, "kruskal"},
+    std::pair{maze::Generator_id::Prims, "prims"},
+    std::pair{maze::Generator_id::Aldous_broder, "aldous_broder"},
+    std::pair{maze::Generator_id::Recursive_division, "recursive_division"},
+    std::pair{maze::Generator_id::Ellers, "ellers"},
+    std::pair{maze::Generator_id::Binary_tree, "binary_tree"},
+    std::pair{maze::Generator_id::Sidewinder, "sidewinder"},
+    std::pair{maze::Generator_id::Hunt_and_kill, "hunt_and_kill"},
+};
+
+auto failures = 0;
+
+/// Run every generator on Width x Height Mazes of \p Layout, named \p layout.
+template <maze::Distance Width, maze::Distance Height, typename Layout>
+void run_layout(std::string_view layout)
+{
+    using Maze_type = maze::Maze<Width, Height, Layout>;
+    auto const reference = [](Maze_type const& m) {
+        return std::pair{maze::find_all_leaves(m).size(),
+                         maze::longest_path(m).size()};
+    };
+    auto const candidate = [](Maze_type const& m) {
+        auto const metrics = maze::analyze(m);
+        return std::pair{std::size_t{metrics.dead_ends()},
+                         std::size_t{metrics.diameter}};
+    };
+
+    for (auto const& [id, name] : generators) {
+        auto const report = maze::run_differential<Width, Height, Layout>(
+            id, seed, count, reference, candidate);
+        std::cout << name << ' ' << layout << ' ' << Width << 'x' << Height
+                  << ": " << report;
+        if (!report.passed())
+            ++failures;
+    }
+}
+
+template <maze::Distance Width, maze::Distance Height>
+void run_layouts()
+{
+    run_layout<Width, Height, maze::Row_major>("row_major");
+    run_layout<Width, Height, maze::Tiled_8x8>("tiled_8x8");
+    run_layout<Width, Height, maze::Morton>("morton");
+    run_layout<Width, Height, maze::Padded_row_major>("padded_row_major");
+}
+
+}  // namespace
+
+int main()
+{
+    run_layouts<31, 17>();
+    run_layouts<70, 12>();
+    return failures == 0 ? 0 : 1;
+}
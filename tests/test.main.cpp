@@ -1,18 +1,1304 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <random>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
 #include <utility>
+#include <vector>
 
+#include <maze/analytics.hpp>
+#include <maze/archive.hpp>
+#include <maze/async.hpp>
+#include <maze/bias.hpp>
 #include <maze/display.hpp>
+#include <maze/generate_3d.hpp>
 #include <maze/generate_aldous_broder.hpp>
+#include <maze/generate_biased.hpp>
+#include <maze/generate_hunt_and_kill.hpp>
 #include <maze/generate_kruskal.hpp>
+#include <maze/generate_matching.hpp>
 #include <maze/generate_prims.hpp>
 #include <maze/generate_recursive_backtracking.hpp>
 #include <maze/generate_recursive_division.hpp>
+#include <maze/generator_pool.hpp>
 #include <maze/graph/adjacency_list.hpp>
 #include <maze/graph/connected_components.hpp>
 #include <maze/graph/disjoint_set.hpp>
+#include <maze/lattice.hpp>
+#include <maze/layout.hpp>
 #include <maze/longest_path.hpp>
 #include <maze/maze.hpp>
+#include <maze/maze_hash.hpp>
+#include <maze/maze_view.hpp>
+#include <maze/maze_world.hpp>
+#include <maze/observer.hpp>
+#include <maze/origin_shift.hpp>
+#include <maze/path.hpp>
+#include <maze/serialize.hpp>
+#include <maze/stepper.hpp>
+#include <maze/solution_cache.hpp>
 #include <maze/utility.hpp>
+#include <maze/verify.hpp>
+#include <maze/wall_maze.hpp>
+
+// Prints a maze of each classic generator, then runs the checks below and
+// exits 1 if any of them failed.
+
+namespace {
+
+constexpr auto generators = std::array{
+    maze::Generator_id::Recursive_backtracking,
+    maze::Generator_id::Kruskal,
+    maze::Generator_id::Prims,
+    maze::Generator_id::Aldous_broder,
+    maze::Generator_id::Recursive_division,
+    maze::Generator_id::Ellers,
+    maze::Generator_id::Binary_tree,
+    maze::Generator_id::Sidewinder,
+    maze::Generator_id::Hunt_and_kill,
+};
+
+auto failures = 0;
+
+/// Report \p what as a failure unless \p ok.
+void check(bool ok, std::string_view what)
+{
+    if (!ok) {
+        std::cerr << "FAILED: " << what << '\n';
+        ++failures;
+    }
+}
+
+/// Report \p what as a failure unless \p f throws an Exception.
+template <typename Exception, typename F>
+void check_throws(F&& f, std::string_view what)
+{
+    try {
+        f();
+    }
+    catch (Exception const&) {
+        return;
+    }
+    catch (...) {
+    }
+    check(false, what);
+}
+
+static_assert(maze::is_perfect(maze::baked_kruskal<41, 21, 7>));
+static_assert(maze::is_perfect(maze::baked_recursive_backtracking<41, 21, 7>));
+static_assert(maze::is_perfect(maze::baked_recursive_division<41, 21, 7>));
+
+/// Return a Width x Height maze from generator \p id, seeded with \p seed.
+template <maze::Distance Width,
+          maze::Distance Height,
+          typename Layout = maze::Row_major>
+auto make_maze(maze::Generator_id id, std::uint64_t seed)
+    -> maze::Maze<Width, Height, Layout>
+{
+    auto result    = maze::Maze<Width, Height, Layout>{maze::Cell::Wall};
+    auto workspace = maze::Generator_workspace{};
+    auto gen       = std::mt19937_64{seed};
+    maze::generate_into(id, result, workspace, gen);
+    return result;
+}
+
+/// Return a path in the temp directory for a scratch file named \p name.
+auto scratch_file(std::string_view name) -> std::filesystem::path
+{
+    return std::filesystem::temp_directory_path() / name;
+}
+
+/// Executor that fails every task, like one that can't start a thread.
+struct Failing_executor {
+    void execute(std::function<void()>)
+    {
+        throw std::runtime_error{"Failing_executor: no threads."};
+    }
+};
+
+/// Random bit generator that requests a stop after its first \p draws.
+struct Stopping_gen {
+    using result_type = std::mt19937_64::result_type;
+
+    std::stop_source* source;
+    std::size_t draws;
+    std::mt19937_64 gen{1};
+
+    static constexpr auto min() { return std::mt19937_64::min(); }
+    static constexpr auto max() { return std::mt19937_64::max(); }
+
+    auto operator()() -> result_type
+    {
+        if (draws == 0 || --draws == 0)
+            source->request_stop();
+        return gen();
+    }
+};
+
+/// Observer that requests a stop after its first \p gauges.
+struct Stopping_observer {
+    std::stop_source* source;
+    std::size_t* gauges;
+
+    void count(maze::Counter, std::size_t) const {}
+    void gauge(maze::Counter, std::size_t) const
+    {
+        if (*gauges == 0 || --*gauges == 0)
+            source->request_stop();
+    }
+    void begin_phase(std::string_view) const {}
+    void end_phase() const {}
+};
+
+/// Memory resource that counts the allocations it passes on to \p upstream.
+struct Counting_resource : std::pmr::memory_resource {
+    explicit Counting_resource(std::pmr::memory_resource* upstream)
+        : upstream{upstream}
+    {}
+
+    std::pmr::memory_resource* upstream;
+    std::size_t allocations = 0;
+
+   private:
+    auto do_allocate(std::size_t bytes, std::size_t alignment)
+        -> void* override
+    {
+        ++allocations;
+        return upstream->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment)
+        override
+    {
+        upstream->deallocate(p, bytes, alignment);
+    }
+
+    auto do_is_equal(std::pmr::memory_resource const& other) const noexcept
+        -> bool override
+    {
+        return this == &other;
+    }
+};
+
+/// Event parsed back from write_chrome_trace output.
+struct Trace_event {
+    std::string name;
+    char phase;
+    std::uint64_t value;
+
+    friend auto operator==(Trace_event const&, Trace_event const&)
+        -> bool = default;
+};
+
+/// Return the events \p recorder writes as a Chrome trace, one per line.
+auto trace_events(maze::Trace_recorder const& recorder)
+    -> std::vector<Trace_event>
+{
+    auto os = std::ostringstream{};
+    recorder.write_chrome_trace(os);
+    auto is     = std::istringstream{os.str()};
+    auto result = std::vector<Trace_event>{};
+    for (auto line = std::string{}; std::getline(is, line);) {
+        constexpr auto prefix = std::string_view{"{\"name\":\""};
+        if (!line.starts_with(prefix))
+            continue;
+        auto const name_end = line.find('"', prefix.size());
+        auto const phase    = line.find("\"ph\":\"") + 6;
+        auto event = Trace_event{
+            line.substr(prefix.size(), name_end - prefix.size()), line[phase],
+            0};
+        auto const value = line.find("\"value\":");
+        if (value != std::string::npos)
+            event.value = std::stoull(line.substr(value + 8));
+        result.push_back(event);
+    }
+    return result;
+}
+
+/// Return true if every 'E' event in \p events closes the innermost open
+/// 'B' event of the same name, and none are left open.
+auto balanced(std::vector<Trace_event> const& events) -> bool
+{
+    auto open = std::vector<std::string>{};
+    for (auto const& e : events) {
+        if (e.phase == 'B') {
+            open.push_back(e.name);
+        }
+        else if (e.phase == 'E') {
+            if (open.empty() || open.back() != e.name)
+                return false;
+            open.pop_back();
+        }
+    }
+    return open.empty();
+}
+
+/// Overwrite the bytes of \p path at \p offset with those of \p value.
+template <typename T>
+void patch_file(std::filesystem::path const& path,
+                std::streamoff offset,
+                T value)
+{
+    auto file = std::fstream{path, std::ios::binary | std::ios::in |
+                                       std::ios::out};
+    file.seekp(offset);
+    file.write(reinterpret_cast<char const*>(&value), sizeof(value));
+}
+
+/// Run the Stepper \p make(maze) returns in slices, replaying every Step
+/// onto a second Maze.
+template <typename Make>
+void check_stepper(Make make, std::string_view what)
+{
+    using Maze    = maze::Maze<41, 21>;
+    auto m        = Maze{maze::Cell::Wall};
+    auto replayed = Maze{maze::Cell::Wall};
+    auto stepper  = make(m);
+    auto steps    = std::size_t{0};
+    auto const replay = [&](maze::Step const& step) {
+        ++steps;
+        for (auto y = step.top_left.y; y <= step.bottom_right.y; ++y) {
+            for (auto x = step.top_left.x; x <= step.bottom_right.x; ++x)
+                replayed.set({x, y}, step.cell);
+        }
+    };
+
+    auto const name = std::string{what};
+    check(!maze::run_steps(stepper, 3, replay) && !stepper.done() &&
+              steps == 3,
+          name + " stops after the steps asked for");
+    maze::run_for(stepper, std::chrono::microseconds{50}, replay);
+    check(maze::run_steps(stepper, std::numeric_limits<std::size_t>::max(),
+                          replay) &&
+              stepper.done() && !stepper.step().has_value(),
+          name + " runs to done()");
+    check(static_cast<bool>(maze::verify_perfect(m)),
+          name + " makes a perfect maze");
+    check(replayed == m, name + " Steps replay the maze");
+
+    auto again   = Maze{maze::Cell::Wall};
+    auto resumed = make(again);
+    auto source  = std::stop_source{};
+    source.request_stop();
+    check(!maze::run_until_done(resumed, source.get_token()),
+          name + " stops on a requested stop");
+    check(maze::run_until_done(resumed, {}) && again == m,
+          name + " resumes to the same maze");
+}
+
+void test_steppers()
+{
+    check_stepper([](auto& m) {
+        return maze::Recursive_backtracking_stepper{m, std::mt19937{1}};
+    }, "Recursive_backtracking_stepper");
+    check_stepper([](auto& m) {
+        return maze::Kruskal_stepper{m, std::mt19937{1}};
+    }, "Kruskal_stepper");
+    check_stepper([](auto& m) {
+        return maze::Prims_stepper{m, std::mt19937{1}};
+    }, "Prims_stepper");
+    check_stepper([](auto& m) {
+        return maze::Aldous_broder_stepper{m, std::mt19937{1}};
+    }, "Aldous_broder_stepper");
+    check_stepper([](auto& m) {
+        return maze::Recursive_division_stepper{m, std::mt19937{1}};
+    }, "Recursive_division_stepper");
+}
+
+/// Fill \p m with random Cells from \p gen.
+template <typename Maze>
+void randomize(Maze& m, std::mt19937_64& gen)
+{
+    for (maze::Distance y = 0; y < Maze::height; ++y) {
+        for (maze::Distance x = 0; x < Maze::width; ++x)
+            m.set({x, y}, (gen() & 1) ? maze::Cell::Passage : maze::Cell::Wall);
+    }
+}
+
+/// Compare the bulk edits of a Maze of \p Layout against set() per Cell.
+template <typename Layout>
+void test_bulk_edits(std::string_view layout)
+{
+    // Rows of 200 cells straddle Words, starting part way into one.
+    using Maze = maze::Maze<200, 9, Layout>;
+    auto gen   = std::mt19937_64{8};
+    auto bulk  = std::make_unique<Maze>(maze::Cell::Wall);
+    randomize(*bulk, gen);
+    auto cells = std::make_unique<Maze>(*bulk);
+    auto const name = std::string{layout};
+
+    // Single cells, Word edges and spans across one or more Word boundaries.
+    constexpr auto spans = std::array<std::pair<int, int>, 10>{{
+        {0, 0}, {0, 63}, {63, 64}, {64, 127}, {127, 128},
+        {60, 130}, {1, 198}, {0, 199}, {199, 199}, {5, 69}}};
+    auto row_y = maze::Distance{0};
+    for (auto const& [first, last] : spans) {
+        for (auto const c : {maze::Cell::Passage, maze::Cell::Wall}) {
+            bulk->fill_row_range(row_y, static_cast<maze::Distance>(first),
+                                 static_cast<maze::Distance>(last), c);
+            for (auto x = first; x <= last; ++x)
+                cells->set({static_cast<maze::Distance>(x), row_y}, c);
+            check(*bulk == *cells, name + " fill_row_range");
+        }
+        row_y = static_cast<maze::Distance>((row_y + 1) % Maze::height);
+    }
+
+    for (auto const& [first, last] : spans) {
+        auto const top_left     = maze::Point{
+            static_cast<maze::Distance>(first), 2};
+        auto const bottom_right = maze::Point{
+            static_cast<maze::Distance>(last), 6};
+        bulk->fill_rect(top_left, bottom_right, maze::Cell::Passage);
+        for (auto y = 2; y <= 6; ++y) {
+            for (auto x = first; x <= last; ++x) {
+                cells->set({static_cast<maze::Distance>(x),
+                            static_cast<maze::Distance>(y)},
+                           maze::Cell::Passage);
+            }
+        }
+        check(*bulk == *cells, name + " fill_rect");
+    }
+
+    // From a Row_major Maze and from one of the same Layout, to offsets on
+    // and off Word edges.
+    auto row_major = maze::Maze<150, 7>{maze::Cell::Wall};
+    randomize(row_major, gen);
+    auto same = maze::Maze<150, 7, Layout>{maze::Cell::Wall};
+    randomize(same, gen);
+    constexpr auto copies = std::array<std::array<int, 5>, 5>{{
+        // first x, last x, first y, to x, to y
+        {0, 149, 0, 0, 0},
+        {3, 70, 1, 64, 2},
+        {64, 127, 0, 1, 4},
+        {10, 10, 6, 199, 8},
+        {63, 140, 2, 100, 3}}};
+    auto const copy_both = [&](auto const& source, auto const& copy) {
+        auto const [first, last, top, to_x, to_y] = copy;
+        auto const rows = std::min(3, 7 - top);
+        bulk->copy_region(
+            source,
+            {static_cast<maze::Distance>(first),
+             static_cast<maze::Distance>(top)},
+            {static_cast<maze::Distance>(last),
+             static_cast<maze::Distance>(top + rows - 1)},
+            {static_cast<maze::Distance>(to_x),
+             static_cast<maze::Distance>(std::min(to_y, 9 - rows))});
+        for (auto r = 0; r < rows; ++r) {
+            for (auto x = first; x <= last; ++x) {
+                cells->set({static_cast<maze::Distance>(to_x + x - first),
+                            static_cast<maze::Distance>(
+                                std::min(to_y, 9 - rows) + r)},
+                           source.get({static_cast<maze::Distance>(x),
+                                       static_cast<maze::Distance>(top + r)}));
+            }
+        }
+    };
+    for (auto const& copy : copies) {
+        copy_both(row_major, copy);
+        check(*bulk == *cells, name + " copy_region from Row_major");
+        copy_both(same, copy);
+        check(*bulk == *cells, name + " copy_region from its own Layout");
+    }
+
+    // Bits past the width must be ignored.
+    auto row = std::array<maze::Word, 4>{};
+    for (auto y = maze::Distance{0}; y < Maze::height; ++y) {
+        for (auto& word : row)
+            word = gen();
+        bulk->write_row(y, row);
+        for (maze::Distance x = 0; x < Maze::width; ++x) {
+            cells->set({x, y}, maze::detail::test_bit(std::span{row}, x)
+                                   ? maze::Cell::Passage
+                                   : maze::Cell::Wall);
+        }
+        check(*bulk == *cells, name + " write_row");
+    }
+
+    if constexpr (std::same_as<Layout, maze::Row_major>) {
+        for (auto y = maze::Distance{0}; y < Maze::height; ++y) {
+            auto const words = std::as_const(*bulk).row_words(y);
+            auto same_cells  = words.size() == 4 && (words[3] >> 8) == 0;
+            for (maze::Distance x = 0; x < Maze::width; ++x) {
+                same_cells = same_cells &&
+                             maze::detail::test_bit(words, x) ==
+                                 (bulk->get({x, y}) == maze::Cell::Passage);
+            }
+            check(same_cells, "row_words reads a row, zero padded");
+        }
+    }
+}
+
+void test_bit_ranges()
+{
+    auto words    = std::array<maze::Word, 3>{1, 2, 3};
+    auto const before = words;
+    maze::detail::assign_bits(words, 70, 70, true);
+    maze::detail::copy_bits(before, 5, words, 100, 0);
+    check(words == before, "empty bit ranges write nothing");
+    maze::detail::assign_bits(words, 64, 128, true);
+    check(words[0] == 1 && words[1] == ~maze::Word{0} && words[2] == 3,
+          "a Word aligned range writes that Word only");
+}
+
+template <maze::Distance Width, maze::Distance Height>
+void test_generators_perfect()
+{
+    auto workspace = maze::Verify_workspace{};
+    for (auto const id : generators) {
+        for (auto seed = std::uint64_t{0}; seed < 20; ++seed) {
+            auto const m = make_maze<Width, Height>(id, seed);
+            check(static_cast<bool>(maze::verify_perfect(m, workspace)),
+                  "generate_into makes a perfect maze");
+        }
+    }
+}
+
+/// Hunt-and-Kill on a tall, narrow maze, where rescanning the untouched rows
+/// above a low random start would dominate.
+void test_hunt_and_kill_scan()
+{
+    using Maze     = maze::Maze<63, 16001>;
+    using Grid     = maze::detail::Room_grid<63, 16001>;
+    auto m         = std::make_unique<Maze>(maze::Cell::Wall);
+    auto workspace = maze::Hunt_and_kill_workspace{};
+    for (auto seed = std::uint64_t{0}; seed < 4; ++seed) {
+        auto recorder = maze::Trace_recorder{};
+        auto gen      = std::mt19937_64{seed};
+        maze::generate_hunt_and_kill_into(*m, workspace, gen,
+                                          recorder.observer());
+        check(static_cast<bool>(maze::verify_perfect(*m)),
+              "generate_hunt_and_kill_into makes a perfect tall maze");
+        // A few Words per hunt, where rescanning from the top took hundreds
+        // of passes over the mask.
+        check(recorder.value(maze::Counter::Words_scanned) <=
+                  8 * Grid::word_count,
+              "hunts scan the room mask a bounded number of times");
+    }
+}
+
+/// Fraction of the maze's room to room passages that run East-West.
+template <maze::Distance Width, maze::Distance Height>
+auto horizontal_share(maze::Maze<Width, Height> const& m) -> double
+{
+    auto across = 0;
+    auto down   = 0;
+    for (auto y = 0; y < Height; y += 2) {
+        for (auto x = 0; x < Width; x += 2) {
+            auto const at = [&](int px, int py) {
+                return m.get({static_cast<maze::Distance>(px),
+                              static_cast<maze::Distance>(py)}) ==
+                       maze::Cell::Passage;
+            };
+            across += x + 1 < Width && at(x + 1, y) ? 1 : 0;
+            down += y + 1 < Height && at(x, y + 1) ? 1 : 0;
+        }
+    }
+    return static_cast<double>(across) / (across + down);
+}
+
+void test_biased()
+{
+    using Maze = maze::Maze<61, 61>;
+    auto const horizontal = maze::Direction_bias{maze::horizontal_bias(8)};
+    // A region weighted far below the rest still has to be reached.
+    auto const lopsided = maze::Direction_bias{
+        {maze::horizontal_bias(1), maze::horizontal_bias(1e-12)},
+        [](maze::Point p) { return std::size_t{p.x < 30 ? 0U : 1U}; }};
+    auto workspace = maze::Biased_workspace{};
+    auto verify    = maze::Verify_workspace{};
+    auto gen       = std::mt19937_64{3};
+    auto m         = std::make_unique<Maze>(maze::Cell::Wall);
+    for (auto const* bias : {&horizontal, &lopsided}) {
+        for (auto i = 0; i < 10; ++i) {
+            maze::generate_biased_prims_into(*m, *bias, workspace, gen);
+            check(static_cast<bool>(maze::verify_perfect(*m, verify)),
+                  "biased Prim's makes a perfect maze");
+            if (bias == &horizontal) {
+                check(horizontal_share(*m) > 0.6,
+                      "biased Prim's favours East-West passages");
+            }
+            maze::generate_biased_kruskal_into(*m, *bias, workspace, gen);
+            check(static_cast<bool>(maze::verify_perfect(*m, verify)),
+                  "biased Kruskal makes a perfect maze");
+            if (bias == &horizontal) {
+                check(horizontal_share(*m) > 0.6,
+                      "biased Kruskal favours East-West passages");
+            }
+        }
+    }
+}
+
+/// Return true if the rooms of \p m and the walls opened between them form a
+/// spanning tree.
+template <maze::Distance Width, maze::Distance Height, maze::Distance Depth>
+auto is_perfect(maze::Maze_3d<Width, Height, Depth> const& m) -> bool
+{
+    using Lattice = maze::Lattice_3d<Width, Height, Depth>;
+    auto seen     = std::vector<bool>(Lattice::room_count);
+    auto queue    = std::vector<maze::Point_3d>{{0, 0, 0}};
+    auto opened   = std::size_t{0};
+    seen[0]       = true;
+    for (auto i = std::size_t{0}; i < queue.size(); ++i) {
+        for (auto const d : Lattice::forward_directions) {
+            auto const next =
+                maze::detail::room_neighbor<Lattice>(queue[i], d);
+            if (next.has_value() &&
+                m.get(Lattice::between(queue[i], *next)) ==
+                    maze::Cell::Passage)
+                ++opened;
+        }
+        for (auto const d : Lattice::directions) {
+            auto const next =
+                maze::detail::room_neighbor<Lattice>(queue[i], d);
+            if (!next.has_value() ||
+                m.get(Lattice::between(queue[i], *next)) == maze::Cell::Wall)
+                continue;
+            auto const k = Lattice::room_index(*next);
+            if (!seen[k]) {
+                seen[k] = true;
+                queue.push_back(*next);
+            }
+        }
+    }
+    return queue.size() == Lattice::room_count &&
+           opened == Lattice::room_count - 1;
+}
+
+void test_baked()
+{
+    auto gen = maze::Splitmix64{7};
+    check(maze::baked_kruskal<41, 21, 7> ==
+              maze::generate_kruskal<41, 21>(gen),
+          "baked_kruskal matches its run time maze");
+    gen = maze::Splitmix64{7};
+    check(maze::baked_recursive_backtracking<41, 21, 7> ==
+              maze::generate_recursive_backtracking<41, 21>(gen),
+          "baked_recursive_backtracking matches its run time maze");
+    gen = maze::Splitmix64{7};
+    check(maze::baked_recursive_division<41, 21, 7> ==
+              maze::generate_recursive_division<41, 21>(gen),
+          "baked_recursive_division matches its run time maze");
+}
+
+void test_generators_3d()
+{
+    using Maze     = maze::Maze_3d<11, 9, 7>;
+    auto m         = std::make_unique<Maze>(maze::Cell::Wall);
+    auto workspace = maze::Generator_3d_workspace{};
+    auto gen       = std::mt19937_64{5};
+    for (auto i = 0; i < 10; ++i) {
+        maze::generate_recursive_backtracking_into(*m, workspace, gen);
+        check(is_perfect(*m), "3D backtracking makes a perfect maze");
+        maze::generate_prims_into(*m, workspace, gen);
+        check(is_perfect(*m), "3D Prim's makes a perfect maze");
+        maze::generate_kruskal_into(*m, workspace, gen);
+        check(is_perfect(*m), "3D Kruskal makes a perfect maze");
+    }
+}
+
+/// Check that \p grid reads and solves like the Maze \p m.
+template <maze::Cell_grid G, typename Maze>
+void check_same_as_maze(G const& grid, Maze const& m, std::string_view what)
+{
+    auto printed = std::ostringstream{};
+    auto copy    = std::ostringstream{};
+    printed << grid;
+    copy << m;
+    check(printed.str() == copy.str(), what);
+    check(maze::maze_hash(grid) == maze::maze_hash(m), what);
+    check(maze::canonical_hash(grid) == maze::canonical_hash(m), what);
+    check(maze::find_all_leaves(grid) == maze::find_all_leaves(m), what);
+    check(maze::longest_path(grid) == maze::longest_path(m), what);
+    check(maze::analyze(grid) == maze::analyze(m), what);
+    check(maze::verify_perfect(grid) == maze::verify_perfect(m), what);
+}
+
+void test_cell_grids()
+{
+    auto gen       = std::mt19937_64{9};
+    auto workspace = maze::Kruskal_workspace{};
+    auto walls     = maze::Wall_maze<131, 41>{};
+    maze::generate_kruskal_into(walls, workspace, gen);
+    auto const m = walls.to_maze();
+    check(static_cast<bool>(maze::verify_perfect(walls)),
+          "verify_perfect reads a Wall_maze");
+    check_same_as_maze(walls, m, "a Wall_maze solves like its Maze");
+    check_same_as_maze(maze::Maze_view{m}, m,
+                       "a Maze_view solves like its Maze");
+
+    auto cache       = maze::Solution_cache{4};
+    auto const first = cache.solve(walls);
+    check(cache.solve(m) == first && cache.hits() == 1,
+          "a Wall_maze shares its Solution_cache entry with its Maze");
+}
+
+void test_origin_shift()
+{
+    using Maze = maze::Maze<41, 21>;
+    auto m     = make_maze<41, 21>(maze::Generator_id::Kruskal, 4);
+    auto live  = maze::Origin_shift_maze{m, std::mt19937{3}};
+    auto moved = 0;
+    for (auto i = 0; i < 2000; ++i) {
+        auto const before = m;
+        auto const change = live.shift();
+        check(change.root == live.root() && !live.parent(live.root()),
+              "shift moves the root");
+        auto changed = std::vector<maze::Point>{};
+        for (maze::Distance y = 0; y < Maze::height; ++y) {
+            for (maze::Distance x = 0; x < Maze::width; ++x) {
+                if (m.get({x, y}) != before.get({x, y}))
+                    changed.push_back({x, y});
+            }
+        }
+        auto expected = std::vector<maze::Point>{};
+        if (change.opened) {
+            check(m.get(*change.opened) == maze::Cell::Passage,
+                  "shift opens a wall");
+            expected.push_back(*change.opened);
+        }
+        if (change.closed) {
+            check(m.get(*change.closed) == maze::Cell::Wall,
+                  "shift closes a wall");
+            expected.push_back(*change.closed);
+        }
+        std::ranges::sort(changed);
+        std::ranges::sort(expected);
+        check(changed == expected, "Origin_shift_change lists every change");
+        check(maze::is_perfect(m), "shift keeps the maze perfect");
+        moved += change.opened.has_value();
+    }
+    check(moved > 0, "shifts change the maze");
+
+    auto replayed = m;
+    live.shift(500, [&](maze::Step const& step) {
+        replayed.set(step.top_left, step.cell);
+    });
+    check(replayed == m, "shift Steps replay the changes");
+
+    auto walls = Maze{maze::Cell::Wall};
+    check_throws<std::invalid_argument>(
+        [&] { maze::Origin_shift_maze{walls}; },
+        "Origin_shift_maze rejects a maze of closed rooms");
+    auto cycle = make_maze<41, 21>(maze::Generator_id::Kruskal, 4);
+    for (maze::Distance x = 1; x < Maze::width; x += 2) {
+        cycle.set({x, 0}, maze::Cell::Passage);
+        cycle.set({x, 2}, maze::Cell::Passage);
+    }
+    check_throws<std::invalid_argument>(
+        [&] { maze::Origin_shift_maze{cycle}; },
+        "Origin_shift_maze rejects a maze with a cycle");
+}
+
+void test_analyze_batch()
+{
+    using Maze = maze::Maze<41, 21>;
+    auto mazes = std::vector<Maze>{};
+    for (auto const id : generators) {
+        for (auto seed = std::uint64_t{0}; seed < 5; ++seed)
+            mazes.push_back(make_maze<41, 21>(id, seed));
+    }
+    auto expected = std::vector<maze::Maze_metrics>{};
+    for (auto const& m : mazes)
+        expected.push_back(maze::analyze(m));
+
+    auto const all = std::span<Maze const>{mazes};
+    for (auto const threads : {1, 3, 8}) {
+        check(maze::analyze_batch(all, threads) == expected,
+              "analyze_batch matches analyze");
+    }
+    check(maze::analyze_batch(all.first(0), 4).empty(),
+          "analyze_batch of no mazes is empty");
+    check_throws<std::invalid_argument>(
+        [&] { (void)maze::analyze_batch(all, 0); },
+        "analyze_batch rejects zero threads");
+}
+
+void test_verify_defects()
+{
+    auto m = make_maze<21, 11>(maze::Generator_id::Kruskal, 1);
+    m.set({4, 4}, maze::Cell::Wall);
+    check(maze::verify_perfect(m).defect == maze::Maze_defect::Closed_room,
+          "verify_perfect finds a closed room");
+
+    m = make_maze<21, 11>(maze::Generator_id::Kruskal, 1);
+    m.set({3, 3}, maze::Cell::Passage);
+    check(maze::verify_perfect(m).defect == maze::Maze_defect::Open_corner,
+          "verify_perfect finds an open corner");
+
+    m = make_maze<21, 11>(maze::Generator_id::Kruskal, 1);
+    auto closed = maze::Point{0, 0};
+    for (maze::Distance y = 0; y < 11; y += 2) {
+        for (maze::Distance x = 1; x < 21; x += 2) {
+            if (m.get({x, y}) == maze::Cell::Wall)
+                closed = {x, y};
+        }
+    }
+    m.set(closed, maze::Cell::Passage);
+    check(maze::verify_perfect(m).defect == maze::Maze_defect::Cycle,
+          "verify_perfect finds a cycle");
+}
+
+void test_binary_round_trip()
+{
+    auto const m        = make_maze<67, 21>(maze::Generator_id::Prims, 7);
+    auto const metadata = maze::Maze_metadata{7, maze::Generator_id::Prims};
+
+    auto stream = std::stringstream{};
+    maze::write_binary(stream, m, metadata);
+    auto const [read, read_metadata] = maze::read_binary<67, 21>(stream);
+    check(read == m, "read_binary returns the Maze written");
+    check(read_metadata == metadata, "read_binary returns the metadata");
+
+    auto const bytes = stream.str();
+    auto aligned     = std::vector<maze::Word>(
+        (bytes.size() + sizeof(maze::Word) - 1) / sizeof(maze::Word));
+    std::memcpy(aligned.data(), bytes.data(), bytes.size());
+    auto const [view, view_metadata] = maze::view_binary<67, 21>(
+        std::as_bytes(std::span{aligned}).first(bytes.size()));
+    check(view.to_maze() == m, "view_binary views the Maze written");
+    check(view_metadata == metadata, "view_binary returns the metadata");
+
+    check_throws<std::runtime_error>(
+        [&] { (void)maze::view_binary<65, 21>(std::as_bytes(
+                  std::span{aligned})); },
+        "view_binary rejects a dimension mismatch");
+    check_throws<std::runtime_error>(
+        [&] { (void)maze::view_binary<67, 21>(std::as_bytes(
+                  std::span{aligned}).first(bytes.size() - 1)); },
+        "view_binary rejects a truncated file");
+
+    // Bit 3 of the second Word of row 0 would be Cell 67, padding.
+    auto padded = bytes;
+    padded[sizeof(maze::Binary_header) + sizeof(maze::Word)] |= char{8};
+    auto padded_stream = std::stringstream{padded};
+    check_throws<std::runtime_error>(
+        [&] { (void)maze::read_binary<67, 21>(padded_stream); },
+        "read_binary rejects a padding bit");
+    std::memcpy(aligned.data(), padded.data(), padded.size());
+    check_throws<std::runtime_error>(
+        [&] { (void)maze::view_binary<67, 21>(std::as_bytes(
+                  std::span{aligned}).first(bytes.size())); },
+        "view_binary rejects a padding bit");
+
+    auto const path = scratch_file("maze-test.bin");
+    {
+        auto file = std::ofstream{path, std::ios::binary};
+        maze::write_binary(file, m, metadata);
+    }
+    {
+        auto const mapped = maze::Mapped_maze<67, 21>{path};
+        check(mapped.view().to_maze() == m, "Mapped_maze maps the Maze");
+        check(mapped.metadata() == metadata, "Mapped_maze reads metadata");
+    }
+    std::filesystem::remove(path);
+}
+
+void test_mapped_scratch()
+{
+    using Mapped = maze::Maze<201, 101, maze::Row_major, maze::Mapped_storage>;
+    auto const directory = scratch_file("maze-test-scratch");
+    std::filesystem::create_directory(directory);
+    {
+        auto m = Mapped{maze::Mapped_array<maze::Word>::create(
+                            directory / "maze.bin", Mapped::word_count),
+                        maze::Cell::Wall};
+        auto workspace = maze::Generator_workspace{m};
+        auto gen       = std::mt19937_64{5};
+        maze::generate_into(maze::Generator_id::Kruskal, m, workspace, gen);
+
+        auto const copy = make_maze<201, 101>(maze::Generator_id::Kruskal, 5);
+        auto same       = true;
+        for (auto y = 0; y < 101; ++y) {
+            for (auto x = 0; x < 201; ++x) {
+                auto const p = maze::Point{static_cast<maze::Distance>(x),
+                                           static_cast<maze::Distance>(y)};
+                same = same && copy.get(p) == m.get(p);
+            }
+        }
+        check(same, "Generator_workspace{maze} fills a Mapped_storage Maze");
+        check(static_cast<bool>(maze::verify_perfect(m)),
+              "verify_perfect checks a Mapped_storage Maze");
+        check(maze::analyze(m) == maze::analyze(copy),
+              "analyze reads a Mapped_storage Maze");
+        check(maze::longest_path(m) == maze::longest_path(copy),
+              "longest_path reads a Mapped_storage Maze");
+
+        // Every scratch array over 64 bytes gets its own unlinked mapping.
+        auto resource  = maze::Mapped_resource{directory, 64};
+        auto analytics = maze::Analytics_workspace{&resource};
+        check(maze::analyze(m, analytics) == maze::analyze(copy),
+              "analyze runs on mapped scratch");
+        auto verify = maze::Verify_workspace{&resource};
+        check(static_cast<bool>(maze::verify_perfect(m, verify)),
+              "verify_perfect runs on mapped scratch");
+        auto solver = maze::Longest_path_workspace{&resource};
+        check(maze::longest_path(m, solver, {}) == maze::longest_path(copy),
+              "longest_path runs on mapped scratch");
+        check(std::distance(std::filesystem::directory_iterator{directory},
+                            std::filesystem::directory_iterator{}) == 1,
+              "Mapped_resource leaves no files behind");
+    }
+    std::filesystem::remove_all(directory);
+}
+
+void test_longest_path_deep()
+{
+    // Recursive backtracking paths run for hundreds of thousands of cells,
+    // far deeper than a recursive search could go on the call stack.
+    using Maze     = maze::Maze<1001, 1001>;
+    auto m         = std::make_unique<Maze>(maze::Cell::Wall);
+    auto workspace = maze::Generator_workspace{};
+    auto gen       = std::mt19937_64{2};
+    maze::generate_into(maze::Generator_id::Recursive_backtracking, *m,
+                        workspace, gen);
+
+    auto const path = maze::longest_path(*m);
+    check(path.size() == maze::analyze(*m).diameter,
+          "longest_path of a deep maze matches analyze");
+    check(path.size() > 100'000, "longest_path follows a deep branch");
+    auto const from = maze::longest_path_from(*m, path.front());
+    check(from.size() == path.size(),
+          "longest_path_from an end of the longest path finds it again");
+}
+
+void test_archive_round_trip()
+{
+    using Maze_type = maze::Maze<41, 21>;
+    auto const path = scratch_file("maze-test.mzar");
+    for (auto const compression :
+         {maze::Compression::None, maze::Compression::Row_rle}) {
+        auto mazes = std::vector<Maze_type>{};
+        {
+            auto writer = maze::Archive_writer<41, 21>{path, compression};
+            for (auto const id : generators) {
+                mazes.push_back(make_maze<41, 21>(id, 3));
+                auto const entry = writer.append(mazes.back(), {3, id});
+                check(entry + 1 == mazes.size(), "append returns the id");
+            }
+            writer.finish();
+        }
+
+        auto const reader = maze::Archive_reader<41, 21>{path};
+        check(reader.size() == mazes.size(), "archive holds every Maze");
+        for (auto i = std::size_t{0}; i < mazes.size(); ++i) {
+            check(reader.load(i) == mazes[i], "archive loads the Maze");
+            check(reader.metadata(i) ==
+                      maze::Maze_metadata{3, generators[i]},
+                  "archive returns the metadata");
+            if (reader.is_viewable(i))
+                check(reader.view(i).to_maze() == mazes[i],
+                      "archive views the Maze");
+        }
+        check_throws<std::out_of_range>(
+            [&] { (void)reader.load(mazes.size()); },
+            "archive rejects an invalid id");
+    }
+    check_throws<std::runtime_error>(
+        [&] { maze::Archive_reader<41, 23>{path}; },
+        "archive rejects a dimension mismatch");
+    std::filesystem::remove(path);
+}
+
+void test_archive_corrupt()
+{
+    auto const path  = scratch_file("maze-test-corrupt.mzar");
+    auto const write = [&](maze::Compression compression) {
+        // A blank Maze first, small enough to be stored run-length encoded.
+        auto writer = maze::Archive_writer<41, 21>{path, compression};
+        writer.append(maze::Maze<41, 21>{maze::Cell::Wall});
+        for (auto const id : generators)
+            writer.append(make_maze<41, 21>(id, 4), {4, id});
+    };
+    auto const index_at = [&](std::size_t field) {
+        auto const index_size =
+            (generators.size() + 1) * sizeof(maze::Archive_entry);
+        return static_cast<std::streamoff>(
+            std::filesystem::file_size(path) - index_size + field);
+    };
+
+    // count * sizeof(Archive_entry) wraps around to a single entry.
+    write(maze::Compression::None);
+    patch_file(path, offsetof(maze::Archive_header, count),
+               (std::uint64_t{1} << 59) + 1);
+    check_throws<std::runtime_error>(
+        [&] { maze::Archive_reader<41, 21>{path}; },
+        "archive rejects a count past the end of the file");
+
+    write(maze::Compression::Row_rle);
+    patch_file(path, index_at(offsetof(maze::Archive_entry, encoding)),
+               std::uint32_t{7});
+    check_throws<std::runtime_error>(
+        [&] { (void)maze::Archive_reader<41, 21>{path}.load(0); },
+        "archive rejects an unknown encoding");
+
+    write(maze::Compression::None);
+    patch_file(path, index_at(offsetof(maze::Archive_entry, offset)),
+               std::uint64_t{sizeof(maze::Archive_header) + 4});
+    check_throws<std::runtime_error>(
+        [&] { (void)maze::Archive_reader<41, 21>{path}.view(0); },
+        "archive rejects a misaligned block");
+    std::filesystem::remove(path);
+}
+
+void test_hash()
+{
+    auto const m = make_maze<41, 21>(maze::Generator_id::Kruskal, 5);
+    auto tiled   = maze::Maze<41, 21, maze::Tiled_8x8>{maze::Cell::Wall};
+    auto mirror  = maze::Maze<21, 41>{maze::Cell::Wall};
+    for (maze::Distance y = 0; y < 21; ++y) {
+        for (maze::Distance x = 0; x < 41; ++x) {
+            tiled.set({x, y}, m.get({x, y}));
+            auto const to =
+                maze::apply({true, true, false}, {x, y}, 41, 21);
+            mirror.set(to, m.get({x, y}));
+            check(maze::unapply({true, true, false}, to, 41, 21) ==
+                      maze::Point{x, y},
+                  "unapply inverts apply");
+        }
+    }
+    check(maze::maze_hash(m) == maze::maze_hash(tiled),
+          "maze_hash ignores the Layout");
+    check(maze::canonical_hash(m).hash == maze::canonical_hash(mirror).hash,
+          "canonical_hash is the same for a rotation");
+
+    auto other = m;
+    other.set({1, 0}, m.get({1, 0}) == maze::Cell::Wall ? maze::Cell::Passage
+                                                        : maze::Cell::Wall);
+    check(maze::maze_hash(m) != maze::maze_hash(other),
+          "maze_hash tells Mazes apart");
+}
+
+void test_path_round_trip()
+{
+    auto const m    = make_maze<101, 101>(
+        maze::Generator_id::Recursive_backtracking, 9);
+    auto const path = maze::longest_path(m);
+    check(path.size() > 512, "longest_path spans several checkpoints");
+
+    auto const points = path.to_points();
+    check(maze::Path{points} == path, "Path round trips through Points");
+    auto const mask = path.to_mask<101, 101>();
+    for (auto i = std::size_t{0}; i < points.size(); ++i) {
+        check(path[i] == points[i], "operator[] matches iteration");
+        check(m.get(points[i]) == maze::Cell::Passage,
+              "longest_path follows Passages");
+        check(maze::detail::test_bit(
+                  mask, (std::size_t{points[i].y} * 101) + points[i].x),
+              "to_mask marks the Path");
+    }
+
+    auto copy = path;
+    for (auto i = std::size_t{0}; i < 300; ++i)
+        copy.pop_back();
+    for (auto i = points.size() - 300; i < points.size(); ++i)
+        copy.push_back(points[i]);
+    check(copy == path, "push_back undoes pop_back");
+    check_throws<std::invalid_argument>(
+        [&] { copy.push_back(copy.back()); },
+        "push_back rejects a Point that isn't adjacent");
+}
+
+void test_generate_matching()
+{
+    auto const long_path = [](maze::Maze_metrics const& m) {
+        return m.diameter >= 160;
+    };
+    auto options = maze::Matching_options{.seed = 11, .max_attempts = 2000};
+    auto first   = std::optional<maze::Matching_maze<41, 21>>{};
+    for (auto const threads : {1, 2, 8}) {
+        options.thread_count = threads;
+        auto found           = maze::generate_matching<41, 21>(
+            maze::Generator_id::Kruskal, long_path, options);
+        check(found.has_value() && found->metrics.diameter >= 160,
+              "generate_matching finds a match");
+        if (!found.has_value())
+            return;
+        check(found->generated > found->attempt,
+              "generate_matching generates every attempt up to the match");
+        check(found->metadata.seed ==
+                  maze::detail::mix_seed(options.seed, found->attempt),
+              "generate_matching reports the seed of the attempt");
+        check(*found->maze == make_maze<41, 21>(maze::Generator_id::Kruskal,
+                                                found->metadata.seed),
+              "the metadata of a match regenerates it");
+        if (!first.has_value())
+            first = std::move(found);
+        else
+            check(found->attempt == first->attempt,
+                  "the same attempt wins at any thread count");
+    }
+
+    options.thread_count = 4;
+    options.max_attempts = 20;
+    check(!maze::generate_matching<41, 21>(
+               maze::Generator_id::Kruskal,
+               [](maze::Maze_metrics const&) { return false; }, options),
+          "generate_matching gives up after max_attempts");
+
+    auto source = std::stop_source{};
+    options.max_attempts = 2000;
+    check(!maze::generate_matching<41, 21>(
+               maze::Generator_id::Kruskal,
+               [&](maze::Maze_metrics const&) {
+                   source.request_stop();
+                   return false;
+               },
+               options, source.get_token()),
+          "generate_matching stops part way through a search");
+
+    options.thread_count = 0;
+    check_throws<std::invalid_argument>(
+        [&] { (void)maze::generate_matching<41, 21>(
+                  maze::Generator_id::Kruskal, long_path, options); },
+        "generate_matching rejects zero threads");
+
+    auto m         = maze::Maze<41, 21>{maze::Cell::Wall};
+    auto workspace = maze::Generator_workspace{};
+    for (auto const id : generators) {
+        check(!maze::detail::generate_stoppable(id, m, workspace,
+                                                std::mt19937_64{1},
+                                                source.get_token()),
+              "generate_stoppable stops on a requested stop");
+        check(maze::detail::generate_stoppable(id, m, workspace,
+                                               std::mt19937_64{1}, {}) &&
+                  m == make_maze<41, 21>(id, 1),
+              "generate_stoppable makes the Maze of generate_into");
+    }
+}
+
+void test_workspace_resource()
+{
+    auto buffer    = std::vector<std::byte>(1 << 20);
+    auto monotonic = std::pmr::monotonic_buffer_resource{
+        buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+    auto counting  = Counting_resource{&monotonic};
+    auto workspace = maze::Generator_workspace{&counting};
+    auto m         = maze::Maze<41, 21>{maze::Cell::Wall};
+    for (auto pass = 0; pass < 2; ++pass) {
+        if (pass == 1) {
+            check(counting.allocations > 0,
+                  "Generator_workspace allocates from its resource");
+            counting.allocations = 0;
+        }
+        for (auto const id : generators) {
+            for (auto seed = std::uint64_t{0}; seed < 5; ++seed) {
+                auto gen = std::mt19937_64{seed};
+                maze::generate_into(id, m, workspace, gen);
+                check(m == make_maze<41, 21>(id, seed),
+                      "a workspace on a monotonic buffer makes the same "
+                      "mazes");
+            }
+        }
+    }
+    check(counting.allocations == 0,
+          "a grown Generator_workspace allocates nothing");
+}
+
+void test_trace_recorder()
+{
+    using maze::Counter;
+    constexpr auto rooms = std::size_t{21 * 11};
+    constexpr auto edges = std::size_t{(20 * 11) + (21 * 10)};
+
+    auto recorder = maze::Trace_recorder{};
+    auto m        = maze::Maze<41, 21>{maze::Cell::Wall};
+    auto kruskal  = maze::Kruskal_workspace{};
+    auto gen      = std::mt19937_64{3};
+    maze::generate_kruskal_into(m, kruskal, gen, recorder.observer());
+    check(m == make_maze<41, 21>(maze::Generator_id::Kruskal, 3),
+          "an observer doesn't change the maze generated");
+    check(recorder.value(Counter::Merges) == rooms - 1,
+          "Kruskal's merges every room into one set");
+    check(recorder.value(Counter::Edges_checked) >= rooms - 1 &&
+              recorder.value(Counter::Edges_checked) <= edges,
+          "Kruskal's checks each Edge at most once");
+
+    auto prims = maze::Prims_workspace{};
+    gen        = std::mt19937_64{3};
+    maze::generate_prims_into(m, prims, gen, recorder.observer());
+    check(recorder.value(Counter::Frontier_size) > 0 &&
+              recorder.value(Counter::Frontier_size) <= edges,
+          "Prim's reports the peak of its frontier");
+
+    auto solver     = maze::Longest_path_workspace{};
+    auto const path = maze::longest_path(m, solver, {}, recorder.observer());
+    check(path.has_value() && *path == maze::longest_path(m),
+          "an observer doesn't change the longest path");
+    check(recorder.value(Counter::Leaves) == 2 &&
+              recorder.value(Counter::Path_depth) > 0,
+          "longest_path reports its leaves and search depth");
+    check(recorder.value(Counter::Merges) == rooms - 1,
+          "a count is the total over every phase");
+
+    auto const events = trace_events(recorder);
+    auto const phases = std::ranges::count(events, 'B', &Trace_event::phase);
+    check(phases == 3 && balanced(events),
+          "write_chrome_trace writes one balanced B/E pair per phase");
+    check(std::ranges::count(events, Trace_event{"merges", 'C', rooms - 1}) ==
+              1,
+          "write_chrome_trace writes a phase's counters at its end");
+
+    // Nested phases fold into the enclosing one: gauges by their peak,
+    // counts by their sum.
+    auto nested = maze::Trace_recorder{};
+    auto outer  = nested.observer();
+    outer.begin_phase("outer");
+    outer.gauge(Counter::Frontier_size, 5);
+    outer.begin_phase("inner");
+    outer.gauge(Counter::Frontier_size, 9);
+    outer.count(Counter::Merges, 3);
+    outer.end_phase();
+    outer.count(Counter::Merges, 2);
+    outer.gauge(Counter::Frontier_size, 4);
+    outer.end_phase();
+    outer.end_phase();
+    check(nested.value(Counter::Frontier_size) == 9 &&
+              nested.value(Counter::Merges) == 5,
+          "Trace_recorder keeps gauge peaks and count totals");
+    check(trace_events(nested) == std::vector<Trace_event>{
+                                      {"outer", 'B', 0},
+                                      {"inner", 'B', 0},
+                                      {"frontier_size", 'C', 9},
+                                      {"merges", 'C', 3},
+                                      {"inner", 'E', 0},
+                                      {"frontier_size", 'C', 9},
+                                      {"merges", 'C', 5},
+                                      {"outer", 'E', 0},
+                                  },
+          "nested phases fold into the enclosing phase");
+}
+
+void test_generator_pool()
+{
+    using Maze    = maze::Maze<41, 21>;
+    auto const id = maze::Generator_id::Kruskal;
+    auto pool     = maze::Generator_pool<41, 21>{4, 7};
+    auto out      = std::vector<Maze>(20, Maze{maze::Cell::Wall});
+    auto metadata = std::vector<maze::Maze_metadata>(out.size());
+    auto threaded = std::vector<Maze>{};
+    for (auto batch = std::size_t{0}; batch < 2; ++batch) {
+        pool.generate(id, out, metadata);
+        for (auto i = std::size_t{0}; i < out.size(); ++i) {
+            auto const seed =
+                maze::detail::mix_seed(7, (batch * out.size()) + i);
+            check(metadata[i] == maze::Maze_metadata{seed, id},
+                  "Generator_pool reports the seed of each maze");
+            check(out[i] == make_maze<41, 21>(id, metadata[i].seed),
+                  "the metadata of a pool maze regenerates it");
+        }
+        if (batch == 0)
+            threaded = out;
+    }
+
+    auto single = maze::Generator_pool<41, 21>{1, 7};
+    auto first  = std::vector<Maze>(out.size(), Maze{maze::Cell::Wall});
+    single.generate(id, first);
+    check(first == threaded,
+          "Generator_pool makes the same mazes on one thread");
+
+    auto matched = std::vector<int>(10, 0);
+    pool.generate(id, matched.size(),
+                  [&](std::size_t index,
+                      Maze const& m,
+                      maze::Maze_metadata meta) {
+                      matched[index] = m == make_maze<41, 21>(id, meta.seed);
+                  });
+    check(std::ranges::count(matched, 1) == 10,
+          "the callback gets every maze with its metadata");
+
+    check_throws<std::runtime_error>(
+        [&] {
+            pool.generate(id, 50, [](std::size_t index, Maze const&,
+                                     maze::Maze_metadata) {
+                if (index == 17)
+                    throw std::runtime_error{"callback failed"};
+            });
+        },
+        "Generator_pool rethrows an exception from a worker");
+    pool.generate(id, out);
+    check(static_cast<bool>(maze::verify_perfect(out.back())),
+          "Generator_pool runs batches after a worker failed");
+
+    check_throws<std::invalid_argument>(
+        [&] { pool.generate(id, out, std::span{metadata}.first(3)); },
+        "Generator_pool rejects metadata of the wrong size");
+    check_throws<std::invalid_argument>(
+        [&] { pool.generate(maze::Generator_id::Unknown, out); },
+        "Generator_pool rejects an Unknown generator");
+    check_throws<std::invalid_argument>(
+        [] { maze::Generator_pool<41, 21>{0}; },
+        "Generator_pool rejects zero threads");
+}
+
+void test_cancellation()
+{
+    using Maze_type = maze::Maze<201, 201>;
+    auto m          = std::make_unique<Maze_type>(maze::Cell::Wall);
+    for (auto const id :
+         {maze::Generator_id::Ellers, maze::Generator_id::Binary_tree,
+          maze::Generator_id::Sidewinder, maze::Generator_id::Hunt_and_kill}) {
+        auto source = std::stop_source{};
+        check_throws<maze::Operation_cancelled>(
+            [&] {
+                maze::detail::generate_stoppable(
+                    id, *m, Stopping_gen{&source, 20}, source.get_token());
+            },
+            "row based generators stop part way through");
+    }
+
+    auto source       = std::stop_source{};
+    auto gauges       = std::size_t{100};
+    auto const solved = make_maze<41, 21>(maze::Generator_id::Kruskal, 2);
+    auto const leaf   = maze::find_all_leaves(solved).front();
+    auto const path   = maze::longest_path_from(
+        solved, leaf, source.get_token(), Stopping_observer{&source, &gauges});
+    check(!path.has_value(),
+          "longest_path_from stops part way through a search");
+
+    auto finished = std::atomic<bool>{false};
+    {
+        auto executor = maze::Thread_executor{};
+        executor.execute([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds{20});
+            finished = true;
+        });
+    }
+    check(finished, "Thread_executor joins its tasks when destroyed");
+}
+
+void test_world_prefetch_failure()
+{
+    auto world   = maze::Maze_world<21, 21>{1, maze::Generator_id::Kruskal, 16};
+    auto failing = Failing_executor{};
+    check_throws<std::runtime_error>(
+        [&] { world.prefetch(failing, {0, 0}, 0); },
+        "prefetch passes on a failure to submit");
+
+    auto executor = maze::Inline_executor{};
+    world.prefetch(executor, {0, 0}, 1);
+    check(world.cached_count() == 9,
+          "prefetch retries a chunk whose task never ran");
+}
+
+}  // namespace
 
 int main()
 {
@@ -80,5 +1366,37 @@ int main()
     // std::cout << "is_connected({11, 22}, {2, 5}): " << std::boolalpha
     //           << same_component(connected, {11, 22}, {2, 5}) << '\n';
 
-    return 0;
+    test_generators_perfect<41, 21>();
+    test_generators_perfect<40, 20>();
+    test_bit_ranges();
+    test_bulk_edits<maze::Row_major>("Row_major");
+    test_bulk_edits<maze::Tiled_8x8>("Tiled_8x8");
+    test_bulk_edits<maze::Morton>("Morton");
+    test_bulk_edits<maze::Padded_row_major>("Padded_row_major");
+    test_steppers();
+    test_hunt_and_kill_scan();
+    test_biased();
+    test_baked();
+    test_generators_3d();
+    test_cell_grids();
+    test_origin_shift();
+    test_verify_defects();
+    test_analyze_batch();
+    test_binary_round_trip();
+    test_mapped_scratch();
+    test_longest_path_deep();
+    test_archive_round_trip();
+    test_archive_corrupt();
+    test_hash();
+    test_path_round_trip();
+    test_generate_matching();
+    test_trace_recorder();
+    test_generator_pool();
+    test_workspace_resource();
+    test_cancellation();
+    test_world_prefetch_failure();
+
+    std::cout << (failures == 0 ? "All checks passed." : "Checks failed.")
+              << '\n';
+    return failures == 0 ? 0 : 1;
 }